@@ -69,7 +69,13 @@ void registerAST(py::module_& m) {
         .def_property("queueTarget", &EvalContext::getQueueTarget, &EvalContext::setQueueTarget);
 
     py::class_<EvalContext::Frame>(evalCtx, "Frame")
-        .def_readonly("temporaries", &EvalContext::Frame::temporaries)
+        .def_property_readonly("temporaries",
+                               [](const EvalContext::Frame& self) {
+                                   std::map<const ValueSymbol*, ConstantValue> result;
+                                   for (auto slot : self.temporaries)
+                                       result.emplace(slot->symbol, slot->value);
+                                   return result;
+                               })
         .def_readonly("subroutine", &EvalContext::Frame::subroutine)
         .def_readonly("callLocation", &EvalContext::Frame::callLocation)
         .def_readonly("lookupLocation", &EvalContext::Frame::lookupLocation);
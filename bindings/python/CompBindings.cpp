@@ -86,10 +86,17 @@ void registerCompilation(py::module_& m) {
         .def_readwrite("lintMode", &CompilationOptions::lintMode)
         .def_readwrite("suppressUnused", &CompilationOptions::suppressUnused)
         .def_readwrite("ignoreUnknownModules", &CompilationOptions::ignoreUnknownModules)
+        .def_readwrite("buildReferenceIndex", &CompilationOptions::buildReferenceIndex)
         .def_readwrite("defaultTimeScale", &CompilationOptions::defaultTimeScale)
         .def_readwrite("topModules", &CompilationOptions::topModules)
         .def_readwrite("paramOverrides", &CompilationOptions::paramOverrides);
 
+    py::class_<SymbolReference>(m, "SymbolReference")
+        .def_property_readonly("expr", [](const SymbolReference& self) { return self.expr.get(); })
+        .def_property_readonly("scope",
+                               [](const SymbolReference& self) { return self.scope.get(); })
+        .def_readonly("isLValue", &SymbolReference::isLValue);
+
     py::class_<Compilation>(m, "Compilation")
         .def(py::init<>())
         .def(py::init<const Bag&>(), "options"_a)
@@ -114,6 +121,8 @@ void registerCompilation(py::module_& m) {
         .def("getSemanticDiagnostics", &Compilation::getSemanticDiagnostics, byrefint)
         .def("getAllDiagnostics", &Compilation::getAllDiagnostics, byrefint)
         .def("addDiagnostics", &Compilation::addDiagnostics, "diagnostics"_a)
+        .def("getReferences", &Compilation::getReferences, byrefint, "symbol"_a)
+        .def("getInstances", &Compilation::getInstances, byrefint, "definition"_a)
         .def("getType", py::overload_cast<SyntaxKind>(&Compilation::getType, py::const_), byrefint,
              "kind"_a)
         .def("getNetType", &Compilation::getNetType, byrefint, "kind"_a)
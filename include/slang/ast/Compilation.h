@@ -7,7 +7,10 @@
 //------------------------------------------------------------------------------
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <mutex>
 
 #include "slang/ast/InstancePath.h"
 #include "slang/ast/Scope.h"
@@ -33,6 +36,8 @@ class ConfigBlockSymbol;
 class Definition;
 class Expression;
 class GenericClassDefSymbol;
+class InstanceBodySymbol;
+class InstanceSymbol;
 class InterfacePortSymbol;
 class MethodPrototypeSymbol;
 class ModportSymbol;
@@ -41,6 +46,7 @@ class PrimitiveSymbol;
 class PortConnection;
 class RootSymbol;
 class Statement;
+class SubroutineBytecode;
 class SubroutineSymbol;
 class Symbol;
 class SystemSubroutine;
@@ -148,6 +154,28 @@ struct SLANG_EXPORT CompilationOptions {
     /// for an unknown definition.
     bool ignoreUnknownModules = false;
 
+    /// If true, disable sharing of elaboration work between instances that have
+    /// identical definitions and parameter values. Every instance body will be
+    /// fully visited when collecting diagnostics.
+    bool disableInstanceCaching = false;
+
+    /// If true, disable caching of the results of constant function calls.
+    /// Normally calls to functions whose results depend only on their arguments
+    /// are evaluated once per distinct set of argument values and then reused.
+    bool disableFunctionCaching = false;
+
+    /// If true, constant functions are lowered to a compact register-based
+    /// bytecode the first time they are called, and that bytecode is interpreted
+    /// instead of walking the function body's AST on every call.
+    bool enableBytecodeEval = false;
+
+    /// If true, record every expression that references a symbol and every
+    /// instance of each definition as the design is elaborated, so that they
+    /// can be looked up later via @a Compilation::getReferences and
+    /// @a Compilation::getInstances. Setting this also disables instance caching,
+    /// since every instance body must be elaborated for the index to be complete.
+    bool buildReferenceIndex = false;
+
     /// The default time scale to use for design elements that don't specify
     /// one explicitly.
     std::optional<TimeScale> defaultTimeScale;
@@ -182,6 +210,54 @@ struct HierarchyOverrideNode {
     std::vector<const syntax::BindDirectiveSyntax*> binds;
 };
 
+/// Elaboration cost statistics for a single definition, collected when
+/// profiling is enabled via @a Compilation::enableProfiling.
+///
+/// Costs are exclusive: work done while elaborating an instance nested
+/// inside one of the definition's bodies is attributed to the nested
+/// instance's definition instead.
+struct DefinitionProfile {
+    /// The definition being profiled.
+    const Definition* definition = nullptr;
+
+    /// The number of instances of the definition seen during elaboration.
+    uint64_t instances = 0;
+
+    /// The wall time spent elaborating bodies of the definition.
+    std::chrono::nanoseconds time{};
+
+    /// The number of bytes allocated from the compilation's allocator.
+    size_t allocatedBytes = 0;
+
+    /// The number of steps taken by constant evaluation.
+    uint64_t constEvalSteps = 0;
+};
+
+/// Statistics about the cache of constant function call results.
+struct FunctionCacheStats {
+    /// The number of calls whose result was reused from the cache.
+    uint64_t hits = 0;
+
+    /// The number of calls that had to be evaluated, with
+    /// their results then being added to the cache.
+    uint64_t misses = 0;
+};
+
+/// A single reference to a symbol, recorded when the
+/// @a CompilationOptions::buildReferenceIndex option is set.
+struct SymbolReference {
+    /// The expression that refers to the symbol. This is a NamedValue,
+    /// HierarchicalValue, or ArbitrarySymbol expression.
+    not_null<const Expression*> expr;
+
+    /// The scope in which the reference occurs.
+    not_null<const Scope*> scope;
+
+    /// True if the reference is an lvalue (i.e. the symbol is assigned),
+    /// and false if it's only read.
+    bool isLValue = false;
+};
+
 /// A centralized location for creating and caching symbols. This includes
 /// creating symbols from syntax nodes as well as fabricating them synthetically.
 /// Common symbols such as built in types are exposed here as well.
@@ -216,6 +292,27 @@ public:
     /// Gets the set of syntax trees that have been added to the compilation.
     std::span<const std::shared_ptr<syntax::SyntaxTree>> getSyntaxTrees() const;
 
+    /// @brief Gets the set of syntax trees whose elaboration can be affected by
+    /// a change to the given tree.
+    ///
+    /// The result includes @a tree itself along with every tree that instantiates,
+    /// imports, or otherwise references by name a module, interface, program,
+    /// package, class, primitive, or checker declared in @a tree, transitively.
+    /// Parameter values and port connections flow down the hierarchy, so every tree
+    /// declaring a definition that is instantiated by one of those trees is included
+    /// as well, also transitively. Trees containing either end of a hierarchical
+    /// reference into or out of an included tree are included too, but hierarchical
+    /// references are only known for the parts of the design that have already been
+    /// elaborated (e.g. by calling @a getAllDiagnostics).
+    ///
+    /// If any tree in the compilation contains defparams or bind directives the
+    /// dependencies can't be determined syntactically and all trees are returned.
+    ///
+    /// Note that an edit can change the names declared in a tree, so callers should
+    /// take the union of the result for both the old and new versions of an edited tree.
+    std::vector<std::shared_ptr<syntax::SyntaxTree>> getDependentSyntaxTrees(
+        const syntax::SyntaxTree& tree) const;
+
     /// Gets the root of the design. The first time you call this method all top-level
     /// instances will be elaborated and the compilation finalized. After that you can
     /// no longer make any modifications to the compilation object; any attempts to do
@@ -237,6 +334,44 @@ public:
     /// Gets all of the diagnostics produced during compilation.
     const Diagnostics& getAllDiagnostics();
 
+    /// @}
+    /// @name Profiling
+    /// @{
+
+    /// Enables collection of per-definition elaboration costs. This should be
+    /// called before the design is elaborated (i.e. before @a getRoot is called).
+    void enableProfiling();
+
+    /// Indicates whether per-definition profiling has been enabled.
+    bool isProfilingEnabled() const { return profiler != nullptr; }
+
+    /// Gets the per-definition elaboration costs collected so far,
+    /// sorted by descending elaboration time.
+    std::vector<DefinitionProfile> getDefinitionProfiles() const;
+
+    /// Gets the total number of constant evaluation steps taken so far.
+    uint64_t getConstEvalSteps() const { return constEvalSteps.load(std::memory_order_relaxed); }
+
+    /// Gets statistics about how often constant function call results
+    /// have been reused instead of being evaluated again. The statistics
+    /// shouldn't be read while evaluation is still running on other threads.
+    const FunctionCacheStats& getFunctionCacheStats() const { return functionCacheStats; }
+
+    /// @}
+    /// @name Reference index
+    /// @{
+
+    /// Gets all of the expressions found so far that refer to the given symbol,
+    /// in the order in which they were bound. This is only populated when the
+    /// @a CompilationOptions::buildReferenceIndex option is set, and is only
+    /// complete once the full design has been elaborated (e.g. by calling
+    /// @a getAllDiagnostics).
+    std::span<const SymbolReference> getReferences(const Symbol& symbol) const;
+
+    /// Gets all of the instances of the given definition found so far during
+    /// elaboration. The same caveats apply as for @a getReferences.
+    std::span<const InstanceSymbol* const> getInstances(const Definition& definition) const;
+
     /// @}
     /// @name Utility and convenience methods
     /// @{
@@ -470,6 +605,18 @@ public:
     /// The second item is only relevant for nodes where it makes sense; e.g. variables and nets.
     std::pair<bool, bool> isReferenced(const syntax::SyntaxNode& node) const;
 
+    /// Notes that a hierarchical reference was made from within @a scope to the
+    /// given @a target symbol. Any instance bodies that the reference crosses out of
+    /// or into depend on their location in the hierarchy and so can't share their
+    /// elaboration with other identically parameterized instances.
+    void noteHierarchicalReference(const Scope& scope, const Symbol& target);
+
+    /// Checks whether the given instance body has been referenced hierarchically in a way
+    /// that prevents it from sharing elaboration with identically parameterized instances.
+    bool hasHierarchicalReferences(const InstanceBodySymbol& body) const {
+        return hierarchicalRefBodies.contains(&body);
+    }
+
     /// Notes that the given symbol has a name conflict in its parent scope.
     /// This will cause appropriate errors to be issued.
     void noteNameConflict(const Symbol& symbol);
@@ -481,6 +628,53 @@ public:
     /// be elaborated and any relevant diagnostics to be issued.
     void forceElaborate(const Symbol& symbol);
 
+    /// Notes that a single step of constant evaluation has been taken.
+    void noteConstEvalStep() { constEvalSteps.fetch_add(1, std::memory_order_relaxed); }
+
+    /// Checks whether the results of constant calls to the given function depend
+    /// only on the values of its arguments, such that they can be cached.
+    /// This and the other call result cache methods are safe to call from
+    /// multiple threads at once.
+    bool canCacheCallResults(const SubroutineSymbol& subroutine);
+
+    /// Looks up the cached result of a previous constant call to the given function
+    /// with the given argument values. Returns std::nullopt if there isn't one.
+    std::optional<ConstantValue> findCachedCallResult(const SubroutineSymbol& subroutine,
+                                                      std::span<const ConstantValue> args);
+
+    /// Caches the result of a constant call to the given function
+    /// with the given argument values.
+    void cacheCallResult(const SubroutineSymbol& subroutine, std::span<const ConstantValue> args,
+                         const ConstantValue& result);
+
+    /// Gets the lowered bytecode for the body of the given subroutine, lowering it
+    /// on first use. Returns nullptr if bytecode evaluation is disabled or if the
+    /// subroutine can't be lowered, in which case its body should be evaluated directly.
+    /// This is safe to call from multiple threads at once.
+    const SubroutineBytecode* getSubroutineBytecode(const SubroutineSymbol& subroutine);
+
+    /// Notes that an instance of the given definition has been elaborated.
+    /// Only valid to call when profiling is enabled.
+    void noteProfiledInstance(const Definition& definition);
+
+    /// Records a reference to the given symbol in the reference index.
+    /// Only called when the index is enabled.
+    void noteSymbolReference(const Symbol& symbol, const Expression& expr, const Scope& scope,
+                             bool isLValue);
+
+    /// Records an elaborated instance in the reference index.
+    /// Only called when the index is enabled.
+    void noteInstance(const InstanceSymbol& instance);
+
+    /// Starts attributing elaboration costs to the given definition, until a
+    /// matching call to @a endDefinitionProfile. Calls can be nested.
+    /// Only valid to call when profiling is enabled.
+    void beginDefinitionProfile(const Definition& definition);
+
+    /// Stops attributing elaboration costs to the definition passed to
+    /// the most recent call to @a beginDefinitionProfile.
+    void endDefinitionProfile();
+
     /// Gets the default time scale to use when none is specified in the source code.
     std::optional<TimeScale> getDefaultTimeScale() const { return options.defaultTimeScale; }
 
@@ -671,6 +865,13 @@ private:
     // is stored here and queried during name lookups.
     SafeIndexedVector<Scope::ImportData, Scope::ImportDataIndex> importData;
 
+    // A set of instance bodies that contain (or are the target of) hierarchical
+    // references that leave (or enter) them.
+    flat_hash_set<const InstanceBodySymbol*> hierarchicalRefBodies;
+
+    // The scope and target of every hierarchical reference seen so far.
+    flat_hash_set<std::tuple<const Symbol*, const Symbol*>> hierarchicalRefs;
+
     // A map of syntax nodes that have been referenced in the AST.
     // The value indicates whether the node has been used as an lvalue vs non-lvalue,
     // for things like variables and nets.
@@ -830,6 +1031,40 @@ private:
 
     // The built-in std package.
     const PackageSymbol* stdPkg = nullptr;
+
+    // The total number of constant evaluation steps taken. This is atomic since
+    // tools may evaluate constants from multiple threads at once; the count is
+    // only a statistic, so relaxed ordering is enough.
+    std::atomic<uint64_t> constEvalSteps = 0;
+
+    // State for per-definition profiling, if enabled.
+    struct Profiler;
+    std::unique_ptr<Profiler> profiler;
+
+    // Maps from symbols and definitions to their references and instances,
+    // when the reference index is enabled.
+    flat_hash_map<const Symbol*, std::vector<SymbolReference>> referenceIndex;
+    flat_hash_map<const Definition*, std::vector<const InstanceSymbol*>> instanceIndex;
+
+    // Cached results of constant function calls, bucketed by the function and
+    // a hash of the argument values, along with whether each function that has
+    // been checked can have its results cached at all. Constant evaluation can
+    // happen on several threads at once, so these are guarded by a mutex.
+    struct CachedCallResult {
+        std::vector<ConstantValue> args;
+        ConstantValue result;
+    };
+    flat_hash_map<std::tuple<const SubroutineSymbol*, size_t>, std::vector<CachedCallResult>>
+        callResultCache;
+    flat_hash_map<const SubroutineSymbol*, bool> cacheableFunctions;
+    FunctionCacheStats functionCacheStats;
+    std::mutex functionCacheMutex;
+
+    // Lowered bytecode for constant functions, or nullptr for functions
+    // that can't be lowered.
+    flat_hash_map<const SubroutineSymbol*, std::unique_ptr<SubroutineBytecode>>
+        subroutineBytecode;
+    std::mutex bytecodeMutex;
 };
 
 } // namespace slang::ast
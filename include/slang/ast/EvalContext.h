@@ -7,12 +7,15 @@
 //------------------------------------------------------------------------------
 #pragma once
 
-#include <map>
+#include <memory>
+#include <vector>
 
 #include "slang/ast/ASTContext.h"
 #include "slang/numeric/ConstantValue.h"
 #include "slang/text/SourceLocation.h"
+#include "slang/util/Hash.h"
 #include "slang/util/ScopeGuard.h"
+#include "slang/util/SmallVector.h"
 
 namespace slang::ast {
 
@@ -32,11 +35,21 @@ public:
     /// Flags that control evaluation.
     bitmask<EvalFlags> flags;
 
+    /// Storage for the value of a single local variable.
+    struct LocalSlot {
+        /// The symbol of the local variable.
+        const ValueSymbol* symbol = nullptr;
+
+        /// The current value of the local variable.
+        ConstantValue value;
+    };
+
     /// Represents a single frame in the call stack.
     struct Frame {
-        /// A set of temporary values materialized within the stack frame.
-        /// Uses a map so that the values don't move around in memory.
-        std::map<const ValueSymbol*, ConstantValue> temporaries;
+        /// The temporary values materialized within the stack frame, in order
+        /// of creation. Slots are owned by the EvalContext and don't move around
+        /// in memory for as long as the local exists.
+        SmallVector<LocalSlot*, 8> temporaries;
 
         /// The function that is being executed in this frame, if any.
         const SubroutineSymbol* subroutine = nullptr;
@@ -46,6 +59,18 @@ public:
 
         /// The lookup location of the function call site.
         LookupLocation lookupLocation;
+
+        /// Finds the storage for the given local in this frame,
+        /// or nullptr if it doesn't exist.
+        LocalSlot* findSlot(const ValueSymbol* symbol) const;
+
+    private:
+        friend class EvalContext;
+
+        // Frames with lots of locals also get a hashed index; small frames
+        // are faster to search linearly.
+        static constexpr size_t IndexThreshold = 16;
+        flat_hash_map<const ValueSymbol*, LocalSlot*> index;
     };
 
     /// Constructs a new EvalContext instance.
@@ -160,6 +185,10 @@ public:
     /// Gets the set of diagnostics that have been produced during constant evaluation.
     Diagnostics getAllDiagnostics() const;
 
+    /// Gets the number of diagnostics, including warnings, that have been
+    /// produced so far during constant evaluation.
+    size_t getDiagnosticCount() const { return diags.size() + warnings.size(); }
+
     /// Records a diagnostic under the current evaluation context.
     Diagnostic& addDiag(DiagCode code, SourceLocation location);
 
@@ -177,6 +206,8 @@ public:
 
 private:
     void reportDiags(Diagnostics& diagSet);
+    LocalSlot* allocSlot();
+    void freeSlots(Frame& frame);
 
     uint32_t steps = 0;
     const Symbol* disableTarget = nullptr;
@@ -187,6 +218,11 @@ private:
     Diagnostics warnings;
     SourceRange disableRange;
     bool backtraceReported = false;
+
+    // Storage for local variable slots. Slots are recycled once their frame
+    // is popped, so repeatedly calling a function doesn't keep allocating.
+    std::vector<std::unique_ptr<LocalSlot[]>> slotBlocks;
+    SmallVector<LocalSlot*> freeSlotList;
 };
 
 } // namespace slang::ast
@@ -334,6 +334,17 @@ public:
     /// Returns true if any subexpression of this expression is a hierarchical reference.
     bool hasHierarchicalReference() const;
 
+    /// Applies the given (non-lvalue) unary operator to an already evaluated operand.
+    static ConstantValue evalUnaryOperator(UnaryOperator op, const ConstantValue& cv);
+
+    /// Applies the given increment or decrement operator to the value, updating
+    /// it in place, and returns the result of the overall expression.
+    static ConstantValue evalIncDecOperator(UnaryOperator op, ConstantValue& value);
+
+    /// Applies the given binary operator to already evaluated operands.
+    static ConstantValue evalBinaryOperator(BinaryOperator op, const ConstantValue& cvl,
+                                            const ConstantValue& cvr);
+
     /// Casts this expression to the given concrete derived type.
     /// Asserts that the type is appropriate given this expression's kind.
     template<typename T>
@@ -386,9 +397,6 @@ protected:
     static const Type* binaryOperatorType(Compilation& compilation, const Type* lt, const Type* rt,
                                           bool forceFourState, bool signednessFromRt = false);
 
-    static ConstantValue evalBinaryOperator(BinaryOperator op, const ConstantValue& cvl,
-                                            const ConstantValue& cvr);
-
     static Expression& create(Compilation& compilation, const ExpressionSyntax& syntax,
                               const ASTContext& context,
                               bitmask<ASTFlags> extraFlags = ASTFlags::None,
@@ -186,10 +186,10 @@ public:
 
     const SymbolMap& getNameMap() const {
         ensureElaborated();
-        return *nameMap;
+        return getUnelaboratedNameMap();
     }
 
-    const SymbolMap& getUnelaboratedNameMap() const { return *nameMap; }
+    const SymbolMap& getUnelaboratedNameMap() const { return nameMap ? *nameMap : emptyNameMap; }
 
     std::span<const WildcardImportSymbol* const> getWildcardImports() const;
 
@@ -211,6 +211,14 @@ protected:
 
     void addDeferredMembers(const syntax::SyntaxNode& syntax);
 
+    /// Makes room in the name map for at least @a count named members, to avoid
+    /// growing it repeatedly when a large number of members is about to be added.
+    void reserveMembers(size_t count) const;
+
+    /// Allocates the name map if it hasn't been already, so that a reference to it
+    /// stays valid while named members are being added to the scope.
+    void ensureNameMap() const;
+
 private:
     friend class Compilation;
 
@@ -285,7 +293,11 @@ private:
     const Symbol* thisSym;
 
     // The map of names to members that can be looked up within this scope.
-    SymbolMap* nameMap;
+    // This isn't allocated until the first named member gets added.
+    mutable SymbolMap* nameMap = nullptr;
+
+    // Shared by all scopes that don't have any named members.
+    static const SymbolMap emptyNameMap;
 
     // A linked list of member symbols in the scope. These are mutable because a
     // scope might have only deferred members, and realization of deferred members
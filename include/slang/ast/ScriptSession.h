@@ -24,7 +24,10 @@ public:
     Compilation compilation;
     CompilationUnitSymbol& scope;
 
-    ScriptSession();
+    /// Creates a new script session. @a options can hold @a CompilationOptions
+    /// for the session's compilation; hierarchical references are always allowed
+    /// in constant expressions, regardless of those options.
+    explicit ScriptSession(const Bag& options = {});
 
     ConstantValue eval(std::string_view text);
     ConstantValue evalExpression(const syntax::ExpressionSyntax& expr);
@@ -13,10 +13,14 @@
 #include "slang/ast/symbols/SubroutineSymbols.h"
 #include "slang/ast/types/AllTypes.h"
 #include "slang/syntax/SyntaxFwd.h"
+#include "slang/text/SourceLocation.h"
 #include "slang/util/Hash.h"
+#include "slang/util/IntervalMap.h"
 
 namespace slang::ast {
 
+class Expression;
+
 class SLANG_EXPORT SemanticModel {
 public:
     explicit SemanticModel(Compilation& compilation);
@@ -35,10 +39,60 @@ public:
     const EnumType* getDeclaredSymbol(const syntax::EnumTypeSyntax& syntax);
     const TypeAliasType* getDeclaredSymbol(const syntax::TypedefDeclarationSyntax& syntax);
 
+    /// Gets the innermost symbol whose declaration contains the given location,
+    /// or nullptr if there is no such symbol.
+    ///
+    /// The first call to any of the location based query methods elaborates the
+    /// whole design (if it hasn't been already) and records the source range of
+    /// every symbol and expression. An interval index for each source buffer is
+    /// then built the first time that buffer is queried, after which queries take
+    /// logarithmic time. Locations inside macro expansions are attributed to the
+    /// location where the macro was expanded. Bodies of modules that are
+    /// instantiated more than once are only indexed for the first instance.
+    const Symbol* getSymbolAt(SourceLocation location);
+
+    /// Gets the innermost expression whose source range contains the given location,
+    /// or nullptr if there is no such expression. Implicit conversions inserted by
+    /// the compiler are never returned. See @a getSymbolAt for performance notes.
+    const Expression* getExpressionAt(SourceLocation location);
+
+    /// Gets the symbol referred to by whatever name is at the given location.
+    /// For names used in expressions this is the referenced declaration, and for
+    /// the name of a declaration it is the declared symbol itself. Returns nullptr
+    /// if there is no name at the given location.
+    const Symbol* getReferencedSymbolAt(SourceLocation location);
+
 private:
+    struct PendingEntry {
+        uint32_t left;
+        uint32_t right;
+        const Symbol* symbol;
+        const Expression* expr;
+    };
+
+    struct BufferIndex {
+        IntervalMap<uint32_t, const Symbol*> symbols;
+        IntervalMap<uint32_t, const Expression*> expressions;
+    };
+
+    struct LocationVisitor;
+
+    void collectLocations();
+    const BufferIndex* getIndex(BufferID buffer);
+
     Compilation& compilation;
 
     flat_hash_map<const syntax::SyntaxNode*, const Symbol*> symbolCache;
+
+    // Location entries gathered by walking the design, per buffer,
+    // waiting to be moved into an index the first time they are needed.
+    flat_hash_map<BufferID, std::vector<PendingEntry>> pendingEntries;
+    flat_hash_map<BufferID, std::unique_ptr<BufferIndex>> bufferIndices;
+    bool locationsCollected = false;
+
+    BumpAllocator indexAlloc;
+    IntervalMap<uint32_t, const Symbol*>::allocator_type symbolMapAlloc;
+    IntervalMap<uint32_t, const Expression*>::allocator_type exprMapAlloc;
 };
 
 } // namespace slang::ast
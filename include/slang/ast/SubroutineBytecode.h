@@ -0,0 +1,96 @@
+//------------------------------------------------------------------------------
+//! @file SubroutineBytecode.h
+//! @brief Bytecode for evaluating constant functions
+//
+// SPDX-FileCopyrightText: Michael Popoloski
+// SPDX-License-Identifier: MIT
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "slang/ast/Statements.h"
+#include "slang/numeric/ConstantValue.h"
+
+namespace slang::ast {
+
+class EvalContext;
+class Expression;
+class SubroutineSymbol;
+class ValueSymbol;
+
+/// The body of a constant function lowered to a flat, register-based bytecode.
+///
+/// Temporaries live in numbered registers, locals are referred to by index instead
+/// of being looked up by symbol, assignments to locals and bit selects of locals
+/// are done directly instead of building LValue objects, and control flow is
+/// turned into jumps. Expressions and statements that don't have a dedicated
+/// instruction are evaluated by walking their AST, which works because locals
+/// still live in the EvalContext's stack frame. Evaluation steps are counted
+/// exactly as they are when walking the AST so that the constexpr step limit
+/// behaves the same with either engine.
+class SLANG_EXPORT SubroutineBytecode {
+public:
+    /// Lowers the body of the given subroutine. Returns nullptr if the body
+    /// contains something that can't be represented (such as disable statements),
+    /// in which case the body should be evaluated by walking its AST instead.
+    static std::unique_ptr<SubroutineBytecode> lower(const SubroutineSymbol& subroutine);
+
+    /// Runs the bytecode. The caller is expected to have already pushed a stack frame
+    /// for the subroutine with locals for its arguments and return value.
+    Statement::EvalResult run(EvalContext& context) const;
+
+    /// Gets the number of instructions in the lowered body.
+    size_t size() const { return code.size(); }
+
+private:
+    class Builder;
+
+    enum class Op : uint8_t {
+        Step,
+        Exec,
+        Const,
+        Eval,
+        Load,
+        Store,
+        DeclLocal,
+        IncDec,
+        Unary,
+        Binary,
+        ShortCircuit,
+        Convert,
+        CondMerge,
+        IndexRange,
+        SliceRange,
+        Slice,
+        StoreSlice,
+        CallCheck,
+        Call,
+        Jump,
+        JumpIfTrue,
+        JumpIfFalse,
+        JumpIfKnownTrue,
+        JumpIfKnownFalse,
+        Return
+    };
+
+    struct Instr {
+        Op op;
+        uint32_t dst = 0;
+        uint32_t a = 0;
+        uint32_t b = 0;
+        union {
+            const Expression* expr = nullptr;
+            const Statement* stmt;
+        };
+    };
+
+    std::vector<Instr> code;
+    std::vector<ConstantValue> constants;
+    std::vector<const ValueSymbol*> locals;
+    uint32_t numRegs = 0;
+    uint32_t numRanges = 0;
+};
+
+} // namespace slang::ast
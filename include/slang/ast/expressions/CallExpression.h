@@ -62,6 +62,10 @@ public:
     ConstantValue evalImpl(EvalContext& context) const;
     std::optional<bitwidth_t> getEffectiveWidthImpl() const;
 
+    /// Evaluates a call to a user-defined subroutine given argument values
+    /// that have already been evaluated in the caller's frame.
+    ConstantValue invoke(EvalContext& context, std::span<ConstantValue> args) const;
+
     void serializeTo(ASTSerializer& serializer) const;
 
     static Expression& fromSyntax(Compilation& compilation,
@@ -103,6 +107,11 @@ public:
                          std::string_view symbolName, SourceRange range, const ASTContext& context,
                          SmallVectorBase<const Expression*>& boundArgs, bool isBuiltInMethod);
 
+    /// Checks whether the given subroutine can be called from a constant
+    /// expression, issuing a diagnostic if not.
+    static bool checkConstant(EvalContext& context, const SubroutineSymbol& subroutine,
+                              SourceRange range);
+
     static bool isKind(ExpressionKind kind) { return kind == ExpressionKind::Call; }
 
     template<typename TVisitor>
@@ -139,9 +148,6 @@ private:
         const syntax::ArrayOrRandomizeMethodExpressionSyntax* withClause, SourceRange range,
         const ASTContext& context, const Scope* randomizeScope = nullptr);
 
-    static bool checkConstant(EvalContext& context, const SubroutineSymbol& subroutine,
-                              SourceRange range);
-
     const Expression* thisClass_;
     std::span<const Expression*> arguments_;
     LookupLocation lookupLocation;
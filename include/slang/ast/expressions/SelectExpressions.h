@@ -39,6 +39,11 @@ public:
     std::optional<ConstantRange> evalIndex(EvalContext& context, const ConstantValue& val,
                                            ConstantValue& associativeIndex, bool& softFail) const;
 
+    /// Like the above, but for a selector value that has already been evaluated.
+    std::optional<ConstantRange> evalIndex(EvalContext& context, const ConstantValue& val,
+                                           ConstantValue&& selectorValue,
+                                           ConstantValue& associativeIndex, bool& softFail) const;
+
     void serializeTo(ASTSerializer& serializer) const;
 
     static Expression& fromSyntax(Compilation& compilation, Expression& value,
@@ -92,6 +97,11 @@ public:
 
     std::optional<ConstantRange> evalRange(EvalContext& context, const ConstantValue& val) const;
 
+    /// Like the above, but for left and right bounds that have already been evaluated.
+    std::optional<ConstantRange> evalRange(EvalContext& context, const ConstantValue& val,
+                                           const ConstantValue& leftValue,
+                                           const ConstantValue& rightValue) const;
+
     void serializeTo(ASTSerializer& serializer) const;
 
     static Expression& fromSyntax(Compilation& compilation, Expression& value,
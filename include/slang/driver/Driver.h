@@ -8,6 +8,8 @@
 //------------------------------------------------------------------------------
 #pragma once
 
+#include <chrono>
+
 #include "slang/diagnostics/DiagnosticEngine.h"
 #include "slang/driver/SourceLoader.h"
 #include "slang/text/SourceManager.h"
@@ -20,6 +22,10 @@ namespace slang {
 class TextDiagnosticClient;
 }
 
+namespace slang::parsing {
+class IncludeTokenCache;
+}
+
 namespace slang::syntax {
 class SyntaxTree;
 }
@@ -59,6 +65,10 @@ public:
     /// The source manager that holds all loaded source files.
     SourceManager sourceManager;
 
+    /// A cache of lexed tokens for files that get included from sources
+    /// loaded into @a sourceManager, shared by all of their preprocessors.
+    std::shared_ptr<parsing::IncludeTokenCache> includeTokenCache;
+
     /// The diagnostics engine that will be used to report diagnostics.
     DiagnosticEngine diagEngine;
 
@@ -105,6 +115,9 @@ public:
         /// The number of threads to use for parsing.
         std::optional<uint32_t> numThreads;
 
+        /// A directory in which to cache parsed syntax trees between runs.
+        std::optional<std::string> parseCacheDir;
+
         /// @}
         /// @name Compilation
         /// @{
@@ -168,6 +181,18 @@ public:
         /// means not taking into account procedural for loop unrolling.
         std::optional<bool> strictDriverChecking;
 
+        /// If true, disable sharing of elaboration work between instances that
+        /// have identical definitions and parameter values.
+        std::optional<bool> disableInstanceCaching;
+
+        /// If true, disable reuse of the results of constant function calls
+        /// that have the same argument values.
+        std::optional<bool> disableFunctionCaching;
+
+        /// If true, evaluate constant functions by interpreting a bytecode
+        /// form of their bodies instead of walking their ASTs.
+        std::optional<bool> enableBytecodeEval;
+
         /// If true, only perform linting of code, don't try to elaborate a full hierarchy.
         std::optional<bool> onlyLint;
 
@@ -225,6 +250,18 @@ public:
         /// A set of extensions that will be used to exclude files.
         flat_hash_set<std::string> excludeExts;
 
+        /// @}
+        /// @name Profiling
+        /// @{
+
+        /// If true, print a report of the time, memory, and constant evaluation
+        /// work spent in each compilation phase and on each elaborated definition.
+        std::optional<bool> profile;
+
+        /// If set, the profiling report is also written in JSON format to
+        /// the given file (or to stdout if the path is '-').
+        std::optional<std::string> profileJson;
+
         /// @}
     } options;
 
@@ -309,7 +346,24 @@ public:
     /// @returns true if compilation succeeded and false if errors were encountered.
     [[nodiscard]] bool reportCompilation(ast::Compilation& compilation, bool quiet);
 
+    /// @brief Reports the profiling data collected for the given compilation.
+    ///
+    /// This is called automatically by @a reportCompilation when profiling
+    /// has been requested via the @a options.profile or @a options.profileJson options.
+    /// @returns true on success and false if the JSON report could not be written.
+    bool reportProfile(const ast::Compilation& compilation);
+
 private:
+    // Costs measured for a single top-level phase of compilation.
+    struct ProfilePhase {
+        std::string_view name;
+        std::chrono::nanoseconds time;
+        size_t allocatedBytes;
+        uint64_t constEvalSteps;
+    };
+
+    bool isProfiling() const { return options.profile == true || options.profileJson.has_value(); }
+
     void addLibraryFiles(std::string_view pattern);
     void addParseOptions(Bag& bag) const;
     void addCompilationOptions(Bag& bag) const;
@@ -319,6 +373,7 @@ private:
 
     bool anyFailedLoads = false;
     flat_hash_set<std::filesystem::path> activeCommandFiles;
+    std::vector<ProfilePhase> profilePhases;
 };
 
 } // namespace slang::driver
@@ -48,6 +48,13 @@ struct SLANG_EXPORT SourceOptions {
 
     /// If true, library files will inherit macro definitions from primary source files.
     bool librariesInheritMacros;
+
+    /// If set, a directory in which to cache the results of parsing source files.
+    /// Files whose contents, included files, and parsing options haven't changed
+    /// since they were last cached are loaded from the cache instead of being
+    /// parsed again. Only files that are parsed as their own compilation unit
+    /// without any errors are cached.
+    std::optional<std::string> parseCacheDir;
 };
 
 /// @brief Handles loading and parsing of groups of source files
@@ -179,6 +186,9 @@ private:
                        const std::filesystem::path& basePath);
     LoadResult loadAndParse(const FileEntry& fileEntry, const Bag& optionBag,
                             const SourceOptions& srcOptions);
+    std::shared_ptr<syntax::SyntaxTree> parseWithCache(const SourceBuffer& buffer,
+                                                       const Bag& optionBag,
+                                                       const std::string& cacheDir);
     void addError(const std::filesystem::path& path, std::error_code ec);
 
     SourceManager& sourceManager;
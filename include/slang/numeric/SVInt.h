@@ -210,7 +210,7 @@ public:
 
     ~SVInt() {
         if (!isSingleWord())
-            delete[] pVal;
+            freeWords(pVal, getNumWords());
     }
 
     /// Copy construct.
@@ -433,7 +433,7 @@ public:
             return *this;
 
         if (!isSingleWord())
-            delete[] pVal;
+            freeWords(pVal, getNumWords());
 
         val = rhs.val;
         bitWidth = rhs.bitWidth;
@@ -574,6 +574,14 @@ private:
     static SVInt allocUninitialized(bitwidth_t bits, bool signFlag, bool unknownFlag);
     static SVInt allocZeroed(bitwidth_t bits, bool signFlag, bool unknownFlag);
 
+    // Allocation of storage for multi-word values. Small buffers are recycled
+    // through a per-thread cache instead of going back to the system allocator.
+    // It's fine to free a buffer with a smaller word count than it was
+    // allocated with, but never with a larger one.
+    static uint64_t* allocWords(uint32_t numWords);
+    static uint64_t* allocWordsZeroed(uint32_t numWords);
+    static void freeWords(uint64_t* data, uint32_t numWords);
+
     // Initialization routines for various cases.
     void initSlowCase(logic_t bit);
     void initSlowCase(uint64_t value);
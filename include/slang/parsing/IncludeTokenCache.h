@@ -0,0 +1,65 @@
+//------------------------------------------------------------------------------
+//! @file IncludeTokenCache.h
+//! @brief Cache of lexed tokens for included files
+//
+// SPDX-FileCopyrightText: Michael Popoloski
+// SPDX-License-Identifier: MIT
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "slang/parsing/Lexer.h"
+#include "slang/parsing/LexerFacts.h"
+#include "slang/parsing/Token.h"
+#include "slang/util/BumpAllocator.h"
+#include "slang/util/Hash.h"
+
+namespace slang::parsing {
+
+/// The full sequence of tokens lexed from the contents of a source file, which
+/// can be replayed by lexers for other buffers that share those same contents.
+struct SLANG_EXPORT LexedTokens {
+    /// The lexed tokens, ending with an EndOfFile token.
+    std::vector<Token> tokens;
+
+    /// The keyword version that was in effect when lexing the tokens.
+    KeywordVersion keywordVersion;
+
+    /// Owns the memory for the lexed tokens.
+    BumpAllocator alloc;
+};
+
+/// A thread-safe cache of lexed token streams for included files.
+///
+/// Every time a file is included the source manager creates a new buffer for it,
+/// but the underlying file contents are shared. This cache holds on to the tokens
+/// lexed from such contents the first time they are included so that later
+/// inclusions, from any preprocessor on any thread, can replay them instead of
+/// lexing the same text again.
+///
+/// Tokens handed out by the cache refer to memory owned by the cache, so it must
+/// outlive any syntax trees parsed with it. Storing it in the preprocessor options
+/// takes care of that since each tree holds on to a copy of its options.
+class SLANG_EXPORT IncludeTokenCache {
+public:
+    /// Gets the tokens for the contents of the given buffer, lexing them with
+    /// the given keyword version and storing them in the cache if they're not
+    /// already there. Returns nullptr if the contents can't be cached because
+    /// lexing them produced diagnostics.
+    std::shared_ptr<const LexedTokens> getOrLex(const SourceBuffer& buffer,
+                                                KeywordVersion keywordVersion,
+                                                const LexerOptions& options);
+
+    /// Gets the number of distinct file contents that have been lexed and cached.
+    size_t size() const;
+
+private:
+    mutable std::mutex mutex;
+    flat_hash_map<std::tuple<const char*, KeywordVersion>, std::shared_ptr<const LexedTokens>>
+        entries;
+};
+
+} // namespace slang::parsing
@@ -7,6 +7,8 @@
 //------------------------------------------------------------------------------
 #pragma once
 
+#include <memory>
+
 #include "slang/diagnostics/Diagnostics.h"
 #include "slang/parsing/LexerFacts.h"
 #include "slang/parsing/Token.h"
@@ -22,6 +24,8 @@ class BumpAllocator;
 
 namespace slang::parsing {
 
+struct LexedTokens;
+
 /// Contains various options that can control lexing behavior.
 struct SLANG_EXPORT LexerOptions {
     /// The maximum number of errors that can occur before the rest of the source
@@ -59,6 +63,12 @@ public:
     /// Lexes a token that contains encoded text as part of a protected envelope.
     Token lexEncodedText(ProtectEncoding encoding, uint32_t expectedBytes, bool singleLine);
 
+    /// Sets a stream of tokens, previously lexed from the same contents as this
+    /// lexer's buffer, to hand out instead of lexing the text again. Replaying stops
+    /// and normal lexing resumes from the same spot as soon as a token is requested
+    /// with a different keyword version or encoded text needs to be lexed.
+    void setReplayTokens(std::shared_ptr<const LexedTokens> tokens);
+
     /// Returns the library with which the lexer's source buffer is associated.
     const SourceLibrary* getLibrary() const { return library; }
 
@@ -157,6 +167,10 @@ private:
     SmallVector<char> stringBuffer;
 
     const SourceLibrary* library = nullptr;
+
+    // previously lexed tokens that are being replayed, if any
+    std::shared_ptr<const LexedTokens> replayTokens;
+    size_t replayIndex = 0;
 };
 
 } // namespace slang::parsing
@@ -31,6 +31,8 @@ struct PragmaExpressionSyntax;
 
 namespace slang::parsing {
 
+class IncludeTokenCache;
+
 /// Contains various options that can control preprocessing behavior.
 struct SLANG_EXPORT PreprocessorOptions {
     /// The maximum depth of the include stack; further attempts to include
@@ -50,6 +52,12 @@ struct SLANG_EXPORT PreprocessorOptions {
 
     /// A set of preprocessor directives to be ignored.
     flat_hash_set<std::string_view> ignoreDirectives;
+
+    /// An optional cache of lexed tokens for included files, which lets files
+    /// that get included many times be lexed only once. The cache can be shared
+    /// by preprocessors running on different threads, as long as they all use
+    /// the same source manager.
+    std::shared_ptr<IncludeTokenCache> includeTokenCache;
 };
 
 /// Preprocessor - Interface between lexer and parser
@@ -63,6 +71,13 @@ public:
                  const Bag& options = {},
                  std::span<const syntax::DefineDirectiveSyntax* const> inheritedMacros = {});
 
+    struct TokenRecording;
+
+    /// Creates a preprocessor that returns the tokens from @a recording instead of
+    /// preprocessing any source text. See @a recordTokens for details.
+    Preprocessor(SourceManager& sourceManager, BumpAllocator& alloc, Diagnostics& diagnostics,
+                 const TokenRecording& recording);
+
     /// Gets the next token in the stream, after applying preprocessor rules.
     Token next();
 
@@ -110,6 +125,61 @@ public:
     /// where directives may appear.
     void popDesignElementStack() { designElementDepth--; }
 
+    /// The state of compiler directives, aside from macros, that a parser
+    /// can observe while consuming tokens from the preprocessor.
+    struct DirectiveState {
+        /// The active `timescale value, if any.
+        std::optional<TimeScale> timeScale;
+
+        /// The active `default_nettype value.
+        TokenKind defaultNetType = TokenKind::WireKeyword;
+
+        /// The active `unconnected_drive value.
+        TokenKind unconnectedDrive = TokenKind::Unknown;
+
+        /// The active keyword version.
+        KeywordVersion keywordVersion = KeywordVersion::v1800_2017;
+
+        bool operator==(const DirectiveState& rhs) const = default;
+    };
+
+    /// Gets the current state of compiler directives.
+    DirectiveState getDirectiveState() const;
+
+    /// Sets the state of compiler directives, typically to one previously returned
+    /// from @a getDirectiveState on a different preprocessor.
+    void setDirectiveState(const DirectiveState& state);
+
+    /// A stream of preprocessed tokens, along with the state a parser would
+    /// have observed from the preprocessor while consuming them.
+    struct TokenRecording {
+        /// A change in state that takes effect once the token at
+        /// @a tokenIndex has been returned.
+        struct StateChange {
+            size_t tokenIndex;
+            DirectiveState directives;
+            const SourceLibrary* library;
+        };
+
+        /// The tokens, ending with an EndOfFile token.
+        std::vector<Token> tokens;
+
+        /// The changes in state, ordered by token index. The first
+        /// entry is always for the first token.
+        std::vector<StateChange> states;
+
+        /// The index of the first token that came from each of the sources
+        /// pushed before recording started, in the order they were preprocessed.
+        std::vector<size_t> sourceStarts;
+    };
+
+    /// Preprocesses tokens until reaching the end of the current sources and
+    /// returns them in a recording. A preprocessor created from the recording
+    /// will return the same tokens and report the same state, without doing any
+    /// preprocessing (or touching the source manager) itself. This allows parsing
+    /// to be split up and done in parallel after a single preprocessing pass.
+    TokenRecording recordTokens();
+
     /// Gets the currently active time scale value, if any has been set by the user.
     const std::optional<TimeScale>& getTimeScale() const { return activeTimeScale; }
 
@@ -147,6 +217,7 @@ private:
     // Internal methods to grab and handle the next token
     Token nextProcessed();
     Token nextRaw();
+    Token nextReplayed();
     void popSource();
 
     // directive handling methods
@@ -399,6 +470,16 @@ private:
     TokenKind unconnectedDrive = TokenKind::Unknown;
 
     int designElementDepth = 0;
+
+    // The recording being replayed, if any, and our position in it.
+    const TokenRecording* replay = nullptr;
+    const SourceLibrary* replayLibrary = nullptr;
+    size_t replayIndex = 0;
+    size_t replayStateIndex = 0;
+
+    // The number of pushed (not included) sources that have been finished.
+    size_t sourcesFinished = 0;
+
     uint32_t includeDepth = 0;
     uint32_t protectEncryptDepth = 0;
     uint32_t protectDecryptDepth = 0;
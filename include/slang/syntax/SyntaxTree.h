@@ -18,6 +18,7 @@
 namespace slang {
 
 class SourceManager;
+class ThreadPool;
 struct SourceBuffer;
 
 } // namespace slang
@@ -138,6 +139,48 @@ public:
                                                    const Bag& options = {},
                                                    MacroList inheritedMacros = {});
 
+    /// Creates a syntax tree by concatenating several loaded source buffers,
+    /// parsing the buffers in parallel on the given thread pool.
+    ///
+    /// The buffers are first preprocessed together on the calling thread, exactly
+    /// as the non-parallel version of @a fromBuffers would, and the resulting
+    /// tokens are recorded. The tokens of each buffer are then parsed separately
+    /// and the results are stitched back together into a single compilation unit.
+    /// If any buffer can't be parsed on its own (for example because a design
+    /// element spans two files) all of the recorded tokens are parsed together
+    /// instead, so the resulting tree is equivalent to the one produced by the
+    /// non-parallel version of @a fromBuffers.
+    ///
+    /// @a buffers is the list of buffers that should be concatenated to form
+    /// the compilation unit to parse.
+    /// @a sourceManager is the manager that owns the buffers.
+    /// @a threadPool is the pool of threads used to parse the buffers.
+    /// @a options is an optional bag of lexer, preprocessor, and parser options.
+    /// @a inheritedMacros is a list of macros to predefine in the new syntax tree.
+    /// @return the created and parsed syntax tree.
+    static std::shared_ptr<SyntaxTree> fromBuffers(std::span<const SourceBuffer> buffers,
+                                                   SourceManager& sourceManager,
+                                                   ThreadPool& threadPool,
+                                                   const Bag& options = {},
+                                                   MacroList inheritedMacros = {});
+
+    /// Recreates a syntax tree from data previously produced by @a serialize.
+    /// @a data is the serialized tree data.
+    /// @a buffer is the loaded source buffer that the tree was originally parsed from.
+    /// @a sourceManager is the manager that owns the buffer.
+    /// @a options is an optional bag of lexer, preprocessor, and parser options.
+    /// @return the recreated syntax tree, or nullptr if the data is invalid, was
+    /// produced by a different version of the library, or no longer matches the
+    /// contents of the source buffer or any of the files it includes.
+    ///
+    /// @note The caller is responsible for ensuring that the data was produced
+    /// using the same @a options and predefined macros, since those are not
+    /// recorded in the serialized data.
+    static std::shared_ptr<SyntaxTree> fromSerialized(std::span<const char> data,
+                                                      const SourceBuffer& buffer,
+                                                      SourceManager& sourceManager,
+                                                      const Bag& options = {});
+
     /// Creates a syntax tree from a library map file.
     /// @a path is the path to the source file on disk.
     /// @a sourceManager is the manager that owns all of the loaded source code.
@@ -202,6 +245,13 @@ public:
     /// Gets the list of macros that were defined at the end of the loaded source file.
     MacroList getDefinedMacros() const { return macros; }
 
+    /// Serializes the contents of the tree into a compact binary form that
+    /// can be loaded again later via @a fromSerialized.
+    /// @return the serialized data, or nullopt if the tree can't be serialized.
+    /// Only trees that were parsed from a single source buffer without any
+    /// errors are supported.
+    std::optional<std::vector<char>> serialize() const;
+
     /// This is a shared default source manager for cases where the user doesn't
     /// care about managing the lifetime of loaded source. Note that all of
     /// the source loaded by this thing will live in memory for the lifetime of
@@ -7,6 +7,7 @@
 //------------------------------------------------------------------------------
 #pragma once
 
+#include <iosfwd>
 #include <memory>
 
 #include "slang/util/Util.h"
@@ -34,9 +35,22 @@ public:
     /// and indentation are added to make the output more human friendly.
     void setPrettyPrint(bool enabled) { pretty = enabled; }
 
+    /// Directs the emitted JSON text to the given stream. Text is buffered in memory
+    /// and flushed to the stream whenever more than @a flushThreshold bytes have
+    /// accumulated, so that very large documents never need to be held in memory
+    /// all at once. Call @a flush once writing is done to write out the remainder.
+    void setOutput(std::ostream& os, size_t flushThreshold = 1 << 20);
+
+    /// Writes all buffered text to the output stream set via @a setOutput,
+    /// aside from a trailing separator that may still need to be removed.
+    /// Does nothing if no output stream has been set.
+    void flush();
+
     /// @return a view of the emitted JSON text so far.
     /// @note the returned view is not guaranteed to remain valid once
     /// additional writes are performed.
+    /// @note if an output stream has been set, only text that has not
+    /// yet been flushed to the stream is included.
     std::string_view view() const;
 
     /// Begins a new JSON object. It's expected that you will write zero or
@@ -76,10 +90,13 @@ public:
 
 private:
     void endValue();
+    void flushIfNeeded();
     size_t findLastComma() const;
     void writeQuoted(std::string_view str);
 
     std::unique_ptr<FormatBuffer> buffer;
+    std::ostream* output = nullptr;
+    size_t flushThreshold = 0;
 
     int currentIndent = 0;
     int indentSize = 2;
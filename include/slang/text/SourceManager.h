@@ -166,6 +166,17 @@ public:
     /// disabled to always use the simple filename.
     void setDisableProximatePaths(bool set) { disableProximatePaths = set; }
 
+    /// Sets the minimum size, in bytes, of files that will be memory mapped instead of
+    /// being read into a heap allocated buffer when loaded from disk. Mapping avoids
+    /// copying the contents of very large files (such as generated netlists), and lets
+    /// the OS reclaim pages that are no longer being used. Setting this to zero disables
+    /// memory mapping entirely.
+    /// @warning Files must not be modified on disk while they are mapped.
+    void setMemoryMapThreshold(size_t bytes) { memoryMapThreshold = bytes; }
+
+    /// The default value for @a setMemoryMapThreshold.
+    static constexpr size_t DefaultMemoryMapThreshold = 1024 * 1024;
+
     /// Adds a line directive at the given location.
     void addLineDirective(SourceLocation location, size_t lineNum, std::string_view name,
                           uint8_t level);
@@ -228,15 +239,24 @@ private:
     // Stores actual file contents and metadata; only one per loaded file
     struct FileData {
         const std::string name;                       // name of the file
-        const SmallVector<char> mem;                  // file contents
+        const SmallVector<char> storage;              // file contents, if read into memory
+        const std::span<const char> mem;              // file contents (null terminated)
+        const bool isMapped;                          // whether mem is a memory mapped file
         std::vector<size_t> lineOffsets;              // cache of compute line offsets
         const std::filesystem::path* const directory; // directory in which the file exists
         const std::filesystem::path fullPath;         // full path to the file
 
         FileData(const std::filesystem::path* directory, std::string name, SmallVector<char>&& data,
-                 std::filesystem::path fullPath) :
+                 std::span<const char> mappedData, std::filesystem::path fullPath) :
             name(std::move(name)),
-            mem(std::move(data)), directory(directory), fullPath(std::move(fullPath)) {}
+            storage(std::move(data)),
+            mem(mappedData.empty() ? std::span<const char>(storage.data(), storage.size())
+                                   : mappedData),
+            isMapped(!mappedData.empty()), directory(directory), fullPath(std::move(fullPath)) {}
+
+        FileData(const FileData&) = delete;
+        FileData& operator=(const FileData&) = delete;
+        ~FileData();
     };
 
     // Stores a pointer to file data along with information about where we included it.
@@ -304,6 +324,7 @@ private:
     flat_hash_map<BufferID, std::vector<DiagnosticDirectiveInfo>> diagDirectives;
 
     std::atomic<uint32_t> unnamedBufferCount = 0;
+    size_t memoryMapThreshold = DefaultMemoryMapThreshold;
     bool disableProximatePaths = false;
 
     template<IsLock TLock>
@@ -320,7 +341,7 @@ private:
                              const SourceLibrary* library);
     SourceBuffer cacheBuffer(std::filesystem::path&& path, std::string&& pathStr,
                              SourceLocation includedFrom, const SourceLibrary* library,
-                             SmallVector<char>&& buffer);
+                             SmallVector<char>&& buffer, std::span<const char> mappedData);
 
     template<IsLock TLock>
     size_t getRawLineNumber(SourceLocation location, TLock& lock) const;
@@ -340,7 +361,7 @@ private:
     template<IsLock TLock>
     SourceRange getExpansionRangeImpl(SourceLocation location, TLock& lock) const;
 
-    static void computeLineOffsets(const SmallVector<char>& buffer,
+    static void computeLineOffsets(std::span<const char> buffer,
                                    std::vector<size_t>& offsets) noexcept;
 };
 
@@ -18,6 +18,14 @@ namespace slang {
 /// Allocates items sequentially in memory, with underlying memory allocated in
 /// blocks as needed. Individual items cannot be deallocated; the entire thing
 /// must be destroyed to release the memory.
+///
+/// Blocks start out small, so that allocators which only ever hold a few items
+/// stay cheap, and double in size each time a new one is needed (up to a limit)
+/// so that allocators holding lots of data make few calls into the system allocator.
+///
+/// The allocator is not thread safe; concurrent work (such as parsing several
+/// files in parallel) should give each thread its own allocator, and can then
+/// transfer the results to a single owner via @a steal.
 class SLANG_EXPORT BumpAllocator {
 public:
     BumpAllocator();
@@ -51,8 +59,16 @@ public:
 
     /// Steals ownership of all of the memory contents of the given allocator.
     /// The other allocator will be in a moved-from state after the call.
+    /// This is O(1) in the amount of memory held by either allocator.
     void steal(BumpAllocator&& other);
 
+    /// Gets the total number of bytes that have been handed out by the allocator
+    /// (including any stolen from other allocators), not counting alignment padding
+    /// at segment boundaries or unused space at the end of segments.
+    size_t getBytesAllocated() const {
+        return head ? retiredBytes + size_t(head->current - (byte*)(head + 1)) : 0;
+    }
+
 protected:
     // Allocations are tracked as a linked list of segments.
     struct Segment {
@@ -61,9 +77,12 @@ protected:
     };
 
     Segment* head;
+    Segment* tail;
     byte* endPtr;
+    size_t nextSegmentSize;
+    size_t retiredBytes = 0;
 
-    enum { INITIAL_SIZE = 512, SEGMENT_SIZE = 4096 };
+    enum { INITIAL_SIZE = 512, SEGMENT_SIZE = 4096, MAX_SEGMENT_SIZE = 1024 * 1024 };
 
     // Slow path handling of allocation.
     byte* allocateSlow(size_t size, size_t alignment);
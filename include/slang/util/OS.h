@@ -9,6 +9,7 @@
 
 #include <filesystem>
 #include <fmt/color.h>
+#include <span>
 
 #include "slang/util/ScopeGuard.h"
 #include "slang/util/SmallVector.h"
@@ -39,6 +40,19 @@ public:
     /// Note that the buffer will be null-terminated.
     static std::error_code readFile(const std::filesystem::path& path, SmallVector<char>& buffer);
 
+    /// Tries to map the file at @a path into memory for reading. Like @a readFile, the
+    /// resulting text includes a null terminator at the end. Returns an empty span
+    /// if the file can't be mapped (for example, it's not a regular file, it is
+    /// smaller than @a minSize, or there is no room in its final page for the terminator);
+    /// the caller should fall back to @a readFile in that case.
+    static std::span<const char> mapFile(const std::filesystem::path& path, size_t minSize);
+
+    /// Releases a mapping previously returned by @a mapFile.
+    static void unmapFile(std::span<const char> data);
+
+    /// Gets the ID of the current process.
+    static uint64_t getProcessId();
+
     /// Prints text to stdout.
     static void print(std::string_view text);
 
@@ -7,12 +7,16 @@
 //------------------------------------------------------------------------------
 #pragma once
 
+#include <algorithm>
 #include <atomic>
+#include <condition_variable>
+#include <cstddef>
 #include <deque>
 #include <functional>
 #include <future>
 #include <memory>
 #include <mutex>
+#include <new>
 #include <thread>
 #include <type_traits>
 #include <vector>
@@ -21,7 +25,14 @@
 
 namespace slang {
 
-/// A lightweight thread pool for running concurrent jobs.
+/// @brief A lightweight thread pool for running concurrent jobs.
+///
+/// Each worker thread owns a queue of tasks. Tasks pushed from a worker thread
+/// go into that worker's own queue, and tasks pushed from outside the pool are
+/// distributed among the workers round-robin. Workers run tasks from their own
+/// queue in LIFO order and, when it runs dry, steal the oldest tasks from the
+/// other workers' queues, which keeps all threads busy even when task durations
+/// vary wildly.
 class ThreadPool {
 public:
     /// @brief Constructs a new ThreadPool.
@@ -36,14 +47,11 @@ public:
                 threadCount = 1;
         }
 
-        {
-            std::unique_lock lock(mutex);
-            waiting = false;
-            running = true;
-        }
+        queues = std::make_unique<WorkQueue[]>(threadCount);
+        numQueues = threadCount;
 
         for (unsigned i = 0; i < threadCount; i++)
-            threads.emplace_back(&ThreadPool::worker, this);
+            threads.emplace_back(&ThreadPool::worker, this, size_t(i));
     }
 
     /// Destroys the thread pool, blocking until all threads have exited.
@@ -51,7 +59,7 @@ public:
         waitForAll();
 
         {
-            std::unique_lock lock(mutex);
+            std::unique_lock lock(sleepMutex);
             running = false;
         }
 
@@ -69,12 +77,10 @@ public:
     /// calling @a waitForAll and waiting for all tasks in the pool to complete.
     template<typename TFunc, typename... TArgs>
     void pushTask(TFunc&& task, TArgs&&... args) {
-        {
-            std::unique_lock lock(mutex);
-            tasks.emplace_back(std::bind(std::forward<TFunc>(task), std::forward<TArgs>(args)...));
-        }
-
-        taskAvailable.notify_one();
+        if constexpr (sizeof...(TArgs) == 0)
+            enqueue(Task(std::forward<TFunc>(task)));
+        else
+            enqueue(Task(std::bind(std::forward<TFunc>(task), std::forward<TArgs>(args)...)));
     }
 
     /// @brief Submits a task into the pool for execution and returns a future
@@ -111,38 +117,65 @@ public:
     /// @brief Pushes several tasks into the pool in order to parallelize
     /// the loop given by [from, to).
     ///
-    /// The loop will be broken into a number of blocks as specified by
-    /// @a numBlocks -- or if zero, the number of blocks will be set to
-    /// the number of threads in the pool.
+    /// @a body is invoked with disjoint [start, end) sub-ranges that together
+    /// cover the whole loop. If @a numBlocks is zero (the default) the sub-ranges
+    /// are claimed dynamically by the worker threads, starting with large chunks
+    /// and shrinking as the loop nears completion, so that iterations with
+    /// uneven costs still get balanced across threads. Otherwise the loop is
+    /// split up front into @a numBlocks equally sized blocks.
     template<typename TIndex, typename TFunc>
     void pushLoop(TIndex from, TIndex to, TFunc&& body, size_t numBlocks = 0) {
         SLANG_ASSERT(to >= from);
-        if (!numBlocks)
-            numBlocks = getThreadCount();
-
         const size_t totalSize = size_t(to - from);
         if (!totalSize)
             return;
 
-        size_t blockSize = totalSize / numBlocks;
-        if (blockSize == 0) {
-            blockSize = 1;
-            numBlocks = totalSize;
+        if (numBlocks) {
+            size_t blockSize = totalSize / numBlocks;
+            if (blockSize == 0) {
+                blockSize = 1;
+                numBlocks = totalSize;
+            }
+
+            for (size_t i = 0; i < numBlocks; i++) {
+                const TIndex start = TIndex(i * blockSize) + from;
+                const TIndex end = i == numBlocks - 1 ? to : TIndex(start + blockSize);
+                pushTask(body, start, end);
+            }
+            return;
         }
 
-        for (size_t i = 0; i < numBlocks; i++) {
-            const TIndex start = TIndex(i * blockSize) + from;
-            const TIndex end = i == numBlocks - 1 ? to : TIndex(start + blockSize);
-            pushTask(std::forward<TFunc>(body), start, end);
+        struct LoopState {
+            std::decay_t<TFunc> body;
+            std::atomic<size_t> next = 0;
+        };
+
+        auto state = std::make_shared<LoopState>(std::forward<TFunc>(body));
+        const size_t numTasks = std::min(totalSize, getThreadCount());
+        const size_t divisor = numTasks * 2;
+
+        for (size_t i = 0; i < numTasks; i++) {
+            pushTask([state, from, totalSize, divisor] {
+                // Each chunk is a fraction of the remaining iterations, so work
+                // is handed out in big pieces at first and small ones at the end.
+                size_t start = state->next.load(std::memory_order_relaxed);
+                while (start < totalSize) {
+                    const size_t chunk = std::max(size_t(1), (totalSize - start) / divisor);
+                    if (state->next.compare_exchange_weak(start, start + chunk,
+                                                          std::memory_order_relaxed)) {
+                        state->body(TIndex(from + TIndex(start)),
+                                    TIndex(from + TIndex(start + chunk)));
+                        start = state->next.load(std::memory_order_relaxed);
+                    }
+                }
+            });
         }
     }
 
     /// Blocks the calling thread until all running tasks are complete.
     void waitForAll() {
-        std::unique_lock lock(mutex);
-        waiting = true;
-        taskDone.wait(lock, [this] { return !currentTasks && tasks.empty(); });
-        waiting = false;
+        std::unique_lock lock(doneMutex);
+        taskDone.wait(lock, [this] { return unfinishedTasks.load() == 0; });
     }
 
     /// Blocks the calling thread until all running tasks are complete, or
@@ -150,43 +183,199 @@ public:
     /// @returns true if all tasks completed, or false if the timeout was reached first
     template<typename R, typename P>
     bool waitForAll(const std::chrono::duration<R, P>& duration) {
-        std::unique_lock lock(mutex);
-        waiting = true;
-        const bool status = taskDone.wait_for(lock, duration,
-                                              [this] { return !currentTasks && tasks.empty(); });
-        waiting = false;
-        return status;
+        std::unique_lock lock(doneMutex);
+        return taskDone.wait_for(lock, duration, [this] { return unfinishedTasks.load() == 0; });
     }
 
 private:
-    void worker() {
+    // A move-only type-erased callable. Callables that fit in the inline buffer,
+    // which includes almost every lambda used with the pool, are stored without
+    // any heap allocation.
+    class Task {
+    public:
+        Task() = default;
+
+        template<typename TFunc>
+        explicit Task(TFunc&& func) {
+            using T = std::decay_t<TFunc>;
+            if constexpr (sizeof(T) <= sizeof(storage) &&
+                          alignof(T) <= alignof(std::max_align_t) &&
+                          std::is_nothrow_move_constructible_v<T>) {
+                new (storage) T(std::forward<TFunc>(func));
+                ops = &InlineOps<T>::ops;
+            }
+            else {
+                new (storage) T*(new T(std::forward<TFunc>(func)));
+                ops = &HeapOps<T>::ops;
+            }
+        }
+
+        Task(Task&& other) noexcept : ops(other.ops) {
+            if (ops) {
+                ops->move(other.storage, storage);
+                other.ops = nullptr;
+            }
+        }
+
+        Task& operator=(Task&& other) noexcept {
+            if (this != &other) {
+                reset();
+                ops = other.ops;
+                if (ops) {
+                    ops->move(other.storage, storage);
+                    other.ops = nullptr;
+                }
+            }
+            return *this;
+        }
+
+        ~Task() { reset(); }
+
+        void operator()() { ops->invoke(storage); }
+
+    private:
+        struct Ops {
+            void (*invoke)(void*);
+            void (*move)(void* from, void* to);
+            void (*destroy)(void*);
+        };
+
+        template<typename T>
+        struct InlineOps {
+            static constexpr Ops ops = {
+                [](void* p) { (*static_cast<T*>(p))(); },
+                [](void* from, void* to) {
+                    new (to) T(std::move(*static_cast<T*>(from)));
+                    static_cast<T*>(from)->~T();
+                },
+                [](void* p) { static_cast<T*>(p)->~T(); }};
+        };
+
+        template<typename T>
+        struct HeapOps {
+            static constexpr Ops ops = {
+                [](void* p) { (**static_cast<T**>(p))(); },
+                [](void* from, void* to) { new (to) T*(*static_cast<T**>(from)); },
+                [](void* p) { delete *static_cast<T**>(p); }};
+        };
+
+        void reset() {
+            if (ops) {
+                ops->destroy(storage);
+                ops = nullptr;
+            }
+        }
+
+        alignas(std::max_align_t) std::byte storage[6 * sizeof(void*)];
+        const Ops* ops = nullptr;
+    };
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    // Identifies the pool and queue index of the current thread,
+    // if it happens to be one of the pool's worker threads.
+    struct WorkerInfo {
+        ThreadPool* pool = nullptr;
+        size_t index = 0;
+    };
+    static WorkerInfo& currentWorker() {
+        static thread_local WorkerInfo info;
+        return info;
+    }
+
+    void enqueue(Task&& task) {
+        unfinishedTasks.fetch_add(1);
+
+        size_t index;
+        if (auto& info = currentWorker(); info.pool == this)
+            index = info.index;
+        else
+            index = nextQueue.fetch_add(1, std::memory_order_relaxed) % numQueues;
+
+        {
+            std::unique_lock lock(queues[index].mutex);
+            queues[index].tasks.emplace_back(std::move(task));
+        }
+
+        // Taking the sleep lock here (even though we don't modify anything under it)
+        // ensures that a worker can't miss the notification between checking for
+        // queued tasks and going to sleep.
+        queuedTasks.fetch_add(1);
+        { std::unique_lock lock(sleepMutex); }
+        taskAvailable.notify_one();
+    }
+
+    bool tryPop(size_t index, Task& task) {
+        // Our own queue is used like a stack, since the most recently pushed
+        // task is likely to have its data still hot in the cache.
+        auto& queue = queues[index];
+        std::unique_lock lock(queue.mutex);
+        if (queue.tasks.empty())
+            return false;
+
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    bool trySteal(size_t index, Task& task) {
+        for (size_t i = 1; i < numQueues; i++) {
+            auto& queue = queues[(index + i) % numQueues];
+            std::unique_lock lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void worker(size_t index) {
+        currentWorker() = {this, index};
+
+        Task task;
         while (true) {
-            std::unique_lock lock(mutex);
-            taskAvailable.wait(lock, [this] { return !tasks.empty() || !running; });
-            if (!running)
-                break;
+            if (tryPop(index, task) || trySteal(index, task)) {
+                queuedTasks.fetch_sub(1);
+                task();
+                task = Task();
 
-            auto task = std::move(tasks.front());
-            tasks.pop_front();
-            ++currentTasks;
-            lock.unlock();
-            task();
-            lock.lock();
-            --currentTasks;
+                if (unfinishedTasks.fetch_sub(1) == 1) {
+                    std::unique_lock lock(doneMutex);
+                    taskDone.notify_all();
+                }
+                continue;
+            }
 
-            if (waiting && !currentTasks && tasks.empty())
-                taskDone.notify_all();
+            std::unique_lock lock(sleepMutex);
+            taskAvailable.wait(lock, [this] { return queuedTasks.load() > 0 || !running; });
+            if (!running)
+                break;
         }
     }
 
-    std::mutex mutex;
-    std::deque<std::function<void()>> tasks;
+    std::unique_ptr<WorkQueue[]> queues;
+    size_t numQueues = 0;
+    std::vector<std::thread> threads;
+
+    // The number of tasks sitting in queues. This can briefly go negative
+    // when a task is popped before its push has been counted.
+    std::atomic<int64_t> queuedTasks = 0;
+
+    // The number of tasks that have been pushed but haven't finished running.
+    std::atomic<size_t> unfinishedTasks = 0;
+    std::atomic<size_t> nextQueue = 0;
+
+    std::mutex sleepMutex;
     std::condition_variable taskAvailable;
+    bool running = true;
+
+    std::mutex doneMutex;
     std::condition_variable taskDone;
-    std::vector<std::thread> threads;
-    size_t currentTasks = 0;
-    bool running;
-    bool waiting;
 };
 
 } // namespace slang
@@ -56,6 +56,7 @@ def main():
         generatePyBindings(args.dir, alltypes)
     else:
         generateSyntaxClone(args.dir, alltypes, kindmap)
+        generateSyntaxDeserializer(args.dir, alltypes, kindmap)
         generateSyntax(args.dir, alltypes, kindmap)
         generateTokenKinds(ourdir, args.dir)
 
@@ -888,6 +889,99 @@ SyntaxNode* clone(const SyntaxNode& node, BumpAllocator& alloc) {
     )
 
 
+def generateSyntaxDeserializer(builddir, alltypes, kindmap):
+    outf = open(os.path.join(builddir, "SyntaxDeserialize.h"), "w")
+    outf.write(
+        """//------------------------------------------------------------------------------
+// SyntaxDeserialize.h
+// Generated reconstruction of syntax nodes from serialized data
+//
+// SPDX-FileCopyrightText: Michael Popoloski
+// SPDX-License-Identifier: MIT
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "slang/syntax/AllSyntax.h"
+
+// This file contains the generated code that reconstructs each kind of syntax node
+// from its serialized children, which are read in the same order they are returned
+// by getChild(). It is auto-generated by the syntax_gen.py script under the scripts/ directory.
+
+namespace slang::syntax::detail {
+
+template<typename TReader>
+SyntaxNode* deserializeSyntax(SyntaxKind kind, TReader& reader, BumpAllocator& alloc) {
+    switch (kind) {
+"""
+    )
+
+    kindsByType = {}
+    for k, v in sorted(kindmap.items()):
+        kindsByType.setdefault(v, []).append(k)
+
+    for name, kinds in sorted(kindsByType.items()):
+        v = alltypes[name]
+        if not v.final:
+            continue
+
+        for k in kinds[:-1]:
+            outf.write("        case SyntaxKind::{}:\n".format(k))
+        outf.write("        case SyntaxKind::{}: {{\n".format(kinds[-1]))
+
+        args = []
+        if "kind" in v.argNames:
+            args.append("kind")
+
+        # Children must be read in order, so pull each into a local
+        # before invoking the constructor.
+        for i, m in enumerate(v.combinedMembers):
+            local = "c{}".format(i)
+            args.append("*" + local if m[1] in v.notNullMembers else local)
+            if m[0] == "Token":
+                outf.write("            auto {} = reader.readToken();\n".format(local))
+            elif m[0] == "TokenList":
+                outf.write("            auto {} = reader.readTokenList();\n".format(local))
+            elif m[0].startswith("SyntaxList<"):
+                outf.write(
+                    "            auto {} = reader.template readList<{}>();\n".format(
+                        local, m[0][11:-1]
+                    )
+                )
+            elif m[0].startswith("SeparatedSyntaxList<"):
+                outf.write(
+                    "            auto {} = reader.template readSeparatedList<{}>();\n".format(
+                        local, m[0][20:-1]
+                    )
+                )
+            elif m[1] in v.notNullMembers:
+                # Required children that are missing mean the data is bad,
+                # so stop here and let the reader report the failure.
+                outf.write(
+                    "            auto {} = reader.template readNode<{}>();\n".format(
+                        local, m[0][9:-2]
+                    )
+                )
+                outf.write("            if (!{})\n".format(local))
+                outf.write("                return nullptr;\n")
+            else:
+                outf.write(
+                    "            auto {} = reader.template readNode<{}>();\n".format(
+                        local, m[0][:-1]
+                    )
+                )
+
+        outf.write(
+            "            return alloc.emplace<{}>({});\n".format(name, ", ".join(args))
+        )
+        outf.write("        }\n")
+
+    outf.write("        default:\n")
+    outf.write("            return nullptr;\n")
+    outf.write("    }\n")
+    outf.write("}\n\n")
+    outf.write("}\n")
+
+
 def loadkinds(ourdir, filename):
     kinds = []
     inf = open(os.path.join(ourdir, filename))
@@ -13,6 +13,7 @@
 
 #include "slang/ast/Definition.h"
 #include "slang/ast/ScriptSession.h"
+#include "slang/ast/SubroutineBytecode.h"
 #include "slang/ast/SystemSubroutine.h"
 #include "slang/ast/types/TypePrinter.h"
 #include "slang/diagnostics/DiagnosticEngine.h"
@@ -24,6 +25,7 @@
 #include "slang/syntax/SyntaxTree.h"
 #include "slang/text/CharInfo.h"
 #include "slang/text/SourceManager.h"
+#include "slang/util/Function.h"
 #include "slang/util/TimeTrace.h"
 
 using namespace slang::parsing;
@@ -47,6 +49,30 @@ const PackageSymbol& createStdPackage(Compilation&);
 
 namespace slang::ast {
 
+struct Compilation::Profiler {
+    struct Frame {
+        DefinitionProfile* profile;
+        std::chrono::steady_clock::time_point start;
+        size_t startBytes;
+        uint64_t startSteps;
+
+        // Inclusive costs of nested frames, which get
+        // subtracted out of this frame's own costs.
+        std::chrono::nanoseconds childTime{};
+        size_t childBytes = 0;
+        uint64_t childSteps = 0;
+    };
+
+    flat_hash_map<const Definition*, DefinitionProfile> profiles;
+    std::vector<Frame> stack;
+
+    DefinitionProfile& get(const Definition& definition) {
+        auto& result = profiles[&definition];
+        result.definition = &definition;
+        return result;
+    }
+};
+
 Compilation::Compilation(const Bag& options) :
     options(options.getOrDefault<CompilationOptions>()), driverMapAllocator(*this),
     unrollIntervalMapAllocator(*this), tempDiag({}, {}) {
@@ -253,6 +279,157 @@ std::span<const std::shared_ptr<SyntaxTree>> Compilation::getSyntaxTrees() const
     return syntaxTrees;
 }
 
+static void getDeclaredNames(const SyntaxNode& node, flat_hash_set<std::string_view>& names) {
+    switch (node.kind) {
+        case SyntaxKind::CompilationUnit:
+            for (auto member : node.as<CompilationUnitSyntax>().members)
+                getDeclaredNames(*member, names);
+            break;
+        case SyntaxKind::ModuleDeclaration:
+        case SyntaxKind::InterfaceDeclaration:
+        case SyntaxKind::ProgramDeclaration:
+        case SyntaxKind::PackageDeclaration:
+            names.emplace(node.as<ModuleDeclarationSyntax>().header->name.valueText());
+            break;
+        case SyntaxKind::ClassDeclaration:
+            names.emplace(node.as<ClassDeclarationSyntax>().name.valueText());
+            break;
+        case SyntaxKind::UdpDeclaration:
+            names.emplace(node.as<UdpDeclarationSyntax>().name.valueText());
+            break;
+        case SyntaxKind::CheckerDeclaration:
+            names.emplace(node.as<CheckerDeclarationSyntax>().name.valueText());
+            break;
+        default:
+            break;
+    }
+}
+
+static bool referencesAny(const ParserMetadata& meta,
+                          const flat_hash_set<std::string_view>& names) {
+    for (auto name : meta.globalInstances) {
+        if (names.contains(name))
+            return true;
+    }
+
+    for (auto import : meta.packageImports) {
+        for (auto item : import->items) {
+            if (names.contains(item->package.valueText()))
+                return true;
+        }
+    }
+
+    for (auto name : meta.classPackageNames) {
+        if (names.contains(name->identifier.valueText()))
+            return true;
+    }
+
+    for (auto port : meta.interfacePorts) {
+        if (names.contains(port->nameOrKeyword.valueText()))
+            return true;
+    }
+
+    return false;
+}
+
+std::vector<std::shared_ptr<SyntaxTree>> Compilation::getDependentSyntaxTrees(
+    const SyntaxTree& tree) const {
+
+    auto treeIt = std::ranges::find_if(syntaxTrees, [&](auto& t) { return t.get() == &tree; });
+    if (treeIt == syntaxTrees.end())
+        return {};
+
+    for (auto& t : syntaxTrees) {
+        auto& meta = t->getMetadata();
+        if (meta.hasDefparams || meta.hasBindDirectives)
+            return {syntaxTrees.begin(), syntaxTrees.end()};
+    }
+
+    std::vector<flat_hash_set<std::string_view>> declaredNames(syntaxTrees.size());
+    flat_hash_map<const SyntaxNode*, size_t> treeIndices;
+    for (size_t i = 0; i < syntaxTrees.size(); i++) {
+        getDeclaredNames(syntaxTrees[i]->root(), declaredNames[i]);
+        treeIndices.emplace(&syntaxTrees[i]->root(), i);
+    }
+
+    // Find the trees on both ends of each hierarchical reference by walking up
+    // from the symbols involved to the root of the syntax they were created from.
+    auto findTree = [&](const Symbol& symbol) -> std::optional<size_t> {
+        for (auto sym = &symbol; sym;) {
+            if (auto syntax = sym->getSyntax()) {
+                while (syntax->parent)
+                    syntax = syntax->parent;
+
+                if (auto it = treeIndices.find(syntax); it != treeIndices.end())
+                    return it->second;
+                return std::nullopt;
+            }
+
+            auto scope = sym->getParentScope();
+            sym = scope ? &scope->asSymbol() : nullptr;
+        }
+        return std::nullopt;
+    };
+
+    SmallVector<std::pair<size_t, size_t>> hierarchicalDeps;
+    for (auto& [source, target] : hierarchicalRefs) {
+        auto sourceTree = findTree(*source);
+        auto targetTree = findTree(*target);
+        if (sourceTree && targetTree && *sourceTree != *targetTree)
+            hierarchicalDeps.emplace_back(*sourceTree, *targetTree);
+    }
+
+    std::vector<size_t> indices;
+    flat_hash_set<size_t> visited;
+    auto add = [&](size_t index) {
+        if (visited.emplace(index).second)
+            indices.push_back(index);
+    };
+
+    auto addHierarchical = [&](size_t index) {
+        for (auto [source, target] : hierarchicalDeps) {
+            if (source == index)
+                add(target);
+            else if (target == index)
+                add(source);
+        }
+    };
+
+    // First walk upward from the changed tree, collecting every tree that refers
+    // to something declared in a tree we've already collected.
+    add(size_t(treeIt - syntaxTrees.begin()));
+    for (size_t i = 0; i < indices.size(); i++) {
+        auto& names = declaredNames[indices[i]];
+        if (!names.empty()) {
+            for (size_t j = 0; j < syntaxTrees.size(); j++) {
+                if (!visited.contains(j) && referencesAny(syntaxTrees[j]->getMetadata(), names))
+                    add(j);
+            }
+        }
+        addHierarchical(indices[i]);
+    }
+
+    // Then walk downward from all of those, since parameter values and port
+    // connections from an instantiation affect how the instantiated definition
+    // gets elaborated.
+    for (size_t i = 0; i < indices.size(); i++) {
+        auto& instances = syntaxTrees[indices[i]]->getMetadata().globalInstances;
+        for (size_t j = 0; j < syntaxTrees.size(); j++) {
+            if (!visited.contains(j) &&
+                std::ranges::any_of(instances,
+                                    [&](auto name) { return declaredNames[j].contains(name); })) {
+                add(j);
+            }
+        }
+        addHierarchical(indices[i]);
+    }
+
+    std::vector<std::shared_ptr<SyntaxTree>> results;
+    for (auto index : indices)
+        results.push_back(syntaxTrees[index]);
+    return results;
+}
+
 std::span<const CompilationUnitSymbol* const> Compilation::getCompilationUnits() const {
     return compilationUnits;
 }
@@ -977,6 +1154,42 @@ void Compilation::noteReference(const Symbol& symbol, bool isLValue) {
         noteReference(*syntax, isLValue);
 }
 
+void Compilation::noteHierarchicalReference(const Scope& scope, const Symbol& target) {
+    // Walks upward from the given symbol, collecting each instance body
+    // in the hierarchy that contains it (innermost first).
+    auto getBodies = [](const Symbol* symbol, SmallVector<const InstanceBodySymbol*>& results) {
+        while (symbol) {
+            if (symbol->kind == SymbolKind::InstanceBody) {
+                auto& body = symbol->as<InstanceBodySymbol>();
+                results.push_back(&body);
+                symbol = body.parentInstance;
+                if (!symbol)
+                    break;
+            }
+
+            auto parent = symbol->getParentScope();
+            symbol = parent ? &parent->asSymbol() : nullptr;
+        }
+    };
+
+    SmallVector<const InstanceBodySymbol*> sourceBodies;
+    SmallVector<const InstanceBodySymbol*> targetBodies;
+    getBodies(&scope.asSymbol(), sourceBodies);
+    getBodies(&target, targetBodies);
+
+    // Bodies that contain both ends of the reference are unaffected by it;
+    // everything below the common ancestor on either side is.
+    while (!sourceBodies.empty() && !targetBodies.empty() &&
+           sourceBodies.back() == targetBodies.back()) {
+        sourceBodies.pop_back();
+        targetBodies.pop_back();
+    }
+
+    hierarchicalRefBodies.insert(sourceBodies.begin(), sourceBodies.end());
+    hierarchicalRefBodies.insert(targetBodies.begin(), targetBodies.end());
+    hierarchicalRefs.emplace(&scope.asSymbol(), &target);
+}
+
 std::pair<bool, bool> Compilation::isReferenced(const SyntaxNode& node) const {
     auto it = referenceStatusMap.find(&node);
     if (it == referenceStatusMap.end())
@@ -1033,7 +1246,9 @@ const Diagnostics& Compilation::getSemanticDiagnostics() {
     // If we haven't already done so, touch every symbol, scope, statement,
     // and expression tree so that we can be sure we have all the diagnostics.
     uint32_t errorLimit = options.errorLimit == 0 ? UINT32_MAX : options.errorLimit;
-    DiagnosticVisitor elabVisitor(*this, numErrors, errorLimit);
+    DiagnosticVisitor elabVisitor(*this, numErrors, errorLimit,
+                                  !options.disableInstanceCaching &&
+                                      !options.buildReferenceIndex);
     getRoot().visit(elabVisitor);
 
     if (!elabVisitor.finishedEarly()) {
@@ -1161,7 +1376,7 @@ const Diagnostics& Compilation::getSemanticDiagnostics() {
             }
 
             if (!elabVisitor.hierarchyProblem && numErrors == 0) {
-                PostElabVisitor postElabVisitor(*this);
+                PostElabVisitor postElabVisitor(*this, elabVisitor.duplicateBodies);
                 getRoot().visit(postElabVisitor);
             }
         }
@@ -1208,10 +1423,12 @@ const Diagnostics& Compilation::getSemanticDiagnostics() {
             if (!symbol)
                 continue;
 
-            auto parent = symbol->as<InstanceBodySymbol>().parentInstance;
+            auto& body = symbol->as<InstanceBodySymbol>();
+            auto parent = body.parentInstance;
             SLANG_ASSERT(parent);
 
-            count++;
+            // Bodies that stood in for identical skipped ones count once per instance.
+            count += elabVisitor.getInstanceWeight(&body);
             if (auto scope = parent->getParentScope()) {
                 auto& sym = scope->asSymbol();
                 if (sym.kind != SymbolKind::Root && sym.kind != SymbolKind::CompilationUnit) {
@@ -1224,7 +1441,7 @@ const Diagnostics& Compilation::getSemanticDiagnostics() {
         // If the diagnostic is present in all instances, don't bother
         // providing specific instantiation info.
         if (found &&
-            elabVisitor.instanceCount[&inst->as<InstanceSymbol>().getDefinition()] > count) {
+            elabVisitor.getInstanceCount(inst->as<InstanceSymbol>().getDefinition()) > count) {
             Diagnostic diag = *found;
             diag.symbol = inst;
             diag.coalesceCount = count;
@@ -1262,6 +1479,266 @@ const Diagnostics& Compilation::getAllDiagnostics() {
     return *cachedAllDiagnostics;
 }
 
+void Compilation::enableProfiling() {
+    if (!profiler)
+        profiler = std::make_unique<Profiler>();
+}
+
+std::vector<DefinitionProfile> Compilation::getDefinitionProfiles() const {
+    std::vector<DefinitionProfile> results;
+    if (!profiler)
+        return results;
+
+    for (auto& [_, profile] : profiler->profiles)
+        results.push_back(profile);
+
+    std::ranges::sort(results, [](auto& a, auto& b) {
+        if (a.time != b.time)
+            return a.time > b.time;
+        return a.definition->name < b.definition->name;
+    });
+    return results;
+}
+
+std::span<const SymbolReference> Compilation::getReferences(const Symbol& symbol) const {
+    if (auto it = referenceIndex.find(&symbol); it != referenceIndex.end())
+        return it->second;
+    return {};
+}
+
+std::span<const InstanceSymbol* const> Compilation::getInstances(
+    const Definition& definition) const {
+    if (auto it = instanceIndex.find(&definition); it != instanceIndex.end())
+        return it->second;
+    return {};
+}
+
+void Compilation::noteSymbolReference(const Symbol& symbol, const Expression& expr,
+                                      const Scope& scope, bool isLValue) {
+    SLANG_ASSERT(options.buildReferenceIndex);
+    referenceIndex[&symbol].push_back({&expr, &scope, isLValue});
+}
+
+void Compilation::noteInstance(const InstanceSymbol& instance) {
+    SLANG_ASSERT(options.buildReferenceIndex);
+    instanceIndex[&instance.getDefinition()].push_back(&instance);
+}
+
+namespace {
+
+struct CallCacheScan;
+
+// Looks through the body of a function to see whether its results could depend
+// on anything other than its arguments, such as variables declared outside of it
+// or hierarchical references.
+struct CallCacheVisitor : public ASTVisitor<CallCacheVisitor, true, true> {
+    CallCacheScan& scan;
+    const SubroutineSymbol& subroutine;
+    bool cacheable = true;
+
+    // The lowest stack index of any function still being scanned
+    // that this one calls, directly or indirectly.
+    size_t lowLink = SIZE_MAX;
+
+    CallCacheVisitor(CallCacheScan& scan, const SubroutineSymbol& subroutine) :
+        scan(scan), subroutine(subroutine) {}
+
+    void handle(const NamedValueExpression& expr) {
+        switch (expr.symbol.kind) {
+            case SymbolKind::Parameter:
+            case SymbolKind::EnumValue:
+            case SymbolKind::Specparam:
+                return;
+            default:
+                break;
+        }
+
+        auto scope = expr.symbol.getParentScope();
+        while (scope) {
+            if (&scope->asSymbol() == &subroutine)
+                return;
+            scope = scope->asSymbol().getParentScope();
+        }
+        cacheable = false;
+    }
+
+    void handle(const HierarchicalValueExpression&) { cacheable = false; }
+    void handle(const ArbitrarySymbolExpression&) { cacheable = false; }
+
+    void handle(const CallExpression& expr);
+};
+
+// Works out which functions can have their results cached. Functions that call
+// each other recursively can only be cached if all of them can, so the functions
+// being scanned are kept on a stack, and results are only committed once a whole
+// strongly connected group of calls has been scanned (as in Tarjan's algorithm).
+struct CallCacheScan {
+    function_ref<std::optional<bool>(const SubroutineSymbol&)> lookup;
+    function_ref<void(const SubroutineSymbol&, bool)> commit;
+    SmallVector<const SubroutineSymbol*> stack;
+    flat_hash_map<const SubroutineSymbol*, size_t> stackIndices;
+
+    CallCacheScan(function_ref<std::optional<bool>(const SubroutineSymbol&)> lookup,
+                  function_ref<void(const SubroutineSymbol&, bool)> commit) :
+        lookup(lookup), commit(commit) {}
+
+    // Returns whether the function can be cached so far, along with the lowest
+    // stack index of any function still being scanned that it calls.
+    std::pair<bool, size_t> scan(const SubroutineSymbol& subroutine) {
+        if (auto result = lookup(subroutine))
+            return {*result, SIZE_MAX};
+
+        // A function further up the stack will decide this one
+        // along with the rest of its group.
+        if (auto it = stackIndices.find(&subroutine); it != stackIndices.end())
+            return {true, it->second};
+
+        const size_t index = stack.size();
+        stack.push_back(&subroutine);
+        stackIndices.emplace(&subroutine, index);
+
+        CallCacheVisitor visitor(*this, subroutine);
+        subroutine.getBody().visit(visitor);
+
+        // If this function is the first of its group to be scanned, every function
+        // above it on the stack is part of the group (or calls into it) and shares
+        // its result. A function that can't be cached makes its whole group, and
+        // anything that calls it, uncacheable, so that can be committed right away.
+        if (!visitor.cacheable || visitor.lowLink >= index) {
+            for (size_t i = index; i < stack.size(); i++) {
+                commit(*stack[i], visitor.cacheable);
+                stackIndices.erase(stack[i]);
+            }
+            stack.resize(index);
+            return {visitor.cacheable, SIZE_MAX};
+        }
+
+        return {true, visitor.lowLink};
+    }
+};
+
+void CallCacheVisitor::handle(const CallExpression& expr) {
+    if (!expr.isSystemCall()) {
+        auto [result, low] = scan.scan(*std::get<0>(expr.subroutine));
+        lowLink = std::min(lowLink, low);
+        if (!result) {
+            cacheable = false;
+            return;
+        }
+    }
+    visitDefault(expr);
+}
+
+} // namespace
+
+bool Compilation::canCacheCallResults(const SubroutineSymbol& subroutine) {
+    auto lookup = [this](const SubroutineSymbol& sub) -> std::optional<bool> {
+        std::unique_lock lock(functionCacheMutex);
+        if (auto it = cacheableFunctions.find(&sub); it != cacheableFunctions.end())
+            return it->second;
+        return std::nullopt;
+    };
+
+    auto commit = [this](const SubroutineSymbol& sub, bool cacheable) {
+        std::unique_lock lock(functionCacheMutex);
+        cacheableFunctions.emplace(&sub, cacheable);
+    };
+
+    // The lock isn't held while scanning, since looking at function
+    // bodies can end up evaluating other constant function calls.
+    CallCacheScan scan(lookup, commit);
+    return scan.scan(subroutine).first;
+}
+
+static size_t hashCallArgs(std::span<const ConstantValue> args) {
+    size_t h = args.size();
+    for (auto& arg : args)
+        hash_combine(h, arg.hash());
+    return h;
+}
+
+std::optional<ConstantValue> Compilation::findCachedCallResult(
+    const SubroutineSymbol& subroutine, std::span<const ConstantValue> args) {
+    const auto key = std::make_tuple(&subroutine, hashCallArgs(args));
+
+    std::unique_lock lock(functionCacheMutex);
+    auto it = callResultCache.find(key);
+    if (it != callResultCache.end()) {
+        for (auto& entry : it->second) {
+            if (std::ranges::equal(entry.args, args)) {
+                functionCacheStats.hits++;
+                return entry.result;
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+void Compilation::cacheCallResult(const SubroutineSymbol& subroutine,
+                                  std::span<const ConstantValue> args,
+                                  const ConstantValue& result) {
+    const auto key = std::make_tuple(&subroutine, hashCallArgs(args));
+
+    std::unique_lock lock(functionCacheMutex);
+    functionCacheStats.misses++;
+
+    auto& bucket = callResultCache[key];
+    bucket.push_back({std::vector<ConstantValue>(args.begin(), args.end()), result});
+}
+
+const SubroutineBytecode* Compilation::getSubroutineBytecode(const SubroutineSymbol& subroutine) {
+    if (!options.enableBytecodeEval)
+        return nullptr;
+
+    {
+        std::unique_lock lock(bytecodeMutex);
+        if (auto it = subroutineBytecode.find(&subroutine); it != subroutineBytecode.end())
+            return it->second.get();
+    }
+
+    // Lower outside of the lock; if another thread got there first we
+    // keep its result and discard ours.
+    auto result = SubroutineBytecode::lower(subroutine);
+
+    std::unique_lock lock(bytecodeMutex);
+    auto [it, inserted] = subroutineBytecode.emplace(&subroutine, std::move(result));
+    return it->second.get();
+}
+
+void Compilation::noteProfiledInstance(const Definition& definition) {
+    SLANG_ASSERT(profiler);
+    profiler->get(definition).instances++;
+}
+
+void Compilation::beginDefinitionProfile(const Definition& definition) {
+    SLANG_ASSERT(profiler);
+    profiler->stack.push_back({&profiler->get(definition), std::chrono::steady_clock::now(),
+                               getBytesAllocated(), getConstEvalSteps()});
+}
+
+void Compilation::endDefinitionProfile() {
+    SLANG_ASSERT(profiler && !profiler->stack.empty());
+    auto frame = profiler->stack.back();
+    profiler->stack.pop_back();
+
+    auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - frame.start);
+    auto bytes = getBytesAllocated() - frame.startBytes;
+    auto steps = getConstEvalSteps() - frame.startSteps;
+
+    auto& profile = *frame.profile;
+    profile.time += time - frame.childTime;
+    profile.allocatedBytes += bytes - frame.childBytes;
+    profile.constEvalSteps += steps - frame.childSteps;
+
+    if (!profiler->stack.empty()) {
+        auto& parent = profiler->stack.back();
+        parent.childTime += time;
+        parent.childBytes += bytes;
+        parent.childSteps += steps;
+    }
+}
+
 void Compilation::addDiagnostics(const Diagnostics& diagnostics) {
     for (auto& diag : diagnostics)
         addDiag(diag);
@@ -1316,7 +1793,8 @@ const ImplicitTypeSyntax& Compilation::createEmptyTypeSyntax(SourceLocation loc)
 
 void Compilation::forceElaborate(const Symbol& symbol) {
     DiagnosticVisitor visitor(*this, numErrors,
-                              options.errorLimit == 0 ? UINT32_MAX : options.errorLimit);
+                              options.errorLimit == 0 ? UINT32_MAX : options.errorLimit,
+                              /* allowCaching */ false);
     symbol.visit(visitor);
 }
 
@@ -18,9 +18,17 @@ using namespace syntax;
 
 // This visitor is used to touch every node in the AST to ensure that all lazily
 // evaluated members have been realized and we have recorded every diagnostic.
+//
+// Note that this visitation must run on a single thread: realizing lazy members
+// allocates from the compilation's allocators, inserts into its shared lookup and
+// diagnostic maps, and can create new instance bodies and class specializations
+// anywhere in the design (e.g. via hierarchical references or upward name lookups),
+// so instance subtrees are not actually disjoint from each other.
 struct DiagnosticVisitor : public ASTVisitor<DiagnosticVisitor, false, false> {
-    DiagnosticVisitor(Compilation& compilation, const size_t& numErrors, uint32_t errorLimit) :
-        compilation(compilation), numErrors(numErrors), errorLimit(errorLimit) {}
+    DiagnosticVisitor(Compilation& compilation, const size_t& numErrors, uint32_t errorLimit,
+                      bool allowCaching) :
+        compilation(compilation),
+        numErrors(numErrors), errorLimit(errorLimit), allowCaching(allowCaching) {}
 
     bool finishedEarly() const { return numErrors > errorLimit || hierarchyProblem; }
 
@@ -264,7 +272,9 @@ struct DiagnosticVisitor : public ASTVisitor<DiagnosticVisitor, false, false> {
             return buffer;
         });
 
-        instanceCount[&symbol.getDefinition()]++;
+        instanceCount[std::tuple{&symbol.getDefinition(), getContainingBody(symbol)}]++;
+        if (compilation.getOptions().buildReferenceIndex)
+            compilation.noteInstance(symbol);
 
         for (auto attr : compilation.getAttributes(symbol))
             attr->getValue();
@@ -276,6 +286,18 @@ struct DiagnosticVisitor : public ASTVisitor<DiagnosticVisitor, false, false> {
                 attr->getValue();
         };
 
+        // Port connections belong to the parent; everything from here on
+        // is attributed to this instance's definition when profiling.
+        const bool profiling = compilation.isProfilingEnabled();
+        if (profiling) {
+            compilation.noteProfiledInstance(symbol.getDefinition());
+            compilation.beginDefinitionProfile(symbol.getDefinition());
+        }
+        auto profileGuard = ScopeGuard([this, profiling] {
+            if (profiling)
+                compilation.endDefinitionProfile();
+        });
+
         // Detect infinite recursion, which happens if we see this exact
         // instance body somewhere higher up in the stack.
         if (!activeInstanceBodies.emplace(&symbol.body).second) {
@@ -298,6 +320,13 @@ struct DiagnosticVisitor : public ASTVisitor<DiagnosticVisitor, false, false> {
             return;
         }
 
+        // If we've already visited an identical body there's no need to
+        // visit this one; it would just produce the same set of diagnostics.
+        if (auto canonical = findCanonicalBody(symbol.body)) {
+            duplicateBodies.emplace(&symbol.body, canonical);
+            return;
+        }
+
         visit(symbol.body);
     }
 
@@ -382,6 +411,26 @@ struct DiagnosticVisitor : public ASTVisitor<DiagnosticVisitor, false, false> {
     }
 
     void finalize() {
+        // Hierarchical references that we saw after skipping a duplicate instance
+        // body might have made that body (or its canonical version) depend on its
+        // location in the hierarchy, in which case we need to go back and visit it.
+        // Visiting such a body can in turn uncover more of them.
+        SmallVector<const InstanceBodySymbol*> toRevisit;
+        do {
+            toRevisit.clear();
+            for (auto [body, canonical] : duplicateBodies) {
+                if (compilation.hasHierarchicalReferences(*body) ||
+                    compilation.hasHierarchicalReferences(*canonical)) {
+                    toRevisit.push_back(body);
+                }
+            }
+
+            for (auto body : toRevisit) {
+                duplicateBodies.erase(body);
+                body->visit(*this);
+            }
+        } while (!toRevisit.empty() && !finishedEarly());
+
         // Once everything has been visited, go back over and check things that might
         // have been influenced by visiting later symbols. Unfortunately visiting
         // a specialization can trigger more specializations to be made for the
@@ -415,11 +464,56 @@ struct DiagnosticVisitor : public ASTVisitor<DiagnosticVisitor, false, false> {
         }
     }
 
+    // Gets the number of instances in the design that are represented by the
+    // given (visited) instance body, which can be more than one if identical
+    // bodies were skipped here or anywhere higher up in the hierarchy.
+    size_t getInstanceWeight(const InstanceBodySymbol* body) {
+        if (!body)
+            return 1;
+
+        if (auto it = instanceWeights.find(body); it != instanceWeights.end())
+            return it->second;
+
+        if (duplicateBodies.empty())
+            return 1;
+
+        if (canonicalUsers.empty()) {
+            for (auto [dup, canonical] : duplicateBodies)
+                canonicalUsers[canonical].push_back(dup);
+        }
+
+        size_t weight = getInstanceWeight(getContainingBody(body));
+        if (auto it = canonicalUsers.find(body); it != canonicalUsers.end()) {
+            for (auto dup : it->second)
+                weight += getInstanceWeight(getContainingBody(dup));
+        }
+
+        instanceWeights.emplace(body, weight);
+        return weight;
+    }
+
+    // Gets the total number of instances of the given definition in the design.
+    // The totals for all definitions are worked out on the first call, so this
+    // should only be called once visiting is done.
+    size_t getInstanceCount(const Definition& definition) {
+        if (instanceTotals.empty()) {
+            for (auto& [key, numVisited] : instanceCount) {
+                auto [def, body] = key;
+                instanceTotals[def] += numVisited * getInstanceWeight(body);
+            }
+        }
+
+        if (auto it = instanceTotals.find(&definition); it != instanceTotals.end())
+            return it->second;
+        return 0;
+    }
+
     Compilation& compilation;
     const size_t& numErrors;
     uint32_t errorLimit;
+    bool allowCaching;
     bool hierarchyProblem = false;
-    flat_hash_map<const Definition*, size_t> instanceCount;
+    flat_hash_map<std::tuple<const Definition*, const InstanceBodySymbol*>, size_t> instanceCount;
     flat_hash_set<const InstanceBodySymbol*> activeInstanceBodies;
     flat_hash_set<const Definition*> usedIfacePorts;
     SmallVector<const GenericClassDefSymbol*> genericClasses;
@@ -427,6 +521,71 @@ struct DiagnosticVisitor : public ASTVisitor<DiagnosticVisitor, false, false> {
     SmallVector<const MethodPrototypeSymbol*> externIfaceProtos;
     SmallVector<std::pair<const InterfacePortSymbol*, const ModportSymbol*>> modportsWithExports;
     TimingPathMap timingPathMap;
+
+    // A map of instance bodies that were skipped because they are identical to
+    // an already visited body, to that canonical body.
+    flat_hash_map<const InstanceBodySymbol*, const InstanceBodySymbol*> duplicateBodies;
+
+private:
+    static const InstanceBodySymbol* getContainingBody(const Symbol& symbol) {
+        auto scope = symbol.getParentScope();
+        while (scope) {
+            auto& sym = scope->asSymbol();
+            if (sym.kind == SymbolKind::InstanceBody)
+                return &sym.as<InstanceBodySymbol>();
+            scope = sym.getParentScope();
+        }
+        return nullptr;
+    }
+
+    static const InstanceBodySymbol* getContainingBody(const InstanceBodySymbol* body) {
+        return body->parentInstance ? getContainingBody(*body->parentInstance) : nullptr;
+    }
+
+    // Finds a previously visited body that is identical to the given one,
+    // or registers the given body as a new candidate for later instances.
+    const InstanceBodySymbol* findCanonicalBody(const InstanceBodySymbol& body) {
+        // Overrides from defparams and binds apply to individual instances, and
+        // interface port connections can change the meaning of the body's members.
+        if (!allowCaching || body.isUninstantiated || body.isFromBind ||
+            body.hierarchyOverrideNode || !body.getDefinition().bindDirectives.empty()) {
+            return nullptr;
+        }
+
+        for (auto port : body.getPortList()) {
+            if (port->kind == SymbolKind::InterfacePort)
+                return nullptr;
+        }
+
+        // Type parameters aren't hashed; they get compared in hasSameType.
+        size_t hash = 0;
+        hash_combine(hash, &body.getDefinition());
+        for (auto param : body.parameters) {
+            if (param->symbol.kind == SymbolKind::Parameter)
+                hash_combine(hash, param->symbol.as<ParameterSymbol>().getValue().hash());
+        }
+
+        // Evaluating parameter values can resolve hierarchical references,
+        // so check for them only after computing the hash.
+        if (compilation.hasHierarchicalReferences(body))
+            return nullptr;
+
+        auto& candidates = bodyCache[hash];
+        for (auto candidate : candidates) {
+            if (!activeInstanceBodies.contains(candidate) &&
+                !compilation.hasHierarchicalReferences(*candidate) && candidate->hasSameType(body)) {
+                return candidate;
+            }
+        }
+
+        candidates.push_back(&body);
+        return nullptr;
+    }
+
+    flat_hash_map<size_t, SmallVector<const InstanceBodySymbol*, 2>> bodyCache;
+    flat_hash_map<const InstanceBodySymbol*, SmallVector<const InstanceBodySymbol*>> canonicalUsers;
+    flat_hash_map<const InstanceBodySymbol*, size_t> instanceWeights;
+    flat_hash_map<const Definition*, size_t> instanceTotals;
 };
 
 // This visitor is for finding all defparam directives in the hierarchy.
@@ -536,7 +695,17 @@ struct DefParamVisitor : public ASTVisitor<DefParamVisitor, false, false> {
 // This visitor runs post-elaboration and can be used to find and report on
 // things like unused code elements.
 struct PostElabVisitor : public ASTVisitor<PostElabVisitor, false, false> {
-    explicit PostElabVisitor(Compilation& compilation) : compilation(compilation) {}
+    PostElabVisitor(Compilation& compilation,
+                    const flat_hash_map<const InstanceBodySymbol*, const InstanceBodySymbol*>&
+                        duplicateBodies) :
+        compilation(compilation),
+        duplicateBodies(duplicateBodies) {}
+
+    void handle(const InstanceSymbol& symbol) {
+        // Bodies identical to an already checked one would only produce the same warnings.
+        if (!duplicateBodies.contains(&symbol.body))
+            visitDefault(symbol);
+    }
 
     void handle(const NetSymbol& symbol) {
         if (symbol.isImplicit) {
@@ -729,6 +898,7 @@ private:
     }
 
     Compilation& compilation;
+    const flat_hash_map<const InstanceBodySymbol*, const InstanceBodySymbol*>& duplicateBodies;
 };
 
 } // namespace slang::ast
@@ -17,10 +17,25 @@
 
 namespace slang::ast {
 
+EvalContext::LocalSlot* EvalContext::Frame::findSlot(const ValueSymbol* symbol) const {
+    if (!index.empty()) {
+        auto it = index.find(symbol);
+        return it == index.end() ? nullptr : it->second;
+    }
+
+    for (auto slot : temporaries) {
+        if (slot->symbol == symbol)
+            return slot;
+    }
+    return nullptr;
+}
+
 void EvalContext::reset() {
     steps = 0;
     disableTarget = nullptr;
     queueTarget = nullptr;
+    for (auto& frame : stack)
+        freeSlots(frame);
     stack.clear();
     lvalStack.clear();
     diags.clear();
@@ -31,7 +46,23 @@ void EvalContext::reset() {
 
 ConstantValue* EvalContext::createLocal(const ValueSymbol* symbol, ConstantValue value) {
     SLANG_ASSERT(!stack.empty());
-    ConstantValue& result = stack.back().temporaries[symbol];
+    auto& frame = stack.back();
+    auto slot = frame.findSlot(symbol);
+    if (!slot) {
+        slot = allocSlot();
+        slot->symbol = symbol;
+        frame.temporaries.push_back(slot);
+
+        if (!frame.index.empty()) {
+            frame.index.emplace(symbol, slot);
+        }
+        else if (frame.temporaries.size() > Frame::IndexThreshold) {
+            for (auto s : frame.temporaries)
+                frame.index.emplace(s->symbol, s);
+        }
+    }
+
+    ConstantValue& result = slot->value;
     if (!value) {
         result = symbol->getType().getDefaultValue();
     }
@@ -49,18 +80,24 @@ ConstantValue* EvalContext::findLocal(const ValueSymbol* symbol) {
     if (stack.empty())
         return nullptr;
 
-    auto& frame = stack.back();
-    auto it = frame.temporaries.find(symbol);
-    if (it == frame.temporaries.end())
-        return nullptr;
-    return &it->second;
+    auto slot = stack.back().findSlot(symbol);
+    return slot ? &slot->value : nullptr;
 }
 
 void EvalContext::deleteLocal(const ValueSymbol* symbol) {
-    if (!stack.empty()) {
-        auto& frame = stack.back();
-        frame.temporaries.erase(symbol);
-    }
+    if (stack.empty())
+        return;
+
+    auto& frame = stack.back();
+    auto slot = frame.findSlot(symbol);
+    if (!slot)
+        return;
+
+    frame.temporaries.erase(std::ranges::find(frame.temporaries, slot));
+    frame.index.erase(symbol);
+
+    slot->value = nullptr;
+    freeSlotList.push_back(slot);
 }
 
 bool EvalContext::pushFrame(const SubroutineSymbol& subroutine, SourceLocation callLocation,
@@ -84,9 +121,33 @@ void EvalContext::pushEmptyFrame() {
 }
 
 void EvalContext::popFrame() {
+    freeSlots(stack.back());
     stack.pop_back();
 }
 
+EvalContext::LocalSlot* EvalContext::allocSlot() {
+    if (freeSlotList.empty()) {
+        // Blocks double in size, up to a limit.
+        const size_t blockSize = size_t(8) << std::min(slotBlocks.size(), size_t(5));
+        auto& block = slotBlocks.emplace_back(std::make_unique<LocalSlot[]>(blockSize));
+        for (size_t i = blockSize; i > 0; i--)
+            freeSlotList.push_back(&block[i - 1]);
+    }
+
+    auto slot = freeSlotList.back();
+    freeSlotList.pop_back();
+    return slot;
+}
+
+void EvalContext::freeSlots(Frame& frame) {
+    for (auto slot : frame.temporaries) {
+        slot->value = nullptr;
+        freeSlotList.push_back(slot);
+    }
+    frame.temporaries.clear();
+    frame.index.clear();
+}
+
 void EvalContext::pushLValue(LValue& lval) {
     lvalStack.push_back(&lval);
 }
@@ -103,7 +164,9 @@ LValue* EvalContext::getTopLValue() const {
 }
 
 bool EvalContext::step(SourceLocation loc) {
-    if (++steps < getCompilation().getOptions().maxConstexprSteps)
+    auto& comp = getCompilation();
+    comp.noteConstEvalStep();
+    if (++steps < comp.getOptions().maxConstexprSteps)
         return true;
 
     addDiag(diag::ConstEvalExceededMaxSteps, loc);
@@ -115,8 +178,8 @@ std::string EvalContext::dumpStack() const {
     int index = 0;
     for (const Frame& frame : stack) {
         buffer.format("{}: {}\n", index++, frame.subroutine ? frame.subroutine->name : "<global>");
-        for (auto& [symbol, value] : frame.temporaries)
-            buffer.format("    {} = {}\n", symbol->name, value.toString());
+        for (auto slot : frame.temporaries)
+            buffer.format("    {} = {}\n", slot->symbol->name, slot->value.toString());
     }
     return buffer.str();
 }
@@ -171,10 +234,10 @@ static void reportFrame(Diagnostic& diag, const EvalContext::Frame& frame) {
     buffer.format("{}(", frame.subroutine->name);
 
     for (auto arg : frame.subroutine->getArguments()) {
-        auto it = frame.temporaries.find(arg);
-        SLANG_ASSERT(it != frame.temporaries.end());
+        auto slot = frame.findSlot(arg);
+        SLANG_ASSERT(slot);
 
-        buffer.append(it->second.toString());
+        buffer.append(slot->value.toString());
         if (arg != frame.subroutine->getArguments().last(1)[0])
             buffer.append(", ");
     }
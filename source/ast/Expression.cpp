@@ -1333,7 +1333,11 @@ Expression* Expression::tryBindInterfaceRef(const ASTContext& context,
         origSymbol = origSymbol->as<InstanceBodySymbol>().parentInstance;
     }
 
-    return comp.emplace<ArbitrarySymbolExpression>(*origSymbol, *type, sourceRange);
+    auto ifaceExpr = comp.emplace<ArbitrarySymbolExpression>(*origSymbol, *type, sourceRange);
+    if (comp.getOptions().buildReferenceIndex)
+        comp.noteSymbolReference(*origSymbol, *ifaceExpr, *context.scope, /* isLValue */ false);
+
+    return ifaceExpr;
 }
 
 void Expression::findPotentiallyImplicitNets(
@@ -976,6 +976,8 @@ void Lookup::name(const NameSyntax& syntax, const ASTContext& context, bitmask<L
             // Handle qualified names separately.
             qualified(syntax.as<ScopedNameSyntax>(), context, flags, result);
             unwrapResult(scope, syntax.sourceRange(), result);
+            if (result.found && result.isHierarchical)
+                scope.getCompilation().noteHierarchicalReference(scope, *result.found);
             if (flags.has(LookupFlags::NoSelectors))
                 result.errorIfSelectors(context);
             return;
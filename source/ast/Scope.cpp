@@ -56,8 +56,10 @@ using namespace syntax;
 
 static size_t countMembers(const SyntaxNode& syntax);
 
+const SymbolMap Scope::emptyNameMap;
+
 Scope::Scope(Compilation& compilation_, const Symbol* thisSym_) :
-    compilation(compilation_), thisSym(thisSym_), nameMap(compilation.allocSymbolMap()) {
+    compilation(compilation_), thisSym(thisSym_) {
 }
 
 const NetType& Scope::getDefaultNetType() const {
@@ -551,9 +553,9 @@ void Scope::addMembers(const SyntaxNode& syntax) {
 
 const Symbol* Scope::find(std::string_view name) const {
     // Just do a simple lookup and return the result if we have one.
-    ensureElaborated();
-    auto it = nameMap->find(name);
-    if (it == nameMap->end())
+    auto& map = getNameMap();
+    auto it = map.find(name);
+    if (it == map.end())
         return nullptr;
 
     // Unwrap the symbol if it's a transparent member. Don't return imported
@@ -616,6 +618,16 @@ static bool canLookupByName(SymbolKind kind) {
     }
 }
 
+void Scope::reserveMembers(size_t count) const {
+    ensureNameMap();
+    nameMap->reserve(nameMap->size() + count);
+}
+
+void Scope::ensureNameMap() const {
+    if (!nameMap)
+        nameMap = compilation.allocSymbolMap();
+}
+
 void Scope::insertMember(const Symbol* member, const Symbol* at, bool isElaborating,
                          bool incrementIndex) const {
     SLANG_ASSERT(!member->parentScope);
@@ -637,6 +649,9 @@ void Scope::insertMember(const Symbol* member, const Symbol* at, bool isElaborat
     // Add to the name map if the symbol has a name and can be looked up
     // by name in the default namespace.
     if (!member->name.empty() && canLookupByName(member->kind)) {
+        if (!nameMap)
+            nameMap = compilation.allocSymbolMap();
+
         auto pair = nameMap->emplace(member->name, member);
         if (!pair.second)
             handleNameConflict(*member, pair.first->second, isElaborating);
@@ -823,6 +838,11 @@ void Scope::elaborate() const {
         });
     }
 
+    const bool profiling = thisSym->kind == SymbolKind::InstanceBody &&
+                           compilation.isProfilingEnabled();
+    if (profiling)
+        compilation.beginDefinitionProfile(thisSym->as<InstanceBodySymbol>().getDefinition());
+
     SLANG_ASSERT(deferredMemberIndex != DeferredMemberIndex::Invalid);
     auto deferredData = compilation.getOrAddDeferredData(deferredMemberIndex);
     deferredMemberIndex = DeferredMemberIndex::Invalid;
@@ -1205,6 +1225,8 @@ void Scope::elaborate() const {
     SLANG_ASSERT(deferredMemberIndex == DeferredMemberIndex::Invalid);
     if (thisSym->kind == SymbolKind::InstanceBody && TimeTrace::isEnabled())
         TimeTrace::endTrace();
+    if (profiling)
+        compilation.endDefinitionProfile();
 }
 
 static std::string_view getIdentifierName(const NamedTypeSyntax& syntax) {
@@ -1390,7 +1412,7 @@ void Scope::handleExportedMethods(std::span<Symbol* const> deferredMembers) cons
                             if (isExport) {
                                 auto& mnps = subPort->as<ModportNamedPortSyntax>();
                                 auto name = mnps.name.valueText();
-                                if (name.empty() || nameMap->find(name) != nameMap->end())
+                                if (name.empty() || getUnelaboratedNameMap().contains(name))
                                     break;
 
                                 if (auto it = foundImports.find(name); it != foundImports.end())
@@ -1406,7 +1428,7 @@ void Scope::handleExportedMethods(std::span<Symbol* const> deferredMembers) cons
                             // export is waiting for it to be declared.
                             auto& msps = subPort->as<ModportSubroutinePortSyntax>();
                             auto name = msps.prototype->name->getLastToken().valueText();
-                            if (name.empty() || nameMap->find(name) != nameMap->end())
+                            if (name.empty() || getUnelaboratedNameMap().contains(name))
                                 break;
 
                             if (isExport) {
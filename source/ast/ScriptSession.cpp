@@ -19,14 +19,17 @@ namespace slang::ast {
 
 using namespace syntax;
 
-static CompilationOptions createOptions() {
-    CompilationOptions options;
+static Bag createOptions(const Bag& bag) {
+    auto options = bag.getOrDefault<CompilationOptions>();
     options.allowHierarchicalConst = true;
-    return options;
+
+    Bag result = bag;
+    result.set(options);
+    return result;
 }
 
-ScriptSession::ScriptSession() :
-    compilation(createOptions()), scope(compilation.createScriptScope()),
+ScriptSession::ScriptSession(const Bag& options) :
+    compilation(createOptions(options)), scope(compilation.createScriptScope()),
     astCtx(scope, LookupLocation::max), evalContext(astCtx, EvalFlags::IsScript) {
     evalContext.pushEmptyFrame();
 }
@@ -7,14 +7,17 @@
 //------------------------------------------------------------------------------
 #include "slang/ast/SemanticModel.h"
 
+#include "slang/ast/ASTVisitor.h"
 #include "slang/ast/Compilation.h"
 #include "slang/syntax/AllSyntax.h"
+#include "slang/text/SourceManager.h"
 
 namespace slang::ast {
 
 using namespace syntax;
 
-SemanticModel::SemanticModel(Compilation& compilation) : compilation(compilation) {
+SemanticModel::SemanticModel(Compilation& compilation) :
+    compilation(compilation), symbolMapAlloc(indexAlloc), exprMapAlloc(indexAlloc) {
 }
 
 void SemanticModel::withContext(const SyntaxNode& node, const Symbol& symbol) {
@@ -123,4 +126,150 @@ const TypeAliasType* SemanticModel::getDeclaredSymbol(const TypedefDeclarationSy
     return result ? &result->as<TypeAliasType>() : nullptr;
 }
 
+struct SemanticModel::LocationVisitor : public ASTVisitor<LocationVisitor, true, true> {
+    SemanticModel& model;
+    const SourceManager& sourceManager;
+    flat_hash_set<const SyntaxNode*> visitedBodies;
+
+    LocationVisitor(SemanticModel& model, const SourceManager& sourceManager) :
+        model(model), sourceManager(sourceManager) {}
+
+    template<typename T>
+    void handle(const T& t) {
+        if constexpr (std::is_base_of_v<Symbol, T>) {
+            if (auto syntax = t.getSyntax()) {
+                // Every instance of a module shares the same body syntax;
+                // only bother indexing the first one we see.
+                if constexpr (std::is_same_v<T, InstanceBodySymbol>) {
+                    if (!visitedBodies.emplace(syntax).second)
+                        return;
+                }
+                add(syntax->sourceRange(), &t, nullptr);
+            }
+        }
+        else if constexpr (std::is_base_of_v<Expression, T>) {
+            if constexpr (std::is_same_v<T, ConversionExpression>) {
+                if (!t.isImplicit())
+                    add(t.sourceRange, nullptr, &t);
+            }
+            else {
+                add(t.sourceRange, nullptr, &t);
+            }
+        }
+        visitDefault(t);
+    }
+
+    void add(SourceRange range, const Symbol* symbol, const Expression* expr) {
+        auto start = sourceManager.getFullyExpandedLoc(range.start());
+        auto end = sourceManager.getFullyExpandedLoc(range.end());
+        if (!start.buffer() || start.buffer() != end.buffer() || end < start)
+            return;
+
+        // Source ranges are half open but the index uses closed intervals.
+        auto left = uint32_t(start.offset());
+        auto right = end.offset() > start.offset() ? uint32_t(end.offset() - 1) : left;
+        model.pendingEntries[start.buffer()].push_back({left, right, symbol, expr});
+    }
+};
+
+void SemanticModel::collectLocations() {
+    locationsCollected = true;
+
+    auto sm = compilation.getSourceManager();
+    if (!sm)
+        return;
+
+    LocationVisitor visitor(*this, *sm);
+    compilation.getRoot().visit(visitor);
+}
+
+const SemanticModel::BufferIndex* SemanticModel::getIndex(BufferID buffer) {
+    if (!locationsCollected)
+        collectLocations();
+
+    if (auto it = bufferIndices.find(buffer); it != bufferIndices.end())
+        return it->second.get();
+
+    auto it = pendingEntries.find(buffer);
+    if (it == pendingEntries.end())
+        return nullptr;
+
+    auto index = std::make_unique<BufferIndex>();
+    for (auto& entry : it->second) {
+        if (entry.symbol)
+            index->symbols.insert(entry.left, entry.right, entry.symbol, symbolMapAlloc);
+        else
+            index->expressions.insert(entry.left, entry.right, entry.expr, exprMapAlloc);
+    }
+    pendingEntries.erase(it);
+
+    auto result = index.get();
+    bufferIndices.emplace(buffer, std::move(index));
+    return result;
+}
+
+template<typename T>
+static const T* findInnermost(const IntervalMap<uint32_t, const T*>& map, uint32_t offset) {
+    // Ranges in the AST are properly nested, so the narrowest
+    // interval containing the offset is the innermost node.
+    const T* result = nullptr;
+    uint32_t bestWidth = UINT32_MAX;
+    for (auto it = map.find(offset, offset); it != map.end(); ++it) {
+        auto [left, right] = it.bounds();
+        if (right - left < bestWidth) {
+            bestWidth = right - left;
+            result = *it;
+        }
+    }
+    return result;
+}
+
+const Symbol* SemanticModel::getSymbolAt(SourceLocation location) {
+    auto index = getIndex(location.buffer());
+    if (!index)
+        return nullptr;
+
+    return findInnermost(index->symbols, uint32_t(location.offset()));
+}
+
+const Expression* SemanticModel::getExpressionAt(SourceLocation location) {
+    auto index = getIndex(location.buffer());
+    if (!index)
+        return nullptr;
+
+    return findInnermost(index->expressions, uint32_t(location.offset()));
+}
+
+const Symbol* SemanticModel::getReferencedSymbolAt(SourceLocation location) {
+    if (auto expr = getExpressionAt(location)) {
+        switch (expr->kind) {
+            case ExpressionKind::NamedValue:
+            case ExpressionKind::HierarchicalValue:
+                return &expr->as<ValueExpressionBase>().symbol;
+            case ExpressionKind::ArbitrarySymbol:
+                return expr->as<ArbitrarySymbolExpression>().symbol;
+            case ExpressionKind::MemberAccess:
+                return &expr->as<MemberAccessExpression>().member;
+            case ExpressionKind::Call: {
+                auto& call = expr->as<CallExpression>();
+                if (!call.isSystemCall())
+                    return std::get<0>(call.subroutine);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    // Otherwise see if the location is on the name of a declaration.
+    auto symbol = getSymbolAt(location);
+    if (symbol && symbol->location.buffer() == location.buffer() &&
+        location.offset() >= symbol->location.offset() &&
+        location.offset() < symbol->location.offset() + symbol->name.length()) {
+        return symbol;
+    }
+
+    return nullptr;
+}
+
 } // namespace slang::ast
@@ -0,0 +1,903 @@
+//------------------------------------------------------------------------------
+// SubroutineBytecode.cpp
+// Bytecode for evaluating constant functions
+//
+// SPDX-FileCopyrightText: Michael Popoloski
+// SPDX-License-Identifier: MIT
+//------------------------------------------------------------------------------
+#include "slang/ast/SubroutineBytecode.h"
+
+#include "slang/ast/ASTVisitor.h"
+#include "slang/ast/EvalContext.h"
+#include "slang/ast/expressions/AssignmentExpressions.h"
+#include "slang/ast/expressions/CallExpression.h"
+#include "slang/ast/expressions/LiteralExpressions.h"
+#include "slang/ast/expressions/MiscExpressions.h"
+#include "slang/ast/expressions/OperatorExpressions.h"
+#include "slang/ast/expressions/SelectExpressions.h"
+#include "slang/ast/symbols/SubroutineSymbols.h"
+#include "slang/ast/symbols/VariableSymbols.h"
+#include "slang/ast/types/Type.h"
+
+namespace {
+
+using namespace slang;
+using namespace slang::ast;
+
+constexpr uint32_t NoIndex = UINT32_MAX;
+
+struct DisableFinder : public ASTVisitor<DisableFinder, true, false> {
+    bool found = false;
+
+    void handle(const DisableStatement&) { found = true; }
+};
+
+struct LValueReferenceFinder : public ASTVisitor<LValueReferenceFinder, false, true> {
+    bool found = false;
+
+    void handle(const LValueReferenceExpression&) { found = true; }
+};
+
+bool isIncDecOp(UnaryOperator op) {
+    switch (op) {
+        case UnaryOperator::Preincrement:
+        case UnaryOperator::Predecrement:
+        case UnaryOperator::Postincrement:
+        case UnaryOperator::Postdecrement:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool isShortCircuitOp(BinaryOperator op) {
+    switch (op) {
+        case BinaryOperator::LogicalAnd:
+        case BinaryOperator::LogicalOr:
+        case BinaryOperator::LogicalImplication:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Conditional operators treat a predicate with any unknown bits specially,
+// even if it would otherwise be considered true.
+bool isUnknownPredicate(const ConstantValue& cv) {
+    return cv.isInteger() && cv.integer().hasUnknown();
+}
+
+} // namespace
+
+namespace slang::ast {
+
+using ER = Statement::EvalResult;
+
+class SubroutineBytecode::Builder {
+public:
+    explicit Builder(SubroutineBytecode& bytecode) : bytecode(bytecode) {}
+
+    void addLocal(const ValueSymbol& symbol) {
+        auto index = (uint32_t)bytecode.locals.size();
+        if (localIndices.emplace(&symbol, index).second)
+            bytecode.locals.push_back(&symbol);
+    }
+
+    void lowerStmt(const Statement& stmt) {
+        // Registers only hold temporaries for the duration of a single
+        // statement, so they can be reused once it's done.
+        const uint32_t savedReg = nextReg;
+        lowerStmtImpl(stmt);
+        nextReg = savedReg;
+    }
+
+private:
+    struct LoopTargets {
+        SmallVector<size_t> breaks;
+        SmallVector<size_t> continues;
+        SmallVector<size_t> execs;
+    };
+
+    struct LValueTarget {
+        uint32_t local;
+        uint32_t range;
+        const Expression* select;
+    };
+
+    SubroutineBytecode& bytecode;
+    flat_hash_map<const ValueSymbol*, uint32_t> localIndices;
+    SmallVector<LoopTargets*> loops;
+    SmallVector<LValueTarget> lvalues;
+    uint32_t nextReg = 0;
+    bool lvalueFallback = false;
+
+    size_t emit(Op op, uint32_t dst = 0, uint32_t a = 0, uint32_t b = 0,
+                const Expression* expr = nullptr) {
+        bytecode.code.push_back(Instr{op, dst, a, b, {.expr = expr}});
+        return bytecode.code.size() - 1;
+    }
+
+    size_t emit(Op op, const Statement& stmt, uint32_t a = 0, uint32_t b = 0) {
+        bytecode.code.push_back(Instr{op, 0, a, b, {.stmt = &stmt}});
+        return bytecode.code.size() - 1;
+    }
+
+    uint32_t here() const { return (uint32_t)bytecode.code.size(); }
+
+    uint32_t allocRegs(size_t count) {
+        uint32_t result = nextReg;
+        nextReg += (uint32_t)count;
+        bytecode.numRegs = std::max(bytecode.numRegs, nextReg);
+        return result;
+    }
+
+    uint32_t allocReg() { return allocRegs(1); }
+
+    uint32_t allocRange() { return bytecode.numRanges++; }
+
+    void emitConst(ConstantValue value, uint32_t dst) {
+        emit(Op::Const, dst, (uint32_t)bytecode.constants.size());
+        bytecode.constants.emplace_back(std::move(value));
+    }
+
+    void emitExec(const Statement& stmt) {
+        auto index = emit(Op::Exec, stmt, NoIndex, NoIndex);
+        if (!loops.empty())
+            loops.back()->execs.push_back(index);
+    }
+
+    void patchLoop(const LoopTargets& loop, uint32_t breakTarget, uint32_t continueTarget) {
+        for (auto index : loop.breaks)
+            bytecode.code[index].a = breakTarget;
+        for (auto index : loop.continues)
+            bytecode.code[index].a = continueTarget;
+        for (auto index : loop.execs) {
+            bytecode.code[index].a = breakTarget;
+            bytecode.code[index].b = continueTarget;
+        }
+    }
+
+    std::optional<uint32_t> findLocal(const Expression& expr) const {
+        if (expr.kind != ExpressionKind::NamedValue)
+            return std::nullopt;
+
+        // Reading these types issues a diagnostic, so they
+        // need to go through the normal evaluation path.
+        if (expr.type->isClass() || expr.type->isCovergroup())
+            return std::nullopt;
+
+        auto it = localIndices.find(&expr.as<NamedValueExpression>().symbol);
+        if (it == localIndices.end())
+            return std::nullopt;
+
+        return it->second;
+    }
+
+    void lowerStmtImpl(const Statement& stmt) {
+        if (stmt.bad()) {
+            emitExec(stmt);
+            return;
+        }
+
+        switch (stmt.kind) {
+            case StatementKind::Empty:
+                emit(Op::Step, stmt);
+                return;
+            case StatementKind::List:
+                emit(Op::Step, stmt);
+                for (auto item : stmt.as<StatementList>().list)
+                    lowerStmt(*item);
+                return;
+            case StatementKind::Block: {
+                auto& block = stmt.as<BlockStatement>();
+                if (block.blockKind != StatementBlockKind::Sequential)
+                    break;
+
+                emit(Op::Step, stmt);
+                lowerStmt(block.body);
+                return;
+            }
+            case StatementKind::VariableDeclaration: {
+                auto& var = stmt.as<VariableDeclStatement>().symbol;
+                addLocal(var);
+
+                // Static initializers are skipped with a warning.
+                auto init = var.getInitializer();
+                if (init && var.lifetime == VariableLifetime::Static && !init->bad())
+                    break;
+
+                emit(Op::Step, stmt);
+                uint32_t reg = NoIndex;
+                if (init) {
+                    reg = allocReg();
+                    lowerExpr(*init, reg);
+                }
+                emit(Op::DeclLocal, 0, localIndices[&var], reg);
+                return;
+            }
+            case StatementKind::ExpressionStatement: {
+                auto& expr = stmt.as<ExpressionStatement>().expr;
+                if (expr.kind == ExpressionKind::Call && expr.as<CallExpression>().isSystemCall() &&
+                    expr.as<CallExpression>().getSubroutineKind() == SubroutineKind::Task) {
+                    break;
+                }
+
+                emit(Op::Step, stmt);
+                lowerExpr(expr, allocReg());
+                return;
+            }
+            case StatementKind::Conditional:
+                if (lowerConditional(stmt.as<ConditionalStatement>()))
+                    return;
+                break;
+            case StatementKind::ForLoop:
+                lowerForLoop(stmt.as<ForLoopStatement>());
+                return;
+            case StatementKind::WhileLoop: {
+                auto& loop = stmt.as<WhileLoopStatement>();
+                emit(Op::Step, stmt);
+
+                LoopTargets targets;
+                uint32_t top = here();
+                uint32_t reg = allocReg();
+                lowerExpr(loop.cond, reg);
+                auto exit = emit(Op::JumpIfFalse, 0, reg);
+
+                loops.push_back(&targets);
+                lowerStmt(loop.body);
+                loops.pop_back();
+
+                emit(Op::Jump, 0, top);
+                bytecode.code[exit].b = here();
+                patchLoop(targets, here(), top);
+                return;
+            }
+            case StatementKind::DoWhileLoop: {
+                auto& loop = stmt.as<DoWhileLoopStatement>();
+                emit(Op::Step, stmt);
+
+                LoopTargets targets;
+                uint32_t top = here();
+                loops.push_back(&targets);
+                lowerStmt(loop.body);
+                loops.pop_back();
+
+                uint32_t cond = here();
+                uint32_t reg = allocReg();
+                lowerExpr(loop.cond, reg);
+                emit(Op::JumpIfTrue, 0, reg, top);
+                patchLoop(targets, here(), cond);
+                return;
+            }
+            case StatementKind::Return: {
+                emit(Op::Step, stmt);
+                uint32_t reg = NoIndex;
+                if (auto expr = stmt.as<ReturnStatement>().expr) {
+                    reg = allocReg();
+                    lowerExpr(*expr, reg);
+                }
+                emit(Op::Return, 0, reg);
+                return;
+            }
+            case StatementKind::Break:
+                if (loops.empty())
+                    break;
+
+                emit(Op::Step, stmt);
+                loops.back()->breaks.push_back(emit(Op::Jump));
+                return;
+            case StatementKind::Continue:
+                if (loops.empty())
+                    break;
+
+                emit(Op::Step, stmt);
+                loops.back()->continues.push_back(emit(Op::Jump));
+                return;
+            default:
+                break;
+        }
+
+        // Everything else is evaluated by walking the AST.
+        emitExec(stmt);
+    }
+
+    bool lowerConditional(const ConditionalStatement& stmt) {
+        if (stmt.check != UniquePriorityCheck::None)
+            return false;
+
+        // Flatten the if / else-if chain. Walking the AST evaluates every
+        // condition in the chain before picking a branch, so do the same.
+        SmallVector<const ConditionalStatement*> chain;
+        const Statement* elseStmt = nullptr;
+        const ConditionalStatement* curr = &stmt;
+        while (true) {
+            if (curr->bad() || curr->conditions.size() != 1 || curr->conditions[0].pattern ||
+                curr->ifTrue.kind == StatementKind::Conditional) {
+                return false;
+            }
+
+            chain.push_back(curr);
+            if (!curr->ifFalse)
+                break;
+
+            if (curr->ifFalse->kind != StatementKind::Conditional) {
+                elseStmt = curr->ifFalse;
+                break;
+            }
+            curr = &curr->ifFalse->as<ConditionalStatement>();
+        }
+
+        emit(Op::Step, stmt);
+
+        uint32_t regs = allocRegs(chain.size());
+        for (size_t i = 0; i < chain.size(); i++)
+            lowerExpr(*chain[i]->conditions[0].expr, regs + uint32_t(i));
+
+        SmallVector<size_t> branches;
+        for (size_t i = 0; i < chain.size(); i++)
+            branches.push_back(emit(Op::JumpIfTrue, 0, regs + uint32_t(i)));
+
+        SmallVector<size_t> exits;
+        if (elseStmt)
+            lowerStmt(*elseStmt);
+        exits.push_back(emit(Op::Jump));
+
+        for (size_t i = 0; i < chain.size(); i++) {
+            bytecode.code[branches[i]].b = here();
+            lowerStmt(chain[i]->ifTrue);
+            exits.push_back(emit(Op::Jump));
+        }
+
+        for (auto index : exits)
+            bytecode.code[index].a = here();
+        return true;
+    }
+
+    void lowerForLoop(const ForLoopStatement& loop) {
+        emit(Op::Step, loop);
+        for (auto init : loop.initializers)
+            lowerExpr(*init, allocReg());
+
+        LoopTargets targets;
+        uint32_t top = here();
+        std::optional<size_t> exit;
+        if (loop.stopExpr) {
+            uint32_t reg = allocReg();
+            lowerExpr(*loop.stopExpr, reg);
+            exit = emit(Op::JumpIfFalse, 0, reg);
+        }
+
+        loops.push_back(&targets);
+        lowerStmt(loop.body);
+        loops.pop_back();
+
+        uint32_t next = here();
+        for (auto step : loop.steps)
+            lowerExpr(*step, allocReg());
+        emit(Op::Jump, 0, top);
+
+        if (exit)
+            bytecode.code[*exit].b = here();
+        patchLoop(targets, here(), next);
+    }
+
+    void lowerExpr(const Expression& expr, uint32_t dst) {
+        if (expr.constant) {
+            emitConst(*expr.constant, dst);
+            return;
+        }
+
+        if (!expr.bad()) {
+            switch (expr.kind) {
+                case ExpressionKind::IntegerLiteral:
+                    emitConst(expr.as<IntegerLiteral>().getValue(), dst);
+                    return;
+                case ExpressionKind::RealLiteral:
+                    emitConst(real_t(expr.as<RealLiteral>().getValue()), dst);
+                    return;
+                case ExpressionKind::UnbasedUnsizedIntegerLiteral:
+                    emitConst(expr.as<UnbasedUnsizedIntegerLiteral>().getValue(), dst);
+                    return;
+                case ExpressionKind::NamedValue:
+                    if (auto local = findLocal(expr)) {
+                        emit(Op::Load, dst, *local, 0, &expr);
+                        return;
+                    }
+                    break;
+                case ExpressionKind::UnaryOp:
+                    if (lowerUnary(expr.as<UnaryExpression>(), dst))
+                        return;
+                    break;
+                case ExpressionKind::BinaryOp:
+                    if (lowerBinary(expr.as<BinaryExpression>(), dst))
+                        return;
+                    break;
+                case ExpressionKind::ConditionalOp:
+                    if (lowerConditional(expr.as<ConditionalExpression>(), dst))
+                        return;
+                    break;
+                case ExpressionKind::Conversion:
+                    lowerExpr(expr.as<ConversionExpression>().operand(), dst);
+                    emit(Op::Convert, dst, dst, 0, &expr);
+                    return;
+                case ExpressionKind::Assignment:
+                    if (lowerAssignment(expr.as<AssignmentExpression>(), dst))
+                        return;
+                    break;
+                case ExpressionKind::ElementSelect:
+                case ExpressionKind::RangeSelect:
+                    if (lowerSelect(expr, dst))
+                        return;
+                    break;
+                case ExpressionKind::LValueReference:
+                    if (!lvalues.empty()) {
+                        auto& target = lvalues.back();
+                        if (target.range == NoIndex) {
+                            emit(Op::Load, dst, target.local);
+                        }
+                        else {
+                            emit(Op::Load, dst, target.local);
+                            emit(Op::Slice, dst, dst, target.range, target.select);
+                        }
+                        return;
+                    }
+                    break;
+                case ExpressionKind::Call:
+                    if (lowerCall(expr.as<CallExpression>(), dst))
+                        return;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        // Everything else is evaluated by walking the AST. That won't work if
+        // the expression refers to the target of a compound assignment we're
+        // lowering, since the AST expects to find it in the EvalContext.
+        if (!lvalues.empty()) {
+            LValueReferenceFinder finder;
+            expr.visit(finder);
+            lvalueFallback |= finder.found;
+        }
+
+        emit(Op::Eval, dst, 0, 0, &expr);
+    }
+
+    bool lowerUnary(const UnaryExpression& expr, uint32_t dst) {
+        if (isIncDecOp(expr.op)) {
+            auto local = findLocal(expr.operand());
+            if (!local)
+                return false;
+
+            emit(Op::IncDec, dst, *local, 0, &expr);
+            return true;
+        }
+
+        lowerExpr(expr.operand(), dst);
+        emit(Op::Unary, dst, dst, 0, &expr);
+        return true;
+    }
+
+    bool lowerBinary(const BinaryExpression& expr, uint32_t dst) {
+        if (expr.left().kind == ExpressionKind::TypeReference &&
+            expr.right().kind == ExpressionKind::TypeReference) {
+            return false;
+        }
+
+        lowerExpr(expr.left(), dst);
+
+        std::optional<size_t> shortCircuit;
+        if (isShortCircuitOp(expr.op))
+            shortCircuit = emit(Op::ShortCircuit, dst, dst, 0, &expr);
+
+        uint32_t reg = allocReg();
+        lowerExpr(expr.right(), reg);
+        emit(Op::Binary, dst, dst, reg, &expr);
+
+        if (shortCircuit)
+            bytecode.code[*shortCircuit].b = here();
+        return true;
+    }
+
+    bool lowerConditional(const ConditionalExpression& expr, uint32_t dst) {
+        if (expr.conditions.size() != 1 || expr.conditions[0].pattern || !expr.type->isIntegral())
+            return false;
+
+        // An unknown predicate evaluates both sides and merges them,
+        // so each side gets its own register.
+        uint32_t pred = allocReg();
+        uint32_t sides = allocRegs(2);
+        lowerExpr(*expr.conditions[0].expr, pred);
+
+        auto skipLeft = emit(Op::JumpIfKnownFalse, 0, pred);
+        lowerExpr(expr.left(), sides);
+        auto skipRight = emit(Op::JumpIfKnownTrue, 0, pred);
+
+        bytecode.code[skipLeft].b = here();
+        lowerExpr(expr.right(), sides + 1);
+
+        bytecode.code[skipRight].b = here();
+        emit(Op::CondMerge, dst, pred, sides, &expr);
+        return true;
+    }
+
+    bool lowerAssignment(const AssignmentExpression& expr, uint32_t dst) {
+        if (expr.timingControl)
+            return false;
+
+        // Queues with a max bound need special handling when assigned.
+        auto& left = expr.left();
+        const size_t start = bytecode.code.size();
+        LValueTarget target;
+        if (auto local = findLocal(left); local && !left.type->isQueue()) {
+            target = {*local, NoIndex, nullptr};
+        }
+        else if (left.kind == ExpressionKind::ElementSelect) {
+            auto& select = left.as<ElementSelectExpression>();
+            auto local = findLocal(select.value());
+            if (!local || !select.value().type->isIntegral())
+                return false;
+
+            uint32_t reg = allocReg();
+            lowerExpr(select.selector(), reg);
+
+            target = {*local, allocRange(), &left};
+            emit(Op::IndexRange, target.range, 0, reg, &left);
+        }
+        else if (left.kind == ExpressionKind::RangeSelect) {
+            auto& select = left.as<RangeSelectExpression>();
+            auto local = findLocal(select.value());
+            if (!local || !select.value().type->isIntegral())
+                return false;
+
+            uint32_t regs = allocRegs(2);
+            lowerExpr(select.left(), regs);
+            lowerExpr(select.right(), regs + 1);
+
+            target = {*local, allocRange(), &left};
+            emit(Op::SliceRange, target.range, regs, 0, &left);
+        }
+        else {
+            return false;
+        }
+
+        const bool savedFallback = std::exchange(lvalueFallback, false);
+        if (expr.isCompound())
+            lvalues.push_back(target);
+
+        lowerExpr(expr.right(), dst);
+
+        if (expr.isCompound())
+            lvalues.pop_back();
+
+        if (std::exchange(lvalueFallback, savedFallback)) {
+            bytecode.code.resize(start);
+            return false;
+        }
+
+        if (target.range == NoIndex)
+            emit(Op::Store, 0, target.local, dst, &left);
+        else
+            emit(Op::StoreSlice, dst, target.local, target.range, &left);
+        return true;
+    }
+
+    bool lowerSelect(const Expression& expr, uint32_t dst) {
+        if (expr.kind == ExpressionKind::ElementSelect) {
+            auto& select = expr.as<ElementSelectExpression>();
+            if (!select.value().type->isIntegral())
+                return false;
+
+            lowerExpr(select.value(), dst);
+            uint32_t reg = allocReg();
+            lowerExpr(select.selector(), reg);
+
+            uint32_t range = allocRange();
+            emit(Op::IndexRange, range, 0, reg, &expr);
+            emit(Op::Slice, dst, dst, range, &expr);
+        }
+        else {
+            auto& select = expr.as<RangeSelectExpression>();
+            if (!select.value().type->isIntegral())
+                return false;
+
+            lowerExpr(select.value(), dst);
+            uint32_t regs = allocRegs(2);
+            lowerExpr(select.left(), regs);
+            lowerExpr(select.right(), regs + 1);
+
+            uint32_t range = allocRange();
+            emit(Op::SliceRange, range, regs, 0, &expr);
+            emit(Op::Slice, dst, dst, range, &expr);
+        }
+        return true;
+    }
+
+    bool lowerCall(const CallExpression& expr, uint32_t dst) {
+        if (expr.isSystemCall() || expr.thisClass())
+            return false;
+
+        auto& subroutine = *std::get<0>(expr.subroutine);
+        for (auto arg : subroutine.getArguments()) {
+            if (arg->direction != ArgumentDirection::In)
+                return false;
+        }
+
+        emit(Op::CallCheck, 0, 0, 0, &expr);
+
+        auto args = expr.arguments();
+        uint32_t regs = allocRegs(args.size());
+        for (size_t i = 0; i < args.size(); i++)
+            lowerExpr(*args[i], regs + uint32_t(i));
+
+        emit(Op::Call, dst, regs, (uint32_t)args.size(), &expr);
+        return true;
+    }
+};
+
+std::unique_ptr<SubroutineBytecode> SubroutineBytecode::lower(const SubroutineSymbol& subroutine) {
+    // Disable statements unwind to a target block by symbol, which the
+    // bytecode doesn't track, so leave those functions to the AST.
+    auto& body = subroutine.getBody();
+    DisableFinder finder;
+    body.visit(finder);
+    if (finder.found)
+        return nullptr;
+
+    auto result = std::make_unique<SubroutineBytecode>();
+    Builder builder(*result);
+    for (auto arg : subroutine.getArguments())
+        builder.addLocal(*arg);
+    if (subroutine.returnValVar)
+        builder.addLocal(*subroutine.returnValVar);
+
+    builder.lowerStmt(body);
+    return result;
+}
+
+ER SubroutineBytecode::run(EvalContext& context) const {
+    SmallVector<ConstantValue, 16> regs;
+    regs.resize(numRegs);
+
+    SmallVector<std::optional<ConstantRange>, 4> ranges;
+    ranges.resize(numRanges);
+
+    // Storage for locals is looked up lazily; it lives in the current
+    // stack frame so that expressions and statements evaluated via the
+    // AST will find it as well.
+    SmallVector<ConstantValue*, 8> slots;
+    slots.resize(locals.size());
+
+    auto getSlot = [&](uint32_t index) {
+        auto& slot = slots[index];
+        if (!slot)
+            slot = context.findLocal(locals[index]);
+        return slot;
+    };
+
+    // Locals should always exist by the time they're referenced, but if not
+    // evaluate the reference the normal way so that an error gets reported.
+    auto missingLocal = [&](const Expression* expr) {
+        if (expr)
+            (void)expr->eval(context);
+        return ER::Fail;
+    };
+
+    static const ConstantValue EmptyValue;
+    const Instr* instrs = code.data();
+    const size_t numInstrs = code.size();
+
+    size_t pc = 0;
+    while (pc < numInstrs) {
+        const Instr& instr = instrs[pc++];
+        switch (instr.op) {
+            case Op::Step:
+                if (!context.step(instr.stmt->sourceRange.start()))
+                    return ER::Fail;
+                break;
+            case Op::Exec: {
+                ER result = instr.stmt->eval(context);
+                if (result == ER::Success)
+                    break;
+
+                if (result == ER::Break && instr.a != NoIndex)
+                    pc = instr.a;
+                else if (result == ER::Continue && instr.b != NoIndex)
+                    pc = instr.b;
+                else
+                    return result;
+                break;
+            }
+            case Op::Const:
+                regs[instr.dst] = constants[instr.a];
+                break;
+            case Op::Eval:
+                regs[instr.dst] = instr.expr->eval(context);
+                if (!regs[instr.dst])
+                    return ER::Fail;
+                break;
+            case Op::Load: {
+                auto slot = getSlot(instr.a);
+                if (!slot)
+                    return missingLocal(instr.expr);
+
+                regs[instr.dst] = *slot;
+                break;
+            }
+            case Op::Store: {
+                auto slot = getSlot(instr.a);
+                if (!slot)
+                    return missingLocal(instr.expr);
+
+                *slot = regs[instr.b];
+                break;
+            }
+            case Op::DeclLocal: {
+                ConstantValue initial;
+                if (instr.b != NoIndex)
+                    initial = std::move(regs[instr.b]);
+                slots[instr.a] = context.createLocal(locals[instr.a], std::move(initial));
+                break;
+            }
+            case Op::IncDec: {
+                auto& expr = instr.expr->as<UnaryExpression>();
+                auto slot = getSlot(instr.a);
+                if (!slot)
+                    return missingLocal(&expr.operand());
+
+                regs[instr.dst] = Expression::evalIncDecOperator(expr.op, *slot);
+                break;
+            }
+            case Op::Unary:
+                regs[instr.dst] = Expression::evalUnaryOperator(
+                    instr.expr->as<UnaryExpression>().op, regs[instr.a]);
+                break;
+            case Op::Binary:
+                regs[instr.dst] = Expression::evalBinaryOperator(
+                    instr.expr->as<BinaryExpression>().op, regs[instr.a], regs[instr.b]);
+                break;
+            case Op::ShortCircuit: {
+                auto& cv = regs[instr.a];
+                switch (instr.expr->as<BinaryExpression>().op) {
+                    case BinaryOperator::LogicalOr:
+                        if (cv.isTrue()) {
+                            regs[instr.dst] = SVInt(true);
+                            pc = instr.b;
+                        }
+                        break;
+                    case BinaryOperator::LogicalAnd:
+                        if (cv.isFalse()) {
+                            regs[instr.dst] = SVInt(false);
+                            pc = instr.b;
+                        }
+                        break;
+                    case BinaryOperator::LogicalImplication:
+                        if (cv.isFalse()) {
+                            regs[instr.dst] = SVInt(true);
+                            pc = instr.b;
+                        }
+                        break;
+                    default:
+                        SLANG_UNREACHABLE;
+                }
+                break;
+            }
+            case Op::Convert: {
+                auto& expr = instr.expr->as<ConversionExpression>();
+                regs[instr.dst] = ConversionExpression::convert(context, *expr.operand().type,
+                                                                *expr.type, expr.sourceRange,
+                                                                std::move(regs[instr.a]),
+                                                                expr.conversionKind);
+                if (!regs[instr.dst])
+                    return ER::Fail;
+                break;
+            }
+            case Op::CondMerge: {
+                auto& pred = regs[instr.a];
+                auto& left = regs[instr.b];
+                auto& right = regs[instr.b + 1];
+                if (isUnknownPredicate(pred)) {
+                    if (left.isInteger() && right.isInteger()) {
+                        regs[instr.dst] = SVInt::conditional(pred.integer(), left.integer(),
+                                                             right.integer());
+                    }
+                    else {
+                        regs[instr.dst] = instr.expr->type->getDefaultValue();
+                    }
+                }
+                else if (pred.isTrue()) {
+                    regs[instr.dst] = std::move(left);
+                }
+                else {
+                    regs[instr.dst] = std::move(right);
+                }
+                break;
+            }
+            case Op::IndexRange: {
+                bool softFail = false;
+                ConstantValue associativeIndex;
+                ranges[instr.dst] = instr.expr->as<ElementSelectExpression>().evalIndex(
+                    context, EmptyValue, std::move(regs[instr.b]), associativeIndex, softFail);
+                if (!ranges[instr.dst] && !softFail)
+                    return ER::Fail;
+                break;
+            }
+            case Op::SliceRange:
+                ranges[instr.dst] = instr.expr->as<RangeSelectExpression>().evalRange(
+                    context, EmptyValue, regs[instr.a], regs[instr.a + 1]);
+                if (!ranges[instr.dst])
+                    return ER::Fail;
+                break;
+            case Op::Slice:
+                // Out of bounds element selects read as the default value.
+                if (auto& range = ranges[instr.b]) {
+                    regs[instr.dst] = regs[instr.a].integer().slice(range->upper(),
+                                                                    range->lower());
+                }
+                else {
+                    regs[instr.dst] = instr.expr->type->getDefaultValue();
+                }
+                break;
+            case Op::StoreSlice: {
+                // Out of bounds element selects ignore writes.
+                auto slot = getSlot(instr.a);
+                if (!slot)
+                    return missingLocal(instr.expr);
+
+                if (auto& range = ranges[instr.b]) {
+                    slot->integer().set(range->upper(), range->lower(),
+                                        regs[instr.dst].integer());
+                }
+                break;
+            }
+            case Op::CallCheck: {
+                auto& expr = instr.expr->as<CallExpression>();
+                if (!CallExpression::checkConstant(context, *std::get<0>(expr.subroutine),
+                                                   expr.sourceRange)) {
+                    return ER::Fail;
+                }
+                break;
+            }
+            case Op::Call: {
+                std::span<ConstantValue> args(regs.data() + instr.a, instr.b);
+                regs[instr.dst] = instr.expr->as<CallExpression>().invoke(context, args);
+                if (!regs[instr.dst])
+                    return ER::Fail;
+                break;
+            }
+            case Op::Jump:
+                pc = instr.a;
+                break;
+            case Op::JumpIfTrue:
+                if (regs[instr.a].isTrue())
+                    pc = instr.b;
+                break;
+            case Op::JumpIfFalse:
+                if (!regs[instr.a].isTrue())
+                    pc = instr.b;
+                break;
+            case Op::JumpIfKnownTrue:
+                if (!isUnknownPredicate(regs[instr.a]) && regs[instr.a].isTrue())
+                    pc = instr.b;
+                break;
+            case Op::JumpIfKnownFalse:
+                if (!isUnknownPredicate(regs[instr.a]) && !regs[instr.a].isTrue())
+                    pc = instr.b;
+                break;
+            case Op::Return:
+                if (instr.a != NoIndex) {
+                    auto subroutine = context.topFrame().subroutine;
+                    SLANG_ASSERT(subroutine);
+
+                    ConstantValue* storage = context.findLocal(subroutine->returnValVar);
+                    SLANG_ASSERT(storage);
+                    *storage = std::move(regs[instr.a]);
+                }
+                return ER::Return;
+        }
+    }
+
+    return ER::Success;
+}
+
+} // namespace slang::ast
@@ -11,6 +11,7 @@
 #include "slang/ast/Compilation.h"
 #include "slang/ast/Constraints.h"
 #include "slang/ast/EvalContext.h"
+#include "slang/ast/SubroutineBytecode.h"
 #include "slang/ast/SystemSubroutine.h"
 #include "slang/ast/expressions/MiscExpressions.h"
 #include "slang/ast/expressions/SelectExpressions.h"
@@ -689,7 +690,54 @@ ConstantValue CallExpression::evalImpl(EvalContext& context) const {
         args.emplace_back(std::move(v));
     }
 
+    return invoke(context, args);
+}
+
+// Checks whether a value is real or has a real value nested anywhere inside of it.
+static bool containsReal(const ConstantValue& cv) {
+    if (cv.isReal() || cv.isShortReal())
+        return true;
+
+    if (cv.isUnpacked())
+        return std::ranges::any_of(cv.elements(), containsReal);
+
+    if (cv.isQueue())
+        return std::ranges::any_of(*cv.queue(), containsReal);
+
+    if (cv.isMap()) {
+        auto& map = *cv.map();
+        for (auto& [key, value] : map) {
+            if (containsReal(key) || containsReal(value))
+                return true;
+        }
+        return containsReal(map.defaultValue);
+    }
+
+    if (cv.isUnion())
+        return containsReal(cv.unionVal()->value);
+
+    return false;
+}
+
+ConstantValue CallExpression::invoke(EvalContext& context, std::span<ConstantValue> args) const {
+    const SubroutineSymbol& symbol = *std::get<0>(subroutine);
+
+    // If the function's result only depends on its arguments we can reuse
+    // the result from an earlier call with the same argument values. Real
+    // arguments are skipped since values like -0.0 and 0.0 compare equal.
+    auto& comp = context.getCompilation();
+    const bool useCache = !comp.getOptions().disableFunctionCaching &&
+                          !context.flags.has(EvalFlags::IsScript | EvalFlags::CovergroupExpr) &&
+                          std::ranges::none_of(args, containsReal) &&
+                          comp.canCacheCallResults(symbol);
+
+    if (useCache) {
+        if (auto cached = comp.findCachedCallResult(symbol, args))
+            return *cached;
+    }
+
     // Push a new stack frame, push argument values as locals.
+    const size_t diagCount = context.getDiagnosticCount();
     if (!context.pushFrame(symbol, sourceRange.start(), lookupLocation))
         return nullptr;
 
@@ -700,8 +748,14 @@ ConstantValue CallExpression::evalImpl(EvalContext& context) const {
     SLANG_ASSERT(symbol.returnValVar);
     context.createLocal(symbol.returnValVar);
 
+    // Run the lowered bytecode for the body if it's available,
+    // otherwise walk the statement tree directly.
     using ER = Statement::EvalResult;
-    ER er = symbol.getBody().eval(context);
+    ER er;
+    if (auto bytecode = comp.getSubroutineBytecode(symbol))
+        er = bytecode->run(context);
+    else
+        er = symbol.getBody().eval(context);
 
     // If we got a disable result, it means a disable statement was evaluated that
     // targeted a block that wasn't executing. This isn't allowed in a constant expression.
@@ -716,6 +770,12 @@ ConstantValue CallExpression::evalImpl(EvalContext& context) const {
         return nullptr;
 
     SLANG_ASSERT(er == ER::Success || er == ER::Return);
+
+    // Don't cache anything that issued diagnostics, so that
+    // they get issued again for every call.
+    if (useCache && context.getDiagnosticCount() == diagCount)
+        comp.cacheCallResult(symbol, args, result);
+
     return result;
 }
 
@@ -122,24 +122,31 @@ Expression& ValueExpressionBase::fromSymbol(const ASTContext& context, const Sym
         return badExpr(comp, nullptr);
     }
 
-    if (auto syntax = symbol.getSyntax(); syntax && !context.flags.has(ASTFlags::NoReference)) {
-        bool isLValue = context.flags.has(ASTFlags::LValue);
-        if (isDottedAccess) {
-            auto& type = value.getType();
-            if (type.isClass() || type.isCovergroup())
-                isLValue = false;
-        }
+    bool isLValue = context.flags.has(ASTFlags::LValue);
+    if (isDottedAccess) {
+        auto& type = value.getType();
+        if (type.isClass() || type.isCovergroup())
+            isLValue = false;
+    }
 
+    const bool noteRef = !context.flags.has(ASTFlags::NoReference);
+    if (auto syntax = symbol.getSyntax(); syntax && noteRef) {
         comp.noteReference(*syntax, isLValue);
 
         if (isLValue && context.flags.has(ASTFlags::LAndRValue))
             comp.noteReference(*syntax, /* isLValue */ false);
     }
 
+    Expression* result;
     if (isHierarchical)
-        return *comp.emplace<HierarchicalValueExpression>(value, sourceRange);
+        result = comp.emplace<HierarchicalValueExpression>(value, sourceRange);
     else
-        return *comp.emplace<NamedValueExpression>(value, sourceRange);
+        result = comp.emplace<NamedValueExpression>(value, sourceRange);
+
+    if (noteRef && comp.getOptions().buildReferenceIndex)
+        comp.noteSymbolReference(value, *result, *context.scope, isLValue);
+
+    return *result;
 }
 
 bool ValueExpressionBase::requireLValueImpl(const ASTContext& context, SourceLocation location,
@@ -522,10 +529,16 @@ Expression& ArbitrarySymbolExpression::fromSyntax(Compilation& compilation,
     if (!symbol)
         return badExpr(compilation, nullptr);
 
-    compilation.noteReference(*symbol, context.flags.has(ASTFlags::LValue));
+    const bool isLValue = context.flags.has(ASTFlags::LValue);
+    compilation.noteReference(*symbol, isLValue);
 
-    return *compilation.emplace<ArbitrarySymbolExpression>(*symbol, compilation.getVoidType(),
-                                                           syntax.sourceRange());
+    auto expr = compilation.emplace<ArbitrarySymbolExpression>(
+        *symbol, compilation.getVoidType(), syntax.sourceRange());
+
+    if (compilation.getOptions().buildReferenceIndex)
+        compilation.noteSymbolReference(*symbol, *expr, *context.scope, isLValue);
+
+    return *expr;
 }
 
 void ArbitrarySymbolExpression::serializeTo(ASTSerializer& serializer) const {
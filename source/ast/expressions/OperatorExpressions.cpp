@@ -461,109 +461,16 @@ ConstantValue UnaryExpression::evalImpl(EvalContext& context) const {
         if (!cv)
             return nullptr;
 
-        if (cv.isInteger()) {
-#define OP(k, val)         \
-    case UnaryOperator::k: \
-        lvalue.store(val); \
-        return v
-
-            SVInt v = std::move(cv).integer();
-            switch (op) {
-                OP(Preincrement, ++v);
-                OP(Predecrement, --v);
-                OP(Postincrement, v + 1);
-                OP(Postdecrement, v - 1);
-                default:
-                    break;
-            }
-#undef OP
-        }
-        else if (cv.isReal()) {
-#define OP(k, val)                 \
-    case UnaryOperator::k:         \
-        lvalue.store(real_t(val)); \
-        return real_t(v)
-
-            double v = cv.real();
-            switch (op) {
-                OP(Preincrement, ++v);
-                OP(Predecrement, --v);
-                OP(Postincrement, v + 1);
-                OP(Postdecrement, v - 1);
-                default:
-                    break;
-            }
-#undef OP
-        }
-        else if (cv.isShortReal()) {
-#define OP(k, val)                      \
-    case UnaryOperator::k:              \
-        lvalue.store(shortreal_t(val)); \
-        return shortreal_t(v)
-
-            float v = cv.shortReal();
-            switch (op) {
-                OP(Preincrement, ++v);
-                OP(Predecrement, --v);
-                OP(Postincrement, v + 1);
-                OP(Postdecrement, v - 1);
-                default:
-                    break;
-            }
-#undef OP
-        }
-
-        SLANG_UNREACHABLE;
+        ConstantValue result = evalIncDecOperator(op, cv);
+        lvalue.store(cv);
+        return result;
     }
 
     ConstantValue cv = operand().eval(context);
     if (!cv)
         return nullptr;
 
-#define OP(k, v)           \
-    case UnaryOperator::k: \
-        return v;
-
-    if (cv.isInteger()) {
-        SVInt v = std::move(cv).integer();
-        switch (op) {
-            OP(Plus, v);
-            OP(Minus, -v);
-            OP(BitwiseNot, ~v);
-            OP(BitwiseAnd, SVInt(v.reductionAnd()));
-            OP(BitwiseOr, SVInt(v.reductionOr()));
-            OP(BitwiseXor, SVInt(v.reductionXor()));
-            OP(BitwiseNand, SVInt(!v.reductionAnd()));
-            OP(BitwiseNor, SVInt(!v.reductionOr()));
-            OP(BitwiseXnor, SVInt(!v.reductionXor()));
-            OP(LogicalNot, SVInt(!v));
-            default:
-                break;
-        }
-    }
-    else if (cv.isReal()) {
-        double v = cv.real();
-        switch (op) {
-            OP(Plus, real_t(v));
-            OP(Minus, real_t(-v));
-            OP(LogicalNot, SVInt(!(bool)v));
-            default:
-                break;
-        }
-    }
-    else if (cv.isShortReal()) {
-        float v = cv.shortReal();
-        switch (op) {
-            OP(Plus, shortreal_t(v));
-            OP(Minus, shortreal_t(-v));
-            OP(LogicalNot, SVInt(!(bool)v));
-            default:
-                break;
-        }
-    }
-
-#undef OP
-    SLANG_UNREACHABLE;
+    return evalUnaryOperator(op, cv);
 }
 
 void UnaryExpression::serializeTo(ASTSerializer& serializer) const {
@@ -2072,6 +1979,112 @@ BinaryOperator Expression::getBinaryOperator(SyntaxKind kind) {
     }
 }
 
+ConstantValue Expression::evalUnaryOperator(UnaryOperator op, const ConstantValue& cv) {
+    if (!cv)
+        return nullptr;
+
+#define OP(k, v)           \
+    case UnaryOperator::k: \
+        return v;
+
+    if (cv.isInteger()) {
+        const SVInt& v = cv.integer();
+        switch (op) {
+            OP(Plus, v);
+            OP(Minus, -v);
+            OP(BitwiseNot, ~v);
+            OP(BitwiseAnd, SVInt(v.reductionAnd()));
+            OP(BitwiseOr, SVInt(v.reductionOr()));
+            OP(BitwiseXor, SVInt(v.reductionXor()));
+            OP(BitwiseNand, SVInt(!v.reductionAnd()));
+            OP(BitwiseNor, SVInt(!v.reductionOr()));
+            OP(BitwiseXnor, SVInt(!v.reductionXor()));
+            OP(LogicalNot, SVInt(!v));
+            default:
+                break;
+        }
+    }
+    else if (cv.isReal()) {
+        double v = cv.real();
+        switch (op) {
+            OP(Plus, real_t(v));
+            OP(Minus, real_t(-v));
+            OP(LogicalNot, SVInt(!(bool)v));
+            default:
+                break;
+        }
+    }
+    else if (cv.isShortReal()) {
+        float v = cv.shortReal();
+        switch (op) {
+            OP(Plus, shortreal_t(v));
+            OP(Minus, shortreal_t(-v));
+            OP(LogicalNot, SVInt(!(bool)v));
+            default:
+                break;
+        }
+    }
+
+#undef OP
+    SLANG_UNREACHABLE;
+}
+
+ConstantValue Expression::evalIncDecOperator(UnaryOperator op, ConstantValue& value) {
+    if (value.isInteger()) {
+#define OP(k, val)         \
+    case UnaryOperator::k: \
+        value = val;       \
+        return v
+
+        SVInt v = value.integer();
+        switch (op) {
+            OP(Preincrement, ++v);
+            OP(Predecrement, --v);
+            OP(Postincrement, v + 1);
+            OP(Postdecrement, v - 1);
+            default:
+                break;
+        }
+#undef OP
+    }
+    else if (value.isReal()) {
+#define OP(k, val)           \
+    case UnaryOperator::k:   \
+        value = real_t(val); \
+        return real_t(v)
+
+        double v = value.real();
+        switch (op) {
+            OP(Preincrement, ++v);
+            OP(Predecrement, --v);
+            OP(Postincrement, v + 1);
+            OP(Postdecrement, v - 1);
+            default:
+                break;
+        }
+#undef OP
+    }
+    else if (value.isShortReal()) {
+#define OP(k, val)                \
+    case UnaryOperator::k:        \
+        value = shortreal_t(val); \
+        return shortreal_t(v)
+
+        float v = value.shortReal();
+        switch (op) {
+            OP(Preincrement, ++v);
+            OP(Predecrement, --v);
+            OP(Postincrement, v + 1);
+            OP(Postdecrement, v - 1);
+            default:
+                break;
+        }
+#undef OP
+    }
+
+    SLANG_UNREACHABLE;
+}
+
 ConstantValue Expression::evalBinaryOperator(BinaryOperator op, const ConstantValue& cvl,
                                              const ConstantValue& cvr) {
     if (!cvl || !cvr)
@@ -322,6 +322,14 @@ std::optional<ConstantRange> ElementSelectExpression::evalIndex(EvalContext& con
     if (!cs)
         return std::nullopt;
 
+    return evalIndex(context, val, std::move(cs), associativeIndex, softFail);
+}
+
+std::optional<ConstantRange> ElementSelectExpression::evalIndex(EvalContext& context,
+                                                                const ConstantValue& val,
+                                                                ConstantValue&& cs,
+                                                                ConstantValue& associativeIndex,
+                                                                bool& softFail) const {
     const Type& valType = *value().type;
     if (valType.isAssociativeArray()) {
         if (cs.hasUnknown())
@@ -718,6 +726,13 @@ std::optional<ConstantRange> RangeSelectExpression::evalRange(EvalContext& conte
     if (!cl || !cr)
         return std::nullopt;
 
+    return evalRange(context, val, cl, cr);
+}
+
+std::optional<ConstantRange> RangeSelectExpression::evalRange(EvalContext& context,
+                                                              const ConstantValue& val,
+                                                              const ConstantValue& cl,
+                                                              const ConstantValue& cr) const {
     const Type& valueType = *value().type;
     std::optional<int32_t> li = cl.integer().as<int32_t>();
     std::optional<int32_t> ri = cr.integer().as<int32_t>();
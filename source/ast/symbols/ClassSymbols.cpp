@@ -187,6 +187,9 @@ void ClassType::populate(const Scope& scope, const ClassDeclarationSyntax& synta
                s.flags == MethodFlags::None;
     };
 
+    // Make sure the name map exists so that this reference
+    // stays valid as we add members below.
+    ensureNameMap();
     auto& scopeNameMap = getUnelaboratedNameMap();
     auto makeFunc = [&](std::string_view funcName, const Type& returnType, bool allowOverride,
                         bitmask<MethodFlags> extraFlags = MethodFlags::None,
@@ -297,6 +300,7 @@ void ClassType::handleExtends(const ExtendsClauseSyntax& extendsClause, const AS
     baseClass = baseType;
 
     // Inherit all base class members that don't conflict with our declared symbols.
+    ensureNameMap();
     auto& scopeNameMap = getNameMap();
     bool pureVirtualError = false;
 
@@ -575,6 +579,7 @@ void ClassType::handleImplements(const ImplementsClauseSyntax& implementsClause,
                 continue;
 
             // Inherit all members that don't conflict with our declared symbols.
+            ensureNameMap();
             auto& scopeNameMap = getNameMap();
             for (auto& member : iface->members()) {
                 if (member.name.empty())
@@ -666,6 +666,41 @@ InstanceBodySymbol& InstanceBodySymbol::fromDefinition(
                           /* isFromBind */ false);
 }
 
+static constexpr size_t MinMembersToReserve = 64;
+
+// Estimates the number of named members that will be created for an instance
+// body, so that large flat modules (like gate-level netlists) can size their
+// name maps once up front instead of growing them while adding members.
+static size_t estimateNamedMembers(const ModuleDeclarationSyntax& syntax) {
+    size_t count = 0;
+    for (auto member : syntax.members) {
+        switch (member->kind) {
+            case SyntaxKind::NetDeclaration:
+                count += member->as<NetDeclarationSyntax>().declarators.size();
+                break;
+            case SyntaxKind::DataDeclaration:
+                count += member->as<DataDeclarationSyntax>().declarators.size();
+                break;
+            case SyntaxKind::PortDeclaration:
+                count += member->as<PortDeclarationSyntax>().declarators.size();
+                break;
+            case SyntaxKind::HierarchyInstantiation:
+                count += member->as<HierarchyInstantiationSyntax>().instances.size();
+                break;
+            case SyntaxKind::PrimitiveInstantiation:
+                count += member->as<PrimitiveInstantiationSyntax>().instances.size();
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (syntax.header->ports && syntax.header->ports->kind == SyntaxKind::AnsiPortList)
+        count += syntax.header->ports->as<AnsiPortListSyntax>().ports.size();
+
+    return count;
+}
+
 InstanceBodySymbol& InstanceBodySymbol::fromDefinition(Compilation& comp,
                                                        const Definition& definition,
                                                        SourceLocation instanceLoc,
@@ -678,6 +713,11 @@ InstanceBodySymbol& InstanceBodySymbol::fromDefinition(Compilation& comp,
     auto& declSyntax = definition.syntax;
     result->setSyntax(declSyntax);
 
+    // Small scopes are cheap to grow as we go, so only bother with
+    // a size estimate for bodies that have lots of members.
+    if (declSyntax.members.size() >= MinMembersToReserve)
+        result->reserveMembers(estimateNamedMembers(declSyntax));
+
     // Package imports from the header always come first.
     for (auto import : declSyntax.header->imports)
         result->addMembers(*import);
@@ -9,8 +9,10 @@
 #include "slang/driver/Driver.h"
 
 #include <fmt/color.h>
+#include <fstream>
 
 #include "slang/ast/Compilation.h"
+#include "slang/ast/Definition.h"
 #include "slang/ast/symbols/CompilationUnitSymbols.h"
 #include "slang/ast/symbols/InstanceSymbols.h"
 #include "slang/diagnostics/DeclarationsDiags.h"
@@ -20,10 +22,12 @@
 #include "slang/diagnostics/StatementsDiags.h"
 #include "slang/diagnostics/SysFuncsDiags.h"
 #include "slang/diagnostics/TextDiagnosticClient.h"
+#include "slang/parsing/IncludeTokenCache.h"
 #include "slang/parsing/Parser.h"
 #include "slang/parsing/Preprocessor.h"
 #include "slang/syntax/SyntaxPrinter.h"
 #include "slang/syntax/SyntaxTree.h"
+#include "slang/text/Json.h"
 #include "slang/util/Random.h"
 #include "slang/util/String.h"
 #include "slang/util/ThreadPool.h"
@@ -36,7 +40,9 @@ using namespace ast;
 using namespace parsing;
 using namespace syntax;
 
-Driver::Driver() : diagEngine(sourceManager), sourceLoader(sourceManager) {
+Driver::Driver() :
+    includeTokenCache(std::make_shared<IncludeTokenCache>()), diagEngine(sourceManager),
+    sourceLoader(sourceManager) {
     diagClient = std::make_shared<TextDiagnosticClient>();
     diagEngine.addClient(diagClient);
 }
@@ -101,6 +107,8 @@ void Driver::addStandardArgs() {
                 "<count>");
     cmdLine.add("-j,--threads", options.numThreads,
                 "The number of threads to use to parallelize parsing", "<count>");
+    cmdLine.add("--parse-cache", options.parseCacheDir,
+                "Directory in which to cache parsed files to speed up subsequent runs", "<dir>");
 
     // Compilation
     cmdLine.add("--max-hierarchy-depth", options.maxInstanceDepth,
@@ -145,6 +153,15 @@ void Driver::addStandardArgs() {
     cmdLine.add("--strict-driver-checking", options.strictDriverChecking,
                 "Perform strict driver checking, which currently means disabling "
                 "procedural 'for' loop unrolling.");
+    cmdLine.add("--disable-instance-caching", options.disableInstanceCaching,
+                "Fully check every instance in the design, even ones with identical "
+                "parameter values.");
+    cmdLine.add("--disable-function-caching", options.disableFunctionCaching,
+                "Evaluate every constant function call, even ones with the same "
+                "argument values as an earlier call.");
+    cmdLine.add("--constexpr-bytecode", options.enableBytecodeEval,
+                "Evaluate constant functions by lowering them to bytecode instead "
+                "of walking their syntax trees.");
     cmdLine.add("--lint-only", options.onlyLint,
                 "Only perform linting of code, don't try to elaborate a full hierarchy");
     cmdLine.add("--top", options.topModules,
@@ -254,6 +271,15 @@ void Driver::addStandardArgs() {
         "Exclude provided source files with these extensions", "<ext>",
         CommandLineFlags::CommaList);
 
+    // Profiling
+    cmdLine.add("--profile", options.profile,
+                "Print a report of the time and memory spent in each phase of compilation "
+                "and on each elaborated definition");
+    cmdLine.add("--profile-json", options.profileJson,
+                "Write the profiling report in JSON format to the specified file, "
+                "or '-' for stdout",
+                "<file>", CommandLineFlags::FilePath);
+
     cmdLine.setPositional(
         [this](std::string_view value) {
             if (!options.excludeExts.empty()) {
@@ -580,7 +606,17 @@ bool Driver::parseAllSources() {
     Bag optionBag;
     addParseOptions(optionBag);
 
+    auto startTime = std::chrono::steady_clock::now();
     syntaxTrees = sourceLoader.loadAndParseSources(optionBag);
+
+    if (isProfiling()) {
+        size_t bytes = 0;
+        for (auto& tree : syntaxTrees)
+            bytes += tree->allocator().getBytesAllocated();
+
+        profilePhases.push_back({"parse"sv, std::chrono::steady_clock::now() - startTime, bytes, 0});
+    }
+
     if (!reportLoadErrors())
         return false;
 
@@ -604,11 +640,13 @@ void Driver::addParseOptions(Bag& bag) const {
     soptions.singleUnit = options.singleUnit == true;
     soptions.onlyLint = options.onlyLint == true;
     soptions.librariesInheritMacros = options.librariesInheritMacros == true;
+    soptions.parseCacheDir = options.parseCacheDir;
 
     PreprocessorOptions ppoptions;
     ppoptions.predefines = options.defines;
     ppoptions.undefines = options.undefines;
     ppoptions.predefineSource = "<command-line>";
+    ppoptions.includeTokenCache = includeTokenCache;
     if (options.maxIncludeDepth.has_value())
         ppoptions.maxIncludeDepth = *options.maxIncludeDepth;
     for (const auto& d : options.ignoreDirectives)
@@ -657,6 +695,12 @@ void Driver::addCompilationOptions(Bag& bag) const {
         coptions.relaxEnumConversions = true;
     if (options.strictDriverChecking == true)
         coptions.strictDriverChecking = true;
+    if (options.disableInstanceCaching == true)
+        coptions.disableInstanceCaching = true;
+    if (options.disableFunctionCaching == true)
+        coptions.disableFunctionCaching = true;
+    if (options.enableBytecodeEval == true)
+        coptions.enableBytecodeEval = true;
     if (options.ignoreUnknownModules == true)
         coptions.ignoreUnknownModules = true;
     if (options.allowUseBeforeDeclare == true)
@@ -686,6 +730,8 @@ void Driver::addCompilationOptions(Bag& bag) const {
 
 std::unique_ptr<Compilation> Driver::createCompilation() const {
     auto compilation = std::make_unique<Compilation>(createOptionBag());
+    if (isProfiling())
+        compilation->enableProfiling();
     for (auto& tree : sourceLoader.getLibraryMaps())
         compilation->addSyntaxTree(tree);
     for (auto& tree : syntaxTrees)
@@ -710,6 +756,24 @@ bool Driver::reportParseDiags() {
 }
 
 bool Driver::reportCompilation(Compilation& compilation, bool quiet) {
+    auto measurePhase = [&](std::string_view name, auto&& func) {
+        if (!isProfiling()) {
+            func();
+            return;
+        }
+
+        auto startTime = std::chrono::steady_clock::now();
+        auto startBytes = compilation.getBytesAllocated();
+        auto startSteps = compilation.getConstEvalSteps();
+        func();
+        profilePhases.push_back({name, std::chrono::steady_clock::now() - startTime,
+                                 compilation.getBytesAllocated() - startBytes,
+                                 compilation.getConstEvalSteps() - startSteps});
+    };
+
+    measurePhase("elaborate"sv, [&] { compilation.getRoot(); });
+    measurePhase("check"sv, [&] { compilation.getAllDiagnostics(); });
+
     if (!quiet) {
         auto topInstances = compilation.getRoot().topInstances;
         if (!topInstances.empty()) {
@@ -743,9 +807,123 @@ bool Driver::reportCompilation(Compilation& compilation, bool quiet) {
                               diagEngine.getNumWarnings() == 1 ? "" : "s"));
     }
 
+    if (isProfiling() && !reportProfile(compilation))
+        succeeded = false;
+
     return succeeded;
 }
 
+static std::string formatBytes(size_t bytes) {
+    if (bytes < 1024)
+        return fmt::format("{} B", bytes);
+    if (bytes < 1024 * 1024)
+        return fmt::format("{:.1f} KiB", double(bytes) / 1024);
+    return fmt::format("{:.1f} MiB", double(bytes) / (1024 * 1024));
+}
+
+static double toMillis(std::chrono::nanoseconds time) {
+    return std::chrono::duration<double, std::milli>(time).count();
+}
+
+bool Driver::reportProfile(const Compilation& compilation) {
+    // Only the most expensive definitions are included in the text report;
+    // the JSON report always contains all of them.
+    static constexpr size_t MaxTextDefinitions = 25;
+
+    auto definitions = compilation.getDefinitionProfiles();
+    if (options.profile == true) {
+        std::string text = "\nProfile by phase:\n";
+        text += fmt::format("  {:<24} {:>12} {:>12} {:>16}\n", "Phase", "Time (ms)", "Allocated",
+                            "Const eval steps");
+        for (auto& phase : profilePhases) {
+            text += fmt::format("  {:<24} {:>12.2f} {:>12} {:>16}\n", phase.name,
+                                toMillis(phase.time), formatBytes(phase.allocatedBytes),
+                                phase.constEvalSteps);
+        }
+
+        size_t count = std::min(definitions.size(), MaxTextDefinitions);
+        text += fmt::format("\nProfile by definition ({} of {}, by elaboration time):\n", count,
+                            definitions.size());
+        text += fmt::format("  {:<24} {:>10} {:>12} {:>12} {:>16}\n", "Definition", "Instances",
+                            "Time (ms)", "Allocated", "Const eval steps");
+        for (size_t i = 0; i < count; i++) {
+            auto& def = definitions[i];
+            text += fmt::format("  {:<24} {:>10} {:>12.2f} {:>12} {:>16}\n", def.definition->name,
+                                def.instances, toMillis(def.time),
+                                formatBytes(def.allocatedBytes), def.constEvalSteps);
+        }
+        auto& cacheStats = compilation.getFunctionCacheStats();
+        text += fmt::format("\nConstant function cache: {} hits, {} misses\n", cacheStats.hits,
+                            cacheStats.misses);
+        OS::print(text);
+    }
+
+    if (!options.profileJson)
+        return true;
+
+    JsonWriter writer;
+    writer.setPrettyPrint(true);
+    writer.startObject();
+    writer.writeProperty("phases");
+    writer.startArray();
+    for (auto& phase : profilePhases) {
+        writer.startObject();
+        writer.writeProperty("name");
+        writer.writeValue(phase.name);
+        writer.writeProperty("timeMs");
+        writer.writeValue(toMillis(phase.time));
+        writer.writeProperty("allocatedBytes");
+        writer.writeValue(uint64_t(phase.allocatedBytes));
+        writer.writeProperty("constEvalSteps");
+        writer.writeValue(phase.constEvalSteps);
+        writer.endObject();
+    }
+    writer.endArray();
+
+    writer.writeProperty("definitions");
+    writer.startArray();
+    for (auto& def : definitions) {
+        writer.startObject();
+        writer.writeProperty("name");
+        writer.writeValue(def.definition->name);
+        writer.writeProperty("kind");
+        writer.writeValue(def.definition->getKindString());
+        writer.writeProperty("instances");
+        writer.writeValue(def.instances);
+        writer.writeProperty("timeMs");
+        writer.writeValue(toMillis(def.time));
+        writer.writeProperty("allocatedBytes");
+        writer.writeValue(uint64_t(def.allocatedBytes));
+        writer.writeProperty("constEvalSteps");
+        writer.writeValue(def.constEvalSteps);
+        writer.endObject();
+    }
+    writer.endArray();
+
+    auto& cacheStats = compilation.getFunctionCacheStats();
+    writer.writeProperty("functionCache");
+    writer.startObject();
+    writer.writeProperty("hits");
+    writer.writeValue(cacheStats.hits);
+    writer.writeProperty("misses");
+    writer.writeValue(cacheStats.misses);
+    writer.endObject();
+    writer.endObject();
+
+    if (*options.profileJson == "-") {
+        OS::print(writer.view());
+        return true;
+    }
+
+    std::ofstream file(fs::path(widen(*options.profileJson)));
+    file << writer.view();
+    if (!file.flush()) {
+        printError(fmt::format("unable to write profile to '{}'", *options.profileJson));
+        return false;
+    }
+    return true;
+}
+
 void Driver::addLibraryFiles(std::string_view pattern) {
     // Parse the pattern; there's an optional leading library name
     // followed by an equals sign. If not there, we use the default
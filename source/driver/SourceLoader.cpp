@@ -7,13 +7,20 @@
 //------------------------------------------------------------------------------
 #include "slang/driver/SourceLoader.h"
 
+#include <atomic>
 #include <fmt/core.h>
+#include <fstream>
+#include <random>
 
 #include "slang/syntax/AllSyntax.h"
 #include "slang/syntax/SyntaxTree.h"
+#include "slang/parsing/Parser.h"
+#include "slang/parsing/Preprocessor.h"
 #include "slang/text/SourceManager.h"
+#include "slang/util/OS.h"
 #include "slang/util/String.h"
 #include "slang/util/ThreadPool.h"
+#include "slang/util/Version.h"
 
 namespace fs = std::filesystem;
 
@@ -175,10 +182,12 @@ SourceLoader::SyntaxTreeList SourceLoader::loadAndParseSources(const Bag& option
         }
     };
 
-    auto parseSingleUnit = [&](std::span<const SourceBuffer> buffers) {
+    auto parseSingleUnit = [&](std::span<const SourceBuffer> buffers, ThreadPool* threadPool) {
         // If we waited to parse direct buffers due to wanting a single unit, parse that unit now.
         if (!buffers.empty()) {
-            auto tree = SyntaxTree::fromBuffers(buffers, sourceManager, optionBag);
+            auto tree = threadPool ? SyntaxTree::fromBuffers(buffers, sourceManager, *threadPool,
+                                                             optionBag)
+                                   : SyntaxTree::fromBuffers(buffers, sourceManager, optionBag);
             if (srcOptions.onlyLint)
                 tree->isLibrary = true;
 
@@ -206,7 +215,7 @@ SourceLoader::SyntaxTreeList SourceLoader::loadAndParseSources(const Bag& option
         for (auto&& result : loadResults)
             handleLoadResult(std::move(result));
 
-        parseSingleUnit(singleUnitBuffers);
+        parseSingleUnit(singleUnitBuffers, &threadPool);
 
         // If we deferred libraries due to wanting to inherit macros, parse them now.
         if (!deferredLibBuffers.empty()) {
@@ -232,7 +241,7 @@ SourceLoader::SyntaxTreeList SourceLoader::loadAndParseSources(const Bag& option
         for (auto& entry : fileEntries)
             handleLoadResult(loadAndParse(entry, optionBag, srcOptions));
 
-        parseSingleUnit(singleUnitBuffers);
+        parseSingleUnit(singleUnitBuffers, nullptr);
 
         // If we deferred libraries due to wanting to inherit macros, parse them now.
         if (!deferredLibBuffers.empty()) {
@@ -459,7 +468,12 @@ SourceLoader::LoadResult SourceLoader::loadAndParse(const FileEntry& entry, cons
     }
     else {
         // Otherwise we can parse right away.
-        auto tree = SyntaxTree::fromBuffer(*buffer, sourceManager, optionBag);
+        std::shared_ptr<SyntaxTree> tree;
+        if (srcOptions.parseCacheDir)
+            tree = parseWithCache(*buffer, optionBag, *srcOptions.parseCacheDir);
+        else
+            tree = SyntaxTree::fromBuffer(*buffer, sourceManager, optionBag);
+
         if (entry.isLibraryFile || srcOptions.onlyLint)
             tree->isLibrary = true;
 
@@ -467,6 +481,83 @@ SourceLoader::LoadResult SourceLoader::loadAndParse(const FileEntry& entry, cons
     }
 }
 
+std::shared_ptr<SyntaxTree> SourceLoader::parseWithCache(const SourceBuffer& buffer,
+                                                         const Bag& optionBag,
+                                                         const std::string& cacheDir) {
+    // Cache entries are keyed on everything that can change the result of
+    // parsing a file: its contents and location, the library it belongs to,
+    // and the preprocessor, lexer, and parser options (which include any
+    // macros predefined on the command line). Included files are checked
+    // against the hashes stored in the entry itself when it gets loaded.
+    auto ppOptions = optionBag.getOrDefault<parsing::PreprocessorOptions>();
+    std::vector<std::string_view> ignoreDirectives(ppOptions.ignoreDirectives.begin(),
+                                                   ppOptions.ignoreDirectives.end());
+    std::ranges::sort(ignoreDirectives);
+
+    std::string keyText = fmt::format(
+        "{}\n{}\n{}\n{}\n{}\n{}\n{}\n", VersionInfo::getHash(),
+        getU8Str(sourceManager.getFullPath(buffer.id)), buffer.library ? buffer.library->name : "",
+        ppOptions.maxIncludeDepth, ppOptions.predefineSource,
+        optionBag.getOrDefault<parsing::LexerOptions>().maxErrors,
+        optionBag.getOrDefault<parsing::ParserOptions>().maxRecursionDepth);
+
+    auto appendList = [&](auto& list) {
+        keyText += std::to_string(list.size());
+        for (auto& item : list) {
+            keyText += '\n';
+            keyText += item;
+        }
+        keyText += '\n';
+    };
+    appendList(ppOptions.predefines);
+    appendList(ppOptions.undefines);
+    appendList(ignoreDirectives);
+
+    size_t key = 0;
+    hash_combine(key, std::string_view(keyText),
+                 std::string_view(buffer.data.data(), buffer.data.size()));
+
+    // Failures to read or write cache entries are never fatal;
+    // we just fall back to parsing the file normally.
+    auto cachePath = fs::path(widen(cacheDir)) / fmt::format("{:016x}.slcache", key);
+    SmallVector<char> data;
+    if (!OS::readFile(cachePath, data)) {
+        // The read data has a null terminator appended that we don't want.
+        data.pop_back();
+        if (auto tree = SyntaxTree::fromSerialized(data, buffer, sourceManager, optionBag))
+            return tree;
+    }
+
+    auto tree = SyntaxTree::fromBuffer(buffer, sourceManager, optionBag);
+    if (auto serialized = tree->serialize()) {
+        // Write to a temporary file first so that other processes sharing the
+        // cache never observe a partially written entry.
+        std::error_code ec;
+        fs::create_directories(cachePath.parent_path(), ec);
+
+        // The temporary name has to be unique among all threads in all processes
+        // that might be writing the same entry, which may even be on different
+        // machines if the cache directory is on a shared file system.
+        static const uint64_t tempSalt = std::random_device()();
+        static std::atomic<uint64_t> tempCounter;
+
+        auto tempPath = cachePath;
+        tempPath += fmt::format(".{}.{:x}.{}.tmp", OS::getProcessId(), tempSalt,
+                                tempCounter.fetch_add(1, std::memory_order_relaxed));
+
+        std::ofstream file(tempPath, std::ios::binary);
+        file.write(serialized->data(), std::streamsize(serialized->size()));
+        file.close();
+
+        if (file)
+            fs::rename(tempPath, cachePath, ec);
+        else
+            fs::remove(tempPath, ec);
+    }
+
+    return tree;
+}
+
 void SourceLoader::addError(const std::filesystem::path& path, std::error_code ec) {
     errors.emplace_back(fmt::format("'{}': {}", getU8Str(path), ec.message()));
 }
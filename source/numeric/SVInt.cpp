@@ -430,10 +430,10 @@ void SVInt::setAllZeros() {
 void SVInt::setAllOnes() {
     // we don't have unknown digits anymore, so reallocate if necessary
     if (unknownFlag) {
+        freeWords(pVal, getNumWords());
         unknownFlag = false;
-        delete[] pVal;
         if (getNumWords() > 1)
-            pVal = new uint64_t[getNumWords()];
+            pVal = allocWords(getNumWords());
     }
 
     if (isSingleWord())
@@ -452,10 +452,10 @@ void SVInt::setAllX() {
         memset(pVal, 0, words * WORD_SIZE);
     else {
         if (!isSingleWord())
-            delete[] pVal;
+            freeWords(pVal, getNumWords());
 
         unknownFlag = true;
-        pVal = new uint64_t[words * 2]();
+        pVal = allocWordsZeroed(words * 2);
     }
 
     // now set upper half to ones (for unknown)
@@ -467,10 +467,10 @@ void SVInt::setAllX() {
 void SVInt::setAllZ() {
     if (!unknownFlag) {
         if (!isSingleWord())
-            delete[] pVal;
+            freeWords(pVal, getNumWords());
 
         unknownFlag = true;
-        pVal = new uint64_t[getNumWords()];
+        pVal = allocWords(getNumWords());
     }
 
     // everything set to 1 (for Z in the low half and for unknown in the upper half)
@@ -1516,11 +1516,11 @@ void SVInt::set(int32_t msb, int32_t lsb, const SVInt& value) {
     uint32_t validSelectWidth = selectWidth - frontOOB - backOOB;
 
     if (!hasUnknown() && value.hasUnknown()) {
-        uint64_t* newData = new uint64_t[getNumWords(bitWidth, true)]();
-        memcpy(newData, getRawData(), getNumWords());
+        uint64_t* newData = allocWordsZeroed(getNumWords(bitWidth, true));
+        memcpy(newData, getRawData(), getNumWords() * WORD_SIZE);
 
         if (!isSingleWord())
-            delete[] pVal;
+            freeWords(pVal, getNumWords());
 
         unknownFlag = true;
         pVal = newData;
@@ -1783,16 +1783,84 @@ SVInt SVInt::concat(std::span<SVInt const> operands) {
 
 SVInt SVInt::allocUninitialized(bitwidth_t bits, bool signFlag, bool unknownFlag) {
     SLANG_ASSERT(bits && (bits > 64 || unknownFlag));
-    return SVInt(new uint64_t[getNumWords(bits, unknownFlag)], bits, signFlag, unknownFlag);
+    return SVInt(allocWords(getNumWords(bits, unknownFlag)), bits, signFlag, unknownFlag);
 }
 
 SVInt SVInt::allocZeroed(bitwidth_t bits, bool signFlag, bool unknownFlag) {
     SLANG_ASSERT(bits && (bits > 64 || unknownFlag));
-    return SVInt(new uint64_t[getNumWords(bits, unknownFlag)](), bits, signFlag, unknownFlag);
+    return SVInt(allocWordsZeroed(getNumWords(bits, unknownFlag)), bits, signFlag, unknownFlag);
+}
+
+namespace {
+
+// Multi-word values get created and destroyed at a high rate during constant
+// evaluation of wide parameters and packed structs, so small buffers are kept
+// in per-thread free lists, bucketed by word count, to avoid hitting the system
+// allocator for every temporary. Values up to 256 bits with unknowns
+// (or 512 bits without) are covered.
+struct WordCache {
+    static constexpr uint32_t MaxWords = 8;
+    static constexpr uint32_t MaxEntries = 64;
+
+    uint64_t* lists[MaxWords + 1] = {};
+    uint32_t counts[MaxWords + 1] = {};
+    bool alive = true;
+
+    ~WordCache() {
+        for (auto head : lists) {
+            while (head) {
+                auto next = reinterpret_cast<uint64_t*>(head[0]);
+                delete[] head;
+                head = next;
+            }
+        }
+
+        // Values with static storage duration can still be
+        // destroyed after this; make sure they don't get cached.
+        alive = false;
+    }
+};
+
+thread_local WordCache wordCache;
+
+} // namespace
+
+uint64_t* SVInt::allocWords(uint32_t numWords) {
+    if (numWords <= WordCache::MaxWords) {
+        auto& cache = wordCache;
+        if (auto head = cache.lists[numWords]) {
+            cache.lists[numWords] = reinterpret_cast<uint64_t*>(head[0]);
+            cache.counts[numWords]--;
+            return head;
+        }
+    }
+    return new uint64_t[numWords];
+}
+
+uint64_t* SVInt::allocWordsZeroed(uint32_t numWords) {
+    auto result = allocWords(numWords);
+    memset(result, 0, numWords * WORD_SIZE);
+    return result;
+}
+
+void SVInt::freeWords(uint64_t* data, uint32_t numWords) {
+    if (!data)
+        return;
+
+    if (numWords <= WordCache::MaxWords) {
+        auto& cache = wordCache;
+        if (cache.alive && cache.counts[numWords] < WordCache::MaxEntries) {
+            data[0] = reinterpret_cast<uintptr_t>(cache.lists[numWords]);
+            cache.lists[numWords] = data;
+            cache.counts[numWords]++;
+            return;
+        }
+    }
+    delete[] data;
 }
 
 void SVInt::initSlowCase(logic_t bit) {
-    pVal = new uint64_t[getNumWords()](); // allocation is zero cleared
+    pVal = allocWordsZeroed(getNumWords());
     pVal[1] = 1;
     if (exactlyEqual(bit, logic_t::z))
         pVal[0] = 1;
@@ -1800,7 +1868,7 @@ void SVInt::initSlowCase(logic_t bit) {
 
 void SVInt::initSlowCase(uint64_t value) {
     uint32_t words = getNumWords();
-    pVal = new uint64_t[words](); // allocation is zero cleared
+    pVal = allocWordsZeroed(words);
     pVal[0] = value;
 
     // sign extend if necessary
@@ -1817,7 +1885,7 @@ void SVInt::initSlowCase(std::span<const byte> bytes) {
     }
     else {
         uint32_t words = getNumWords();
-        pVal = new uint64_t[words](); // allocation is zero cleared
+        pVal = allocWordsZeroed(words);
         memcpy(pVal, bytes.data(), std::min<size_t>(words * WORD_SIZE, bytes.size()));
     }
     clearUnusedBits();
@@ -1825,7 +1893,7 @@ void SVInt::initSlowCase(std::span<const byte> bytes) {
 
 void SVInt::initSlowCase(const SVIntStorage& other) {
     uint32_t words = getNumWords();
-    pVal = new uint64_t[words];
+    pVal = allocWords(words);
     std::ranges::copy(other.pVal, other.pVal + words, pVal);
 }
 
@@ -1834,16 +1902,16 @@ SVInt& SVInt::assignSlowCase(const SVInt& rhs) {
         return *this;
 
     if (rhs.isSingleWord()) {
-        delete[] pVal;
+        freeWords(pVal, getNumWords());
         val = rhs.val;
     }
     else {
         if (isSingleWord()) {
-            pVal = new uint64_t[rhs.getNumWords()];
+            pVal = allocWords(rhs.getNumWords());
         }
         else if (getNumWords() != rhs.getNumWords()) {
-            delete[] pVal;
-            pVal = new uint64_t[rhs.getNumWords()];
+            freeWords(pVal, getNumWords());
+            pVal = allocWords(rhs.getNumWords());
         }
         memcpy(pVal, rhs.pVal, rhs.getNumWords() * WORD_SIZE);
     }
@@ -2045,13 +2113,13 @@ void SVInt::checkUnknown() {
     uint32_t words = getNumWords();
     if (words == 1) {
         uint64_t newVal = pVal[0];
-        delete[] pVal;
+        freeWords(pVal, words * 2);
         val = newVal;
     }
     else {
-        uint64_t* newMem = new uint64_t[words];
+        uint64_t* newMem = allocWords(words);
         memcpy(newMem, pVal, words * WORD_SIZE);
-        delete[] pVal;
+        freeWords(pVal, words * 2);
         pVal = newMem;
     }
 }
@@ -2064,14 +2132,14 @@ void SVInt::makeUnknown() {
     unknownFlag = true;
     if (words == 1) {
         auto value = val;
-        pVal = new uint64_t[2];
+        pVal = allocWords(2);
         pVal[0] = value;
         pVal[1] = 0;
     }
     else {
-        uint64_t* newMem = new uint64_t[words * 2]();
+        uint64_t* newMem = allocWordsZeroed(words * 2);
         memcpy(newMem, pVal, words * WORD_SIZE);
-        delete[] pVal;
+        freeWords(pVal, words);
         pVal = newMem;
     }
 }
@@ -0,0 +1,57 @@
+//------------------------------------------------------------------------------
+// IncludeTokenCache.cpp
+// Cache of lexed tokens for included files
+//
+// SPDX-FileCopyrightText: Michael Popoloski
+// SPDX-License-Identifier: MIT
+//------------------------------------------------------------------------------
+#include "slang/parsing/IncludeTokenCache.h"
+
+namespace slang::parsing {
+
+std::shared_ptr<const LexedTokens> IncludeTokenCache::getOrLex(const SourceBuffer& buffer,
+                                                               KeywordVersion keywordVersion,
+                                                               const LexerOptions& options) {
+    auto key = std::make_tuple(buffer.data.data(), keywordVersion);
+    {
+        std::unique_lock lock(mutex);
+        if (auto it = entries.find(key); it != entries.end())
+            return it->second;
+    }
+
+    // Lex outside of the lock; if another thread races us to the same file
+    // we'll just end up keeping whichever result got there first.
+    auto result = std::make_shared<LexedTokens>();
+    result->keywordVersion = keywordVersion;
+
+    Diagnostics diagnostics;
+    Lexer lexer(buffer, result->alloc, diagnostics, options);
+    while (true) {
+        Token token = lexer.lex(keywordVersion);
+        result->tokens.push_back(token);
+        if (token.kind == TokenKind::EndOfFile)
+            break;
+    }
+
+    // Anything that produced diagnostics gets lexed normally every time
+    // so that the diagnostics get reported in the right places.
+    std::shared_ptr<const LexedTokens> entry;
+    if (diagnostics.empty())
+        entry = std::move(result);
+
+    std::unique_lock lock(mutex);
+    auto [it, inserted] = entries.emplace(key, std::move(entry));
+    return it->second;
+}
+
+size_t IncludeTokenCache::size() const {
+    std::unique_lock lock(mutex);
+    size_t count = 0;
+    for (auto& [key, entry] : entries) {
+        if (entry)
+            count++;
+    }
+    return count;
+}
+
+} // namespace slang::parsing
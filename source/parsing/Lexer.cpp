@@ -7,11 +7,17 @@
 //------------------------------------------------------------------------------
 #include "slang/parsing/Lexer.h"
 
+#include <bit>
 #include <cmath>
 #include <fmt/core.h>
 
+#if defined(__x86_64__) || defined(_M_X64)
+#    include <emmintrin.h>
+#endif
+
 #include "slang/diagnostics/LexerDiags.h"
 #include "slang/diagnostics/NumericDiags.h"
+#include "slang/parsing/IncludeTokenCache.h"
 #include "slang/syntax/SyntaxKind.h"
 #include "slang/text/CharInfo.h"
 #include "slang/text/SourceManager.h"
@@ -29,6 +35,97 @@ using namespace syntax;
 
 using LF = LexerFacts;
 
+// The following helpers skip over runs of characters in the lexer's hot loops,
+// returning a pointer to the first character in [ptr, end) that doesn't belong to
+// the run. On x86-64 they classify 16 characters at a time using SSE2 (which is
+// always available there); everywhere else, and for the final few characters in
+// the buffer, they fall back to checking one character at a time.
+#if defined(__x86_64__) || defined(_M_X64)
+template<typename TFunc>
+static const char* skipBlocks(const char* ptr, const char* end, TFunc&& getStopMask) {
+    while (end - ptr >= 16) {
+        auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        if (uint32_t mask = uint32_t(getStopMask(chars)) & 0xffff)
+            return ptr + std::countr_zero(mask);
+        ptr += 16;
+    }
+    return ptr;
+}
+
+static __m128i charMask(__m128i chars, char c) {
+    return _mm_cmpeq_epi8(chars, _mm_set1_epi8(c));
+}
+
+// Note that the comparison is signed, so non-ASCII characters are never in range.
+static __m128i rangeMask(__m128i chars, char first, char last) {
+    return _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8(char(first - 1))),
+                         _mm_cmplt_epi8(chars, _mm_set1_epi8(char(last + 1))));
+}
+#endif
+
+static const char* skipHorizontalWhitespace(const char* ptr, const char* end) {
+#if defined(__x86_64__) || defined(_M_X64)
+    ptr = skipBlocks(ptr, end, [](__m128i chars) {
+        auto mask = _mm_or_si128(_mm_or_si128(charMask(chars, ' '), charMask(chars, '\t')),
+                                 rangeMask(chars, '\v', '\f'));
+        return ~_mm_movemask_epi8(mask);
+    });
+#endif
+
+    while (ptr != end && (*ptr == ' ' || *ptr == '\t' || *ptr == '\v' || *ptr == '\f'))
+        ptr++;
+    return ptr;
+}
+
+static const char* skipIdentifierChars(const char* ptr, const char* end) {
+#if defined(__x86_64__) || defined(_M_X64)
+    ptr = skipBlocks(ptr, end, [](__m128i chars) {
+        // Setting bit 5 folds upper case letters into lower case without moving
+        // any other character into the a-z range.
+        auto lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+        auto mask = _mm_or_si128(rangeMask(lower, 'a', 'z'), rangeMask(chars, '0', '9'));
+        mask = _mm_or_si128(mask, _mm_or_si128(charMask(chars, '_'), charMask(chars, '$')));
+        return ~_mm_movemask_epi8(mask);
+    });
+#endif
+
+    while (ptr != end && (isAlphaNumeric(*ptr) || *ptr == '_' || *ptr == '$'))
+        ptr++;
+    return ptr;
+}
+
+// Skips plain ASCII comment text, stopping at newlines, nulls, and any non-ASCII
+// character (which needs to be decoded and checked for validity).
+static const char* skipLineCommentText(const char* ptr, const char* end) {
+#if defined(__x86_64__) || defined(_M_X64)
+    ptr = skipBlocks(ptr, end, [](__m128i chars) {
+        auto mask = _mm_or_si128(_mm_or_si128(charMask(chars, '\n'), charMask(chars, '\r')),
+                                 charMask(chars, '\0'));
+        return _mm_movemask_epi8(mask) | _mm_movemask_epi8(chars);
+    });
+#endif
+
+    while (ptr != end && isASCII(*ptr) && !isNewline(*ptr) && *ptr != '\0')
+        ptr++;
+    return ptr;
+}
+
+// Skips plain ASCII comment text, stopping at anything that could start or end
+// a block comment, nulls, and any non-ASCII character.
+static const char* skipBlockCommentText(const char* ptr, const char* end) {
+#if defined(__x86_64__) || defined(_M_X64)
+    ptr = skipBlocks(ptr, end, [](__m128i chars) {
+        auto mask = _mm_or_si128(_mm_or_si128(charMask(chars, '*'), charMask(chars, '/')),
+                                 charMask(chars, '\0'));
+        return _mm_movemask_epi8(mask) | _mm_movemask_epi8(chars);
+    });
+#endif
+
+    while (ptr != end && isASCII(*ptr) && *ptr != '*' && *ptr != '/' && *ptr != '\0')
+        ptr++;
+    return ptr;
+}
+
 Lexer::Lexer(SourceBuffer buffer, BumpAllocator& alloc, Diagnostics& diagnostics,
              LexerOptions options) :
     Lexer(buffer.id, buffer.data, buffer.data.data(), alloc, diagnostics, options) {
@@ -194,6 +291,19 @@ void Lexer::splitTokens(BumpAllocator& alloc, Diagnostics& diagnostics,
 }
 
 Token Lexer::lex(KeywordVersion keywordVersion) {
+    if (replayTokens) {
+        if (keywordVersion == replayTokens->keywordVersion &&
+            replayIndex < replayTokens->tokens.size()) {
+            // Keep our place in the text in sync so that we can pick up
+            // from here if we have to stop replaying.
+            Token token = replayTokens->tokens[replayIndex++];
+            size_t offset = token.location().offset();
+            sourceBuffer = originalBegin + offset + token.rawText().length();
+            return token.withLocation(alloc, SourceLocation(bufferId, offset));
+        }
+        replayTokens.reset();
+    }
+
     triviaBuffer.clear();
     lexTrivia<false>();
 
@@ -214,6 +324,11 @@ Token Lexer::lex(KeywordVersion keywordVersion) {
     return token;
 }
 
+void Lexer::setReplayTokens(std::shared_ptr<const LexedTokens> tokens) {
+    replayTokens = std::move(tokens);
+    replayIndex = 0;
+}
+
 bool Lexer::isNextTokenOnSameLine() {
     auto guard = ScopeGuard([this, currBuff = sourceBuffer] { sourceBuffer = currBuff; });
 
@@ -248,6 +363,7 @@ bool Lexer::isNextTokenOnSameLine() {
 }
 
 Token Lexer::lexEncodedText(ProtectEncoding encoding, uint32_t expectedBytes, bool singleLine) {
+    replayTokens.reset();
     triviaBuffer.clear();
     lexTrivia<true>();
     mark();
@@ -1123,36 +1239,22 @@ void Lexer::lexTrivia() {
 }
 
 void Lexer::scanIdentifier() {
-    while (true) {
-        char c = peek();
-        if (isAlphaNumeric(c) || c == '_' || c == '$')
-            advance();
-        else
-            return;
-    }
+    sourceBuffer = skipIdentifierChars(sourceBuffer, sourceEnd);
 }
 
 void Lexer::scanWhitespace() {
-    bool done = false;
-    while (!done) {
-        switch (peek()) {
-            case ' ':
-            case '\t':
-            case '\v':
-            case '\f':
-                advance();
-                break;
-            default:
-                done = true;
-                break;
-        }
-    }
+    sourceBuffer = skipHorizontalWhitespace(sourceBuffer, sourceEnd);
     addTrivia(TriviaKind::Whitespace);
 }
 
 void Lexer::scanLineComment() {
     bool sawUTF8Error = false;
     while (true) {
+        if (auto next = skipLineCommentText(sourceBuffer, sourceEnd); next != sourceBuffer) {
+            sourceBuffer = next;
+            sawUTF8Error = false;
+        }
+
         char c = peek();
         if (isASCII(c)) {
             if (isNewline(c))
@@ -1180,6 +1282,11 @@ void Lexer::scanLineComment() {
 void Lexer::scanBlockComment() {
     bool sawUTF8Error = false;
     while (true) {
+        if (auto next = skipBlockCommentText(sourceBuffer, sourceEnd); next != sourceBuffer) {
+            sourceBuffer = next;
+            sawUTF8Error = false;
+        }
+
         char c = peek();
         if (isASCII(c)) {
             sawUTF8Error = false;
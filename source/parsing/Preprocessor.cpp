@@ -8,6 +8,7 @@
 #include "slang/parsing/Preprocessor.h"
 
 #include "slang/diagnostics/PreprocessorDiags.h"
+#include "slang/parsing/IncludeTokenCache.h"
 #include "slang/syntax/AllSyntax.h"
 #include "slang/text/SourceManager.h"
 #include "slang/util/BumpAllocator.h"
@@ -76,6 +77,15 @@ Preprocessor::Preprocessor(SourceManager& sourceManager, BumpAllocator& alloc,
     // clang-format on
 }
 
+Preprocessor::Preprocessor(SourceManager& sourceManager, BumpAllocator& alloc,
+                           Diagnostics& diagnostics, const TokenRecording& recording) :
+    sourceManager(sourceManager), alloc(alloc), diagnostics(diagnostics), replay(&recording),
+    numberParser(diagnostics, alloc) {
+
+    SLANG_ASSERT(!recording.tokens.empty() && !recording.states.empty());
+    keywordVersionStack.push_back(LF::getDefaultKeywordVersion());
+}
+
 Preprocessor::Preprocessor(const Preprocessor& other) :
     sourceManager(other.sourceManager), alloc(other.alloc), diagnostics(other.diagnostics),
     numberParser(diagnostics, alloc) {
@@ -100,6 +110,8 @@ void Preprocessor::pushSource(SourceBuffer buffer) {
 void Preprocessor::popSource() {
     if (includeDepth)
         includeDepth--;
+    else
+        sourcesFinished++;
     lexerStack.pop_back();
 }
 
@@ -187,7 +199,50 @@ void Preprocessor::resetAllDirectives() {
     resetProtectState();
 }
 
+Preprocessor::DirectiveState Preprocessor::getDirectiveState() const {
+    return {activeTimeScale, defaultNetType, unconnectedDrive, keywordVersionStack.back()};
+}
+
+void Preprocessor::setDirectiveState(const DirectiveState& state) {
+    activeTimeScale = state.timeScale;
+    defaultNetType = state.defaultNetType;
+    unconnectedDrive = state.unconnectedDrive;
+    keywordVersionStack.back() = state.keywordVersion;
+}
+
+Preprocessor::TokenRecording Preprocessor::recordTokens() {
+    SLANG_ASSERT(!lexerStack.empty() && !includeDepth);
+
+    TokenRecording recording;
+    recording.sourceStarts.push_back(0);
+
+    const size_t numSources = lexerStack.size();
+    const size_t firstFinished = sourcesFinished;
+    while (true) {
+        auto token = next();
+
+        // A source starts with the first token returned after the one before it
+        // was popped. Sources that produced no tokens start at the same index.
+        const size_t started = std::min(numSources, sourcesFinished - firstFinished + 1);
+        while (recording.sourceStarts.size() < started)
+            recording.sourceStarts.push_back(recording.tokens.size());
+
+        TokenRecording::StateChange state{recording.tokens.size(), getDirectiveState(),
+                                          getCurrentLibrary()};
+        if (recording.states.empty() || state.directives != recording.states.back().directives ||
+            state.library != recording.states.back().library) {
+            recording.states.push_back(state);
+        }
+
+        recording.tokens.push_back(token);
+        if (token.kind == TokenKind::EndOfFile)
+            return recording;
+    }
+}
+
 const SourceLibrary* Preprocessor::getCurrentLibrary() const {
+    if (replay)
+        return replayLibrary;
     return lexerStack.empty() ? nullptr : lexerStack.back()->getLibrary();
 }
 
@@ -477,6 +532,11 @@ Trivia Preprocessor::handleIncludeDirective(Token directive) {
         else if (includeOnceHeaders.find(buffer->data.data()) == includeOnceHeaders.end()) {
             includeDepth++;
             pushSource(*buffer);
+
+            if (options.includeTokenCache) {
+                lexerStack.back()->setReplayTokens(options.includeTokenCache->getOrLex(
+                    *buffer, keywordVersionStack.back(), lexerOptions));
+            }
         }
     }
 
@@ -1010,10 +1070,49 @@ void Preprocessor::checkOutsideDesignElement(Token directive) {
 
 Token Preprocessor::peek() {
     if (!currentToken)
-        currentToken = nextProcessed();
+        currentToken = replay ? nextReplayed() : nextProcessed();
     return currentToken;
 }
 
+Token Preprocessor::nextReplayed() {
+    auto& tokens = replay->tokens;
+    auto& states = replay->states;
+    while (replayStateIndex < states.size() && states[replayStateIndex].tokenIndex <= replayIndex) {
+        auto& state = states[replayStateIndex++];
+        setDirectiveState(state.directives);
+        replayLibrary = state.library;
+    }
+
+    // Keep returning the final EndOfFile token if asked for more.
+    auto token = tokens[std::min(replayIndex, tokens.size() - 1)];
+    replayIndex++;
+
+    // Directives were all handled when the tokens were recorded, except for
+    // checking where they appear, which depends on what the parser is doing.
+    if (designElementDepth) {
+        for (auto& trivia : token.trivia()) {
+            if (trivia.kind != TriviaKind::Directive)
+                continue;
+
+            auto& directive = trivia.syntax()->as<DirectiveSyntax>();
+            switch (directive.kind) {
+                case SyntaxKind::ResetAllDirective:
+                case SyntaxKind::DefaultNetTypeDirective:
+                case SyntaxKind::BeginKeywordsDirective:
+                case SyntaxKind::EndKeywordsDirective:
+                case SyntaxKind::UnconnectedDriveDirective:
+                case SyntaxKind::NoUnconnectedDriveDirective:
+                    checkOutsideDesignElement(directive.directive);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    return token;
+}
+
 Token Preprocessor::consume() {
     auto result = peek();
     lastConsumed = currentToken;
@@ -0,0 +1,1422 @@
+//------------------------------------------------------------------------------
+// SyntaxSerializer.cpp
+// Compact binary serialization of syntax trees
+//
+// SPDX-FileCopyrightText: Michael Popoloski
+// SPDX-License-Identifier: MIT
+//------------------------------------------------------------------------------
+#include "slang/syntax/SyntaxTree.h"
+
+#include "SyntaxDeserialize.h"
+#include <algorithm>
+#include <cstring>
+
+#include "slang/parsing/LexerFacts.h"
+#include "slang/parsing/ParserMetadata.h"
+#include "slang/text/SourceManager.h"
+#include "slang/util/Hash.h"
+#include "slang/util/String.h"
+#include "slang/util/Version.h"
+
+namespace slang::syntax {
+
+using namespace parsing;
+
+namespace {
+
+// The serialized form starts with a fixed header that identifies the data,
+// followed by a hash of the remaining payload so that truncated or otherwise
+// corrupted data can be rejected before we try to build any nodes from it.
+// The payload itself is made up of:
+//   - A table of all source buffers referenced by locations in the tree.
+//   - The root syntax node, with all child nodes, tokens, and trivia inline.
+//   - The parser metadata, referring back to nodes in the tree.
+//   - The list of macros defined at the end of the source file.
+//   - Any (non-error) diagnostics issued while parsing.
+constexpr std::string_view Magic = "SLSYNTAX"sv;
+constexpr uint32_t FormatVersion = 1;
+
+// Each node is prefixed with a header value; zero means a null node, one means
+// a reference to a previously serialized node, and otherwise the value is the
+// node's kind shifted left by one, with the low bit set if the node is referred
+// to by the metadata or macro list sections.
+constexpr uint64_t NullNodeHeader = 0;
+constexpr uint64_t NodeRefHeader = 1;
+constexpr uint64_t FirstKindHeader = 2;
+
+constexpr uint64_t getNodeHeader(SyntaxKind kind, bool referenced) {
+    return FirstKindHeader + ((uint64_t(kind) << 1) | uint64_t(referenced));
+}
+
+enum class BufferKind : uint8_t { Root, Include, Text, Expansion };
+
+// Most text in a tree points directly into the source buffers, so rather than
+// copying it we store offsets into the buffer that will be loaded again later.
+// Tokens and trivia are written in source order, so usually each piece of text
+// starts right where the previous one ended and only its length is needed.
+enum class TextKind : uint8_t { Inline, KindText, Adjacent, AtLocation, InBuffer };
+
+// Locations that don't refer to a real buffer (such as those of built-in
+// macros) are stored verbatim. Locations in the same buffer as the previously
+// written location are stored as a delta from it, and all others are stored
+// as an index into the buffer table plus an offset.
+constexpr uint64_t RawLocation = 0;
+constexpr uint64_t RelativeLocation = 1;
+constexpr uint64_t FirstBufferLocation = 2;
+
+// Set in the kind byte of trivia that have an explicit location.
+constexpr uint8_t HasLocationBit = 0x80;
+
+constexpr uint64_t zigzagEncode(int64_t value) {
+    return (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+}
+
+constexpr int64_t zigzagDecode(uint64_t value) {
+    return int64_t(value >> 1) ^ -int64_t(value & 1);
+}
+
+bool isRawBuffer(BufferID buffer) {
+    return !buffer || buffer == SourceLocation::NoLocation.buffer() ||
+           buffer == BufferID::getPlaceholder();
+}
+
+uint64_t hashText(std::string_view text) {
+    return slang::detail::hashing::hash(text.data(), text.size());
+}
+
+class ByteWriter {
+public:
+    std::vector<char> data;
+
+    void writeByte(uint8_t value) { data.push_back(char(value)); }
+
+    void writeVarint(uint64_t value) {
+        while (value >= 0x80) {
+            data.push_back(char(value | 0x80));
+            value >>= 7;
+        }
+        data.push_back(char(value));
+    }
+
+    void writeRaw(const void* ptr, size_t size) {
+        auto bytes = static_cast<const char*>(ptr);
+        data.insert(data.end(), bytes, bytes + size);
+    }
+
+    void writeU64(uint64_t value) { writeRaw(&value, sizeof(value)); }
+
+    void writeString(std::string_view str) {
+        writeVarint(str.size());
+        writeRaw(str.data(), str.size());
+    }
+};
+
+class SyntaxWriter {
+public:
+    bool failed = false;
+
+    SyntaxWriter(const SourceManager& sourceManager, BufferID rootBuffer) :
+        sourceManager(sourceManager), rootBuffer(rootBuffer) {
+        rootLibrary = sourceManager.getLibraryFor(rootBuffer);
+    }
+
+    void addReferencedNode(const SyntaxNode* node) { refIds.emplace(node, UnassignedId); }
+
+    void writeNode(const SyntaxNode* node) {
+        if (!node) {
+            stream.writeVarint(NullNodeHeader);
+            return;
+        }
+
+        bool referenced = false;
+        if (auto it = refIds.find(node); it != refIds.end()) {
+            if (it->second != UnassignedId) {
+                stream.writeVarint(NodeRefHeader);
+                stream.writeVarint(it->second);
+                return;
+            }
+            referenced = true;
+        }
+
+        stream.writeVarint(getNodeHeader(node->kind, referenced));
+        switch (node->kind) {
+            case SyntaxKind::SyntaxList:
+            case SyntaxKind::TokenList:
+            case SyntaxKind::SeparatedList:
+                stream.writeVarint(node->getChildCount());
+                break;
+            default:
+                break;
+        }
+
+        // Null nodes and invalid tokens are both written as a single zero,
+        // so we don't need to know which kind of child an empty slot is.
+        for (size_t i = 0; i < node->getChildCount(); i++) {
+            if (auto child = node->childNode(i))
+                writeNode(child);
+            else
+                writeToken(node->childToken(i));
+        }
+
+        // Nodes get their IDs after they're fully written, which matches the order
+        // in which they will be constructed when reading them back.
+        if (referenced)
+            refIds[node] = nextRefId++;
+    }
+
+    void writeNodeRef(const SyntaxNode* node) {
+        auto it = refIds.find(node);
+        if (it == refIds.end() || it->second == UnassignedId) {
+            failed = true;
+            return;
+        }
+        stream.writeVarint(it->second);
+    }
+
+    void writeMacros(std::span<const DefineDirectiveSyntax* const> macros) {
+        stream.writeVarint(macros.size());
+        for (auto macro : macros)
+            writeNode(macro);
+    }
+
+    void writeDiagnostics(const Diagnostics& diagnostics) {
+        stream.writeVarint(diagnostics.size());
+        for (auto& diag : diagnostics)
+            writeDiagnostic(diag);
+    }
+
+    void writeMetadata(const ParserMetadata& meta) {
+        stream.writeVarint(meta.nodeMap.size());
+        for (auto& [node, info] : meta.nodeMap) {
+            if (info.library && info.library != rootLibrary)
+                failed = true;
+
+            writeNodeRef(node);
+            stream.writeByte(info.library != nullptr);
+            stream.writeVarint(uint64_t(info.defaultNetType));
+            stream.writeVarint(uint64_t(info.unconnectedDrive));
+            stream.writeByte(info.timeScale.has_value());
+            if (info.timeScale) {
+                stream.writeByte(uint8_t(info.timeScale->base.unit));
+                stream.writeByte(uint8_t(info.timeScale->base.magnitude));
+                stream.writeByte(uint8_t(info.timeScale->precision.unit));
+                stream.writeByte(uint8_t(info.timeScale->precision.magnitude));
+            }
+        }
+
+        stream.writeVarint(meta.globalInstances.size());
+        for (auto name : meta.globalInstances)
+            writeText(name, SourceLocation());
+
+        auto writeRefs = [&](auto& list) {
+            stream.writeVarint(list.size());
+            for (auto node : list)
+                writeNodeRef(node);
+        };
+        writeRefs(meta.classPackageNames);
+        writeRefs(meta.packageImports);
+        writeRefs(meta.classDecls);
+        writeRefs(meta.interfacePorts);
+
+        writeToken(meta.eofToken);
+        stream.writeByte(meta.hasDefparams);
+        stream.writeByte(meta.hasBindDirectives);
+    }
+
+    std::vector<char> finish() {
+        ByteWriter payload;
+        writeBufferTable(payload);
+        payload.writeRaw(stream.data.data(), stream.data.size());
+
+        std::string_view payloadText(payload.data.data(), payload.data.size());
+
+        ByteWriter result;
+        result.writeRaw(Magic.data(), Magic.size());
+        result.writeVarint(FormatVersion);
+        result.writeString(VersionInfo::getHash());
+        result.writeU64(hashText(payloadText));
+        result.writeRaw(payloadText.data(), payloadText.size());
+        return std::move(result.data);
+    }
+
+private:
+    static constexpr uint32_t UnassignedId = UINT32_MAX;
+
+    struct BufferEntry {
+        BufferID id;
+        BufferKind kind;
+        std::string_view text;
+        SourceLocation originalLoc;
+        SourceRange expansionRange;
+        bool isMacroArg = false;
+        std::string_view macroName;
+    };
+
+    void writeDiagnostic(const Diagnostic& diag) {
+        // Parse diagnostics never refer to symbols, and only ever have
+        // simple arguments, but check anyway to be safe.
+        if (diag.symbol)
+            failed = true;
+
+        stream.writeVarint(uint64_t(diag.code.getSubsystem()));
+        stream.writeVarint(diag.code.getCode());
+        writeLocation(diag.location);
+
+        stream.writeVarint(diag.args.size());
+        for (auto& arg : diag.args) {
+            stream.writeByte(uint8_t(arg.index()));
+            std::visit(
+                [&](auto&& value) {
+                    using T = std::decay_t<decltype(value)>;
+                    if constexpr (std::is_same_v<T, std::string>)
+                        stream.writeString(value);
+                    else if constexpr (std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t>)
+                        stream.writeU64(uint64_t(value));
+                    else if constexpr (std::is_same_v<T, char>)
+                        stream.writeByte(uint8_t(value));
+                    else
+                        failed = true;
+                },
+                arg);
+        }
+
+        stream.writeVarint(diag.ranges.size());
+        for (auto& range : diag.ranges) {
+            writeLocation(range.start());
+            writeLocation(range.end());
+        }
+
+        stream.writeVarint(diag.notes.size());
+        for (auto& note : diag.notes)
+            writeDiagnostic(note);
+
+        stream.writeByte(diag.coalesceCount.has_value());
+        if (diag.coalesceCount)
+            stream.writeVarint(*diag.coalesceCount);
+    }
+
+    void writeToken(Token token) {
+        if (!token) {
+            stream.writeByte(0);
+            return;
+        }
+
+        auto loc = token.location();
+        stream.writeByte(token.isMissing() ? 2 : 1);
+        stream.writeVarint(uint64_t(token.kind));
+        writeLocation(loc);
+
+        // Trivia comes before the token's own text in the source,
+        // so write them in that order to make the text adjacent.
+        auto trivia = token.trivia();
+        stream.writeVarint(trivia.size());
+        for (auto& t : trivia)
+            writeTrivia(t);
+
+        if (auto kindText = LexerFacts::getTokenKindText(token.kind); !kindText.empty()) {
+            // The text for these tokens isn't stored, but keep track of where
+            // it is in the source so that the following trivia is adjacent.
+            stream.writeByte(uint8_t(TextKind::KindText));
+            lastText.reset();
+            if (auto it = bufferMap.find(loc.buffer().getId()); it != bufferMap.end()) {
+                auto bufferText = buffers[it->second].text;
+                if (bufferText.substr(std::min(size_t(loc.offset()), bufferText.size()))
+                        .starts_with(kindText)) {
+                    setLastText(bufferText.substr(loc.offset(), kindText.size()), bufferText);
+                }
+            }
+        }
+        else {
+            writeText(token.rawText(), loc);
+        }
+
+        switch (token.kind) {
+            case TokenKind::StringLiteral:
+                writeText(token.valueText(), SourceLocation());
+                break;
+            case TokenKind::Directive:
+            case TokenKind::MacroUsage:
+                stream.writeVarint(uint64_t(token.directiveKind()));
+                break;
+            case TokenKind::UnbasedUnsizedLiteral:
+                stream.writeByte(token.bitValue().value);
+                break;
+            case TokenKind::IntegerLiteral: {
+                SVInt value = token.intValue();
+                stream.writeVarint(value.getBitWidth());
+                stream.writeByte(uint8_t(value.isSigned()) | uint8_t(value.hasUnknown() << 1));
+                stream.writeRaw(value.getRawPtr(), value.getNumWords() * sizeof(uint64_t));
+                break;
+            }
+            case TokenKind::RealLiteral:
+            case TokenKind::TimeLiteral: {
+                double value = token.realValue();
+                stream.writeRaw(&value, sizeof(value));
+                stream.writeByte(token.numericFlags().raw);
+                break;
+            }
+            case TokenKind::IntegerBase:
+                stream.writeByte(token.numericFlags().raw);
+                break;
+            default:
+                break;
+        }
+    }
+
+    void writeTrivia(const Trivia& trivia) {
+        // The high bit of the kind is set if the trivia has an explicit location.
+        auto loc = trivia.getExplicitLocation();
+        stream.writeByte(uint8_t(trivia.kind) | (loc ? HasLocationBit : 0));
+        switch (trivia.kind) {
+            case TriviaKind::Directive:
+            case TriviaKind::SkippedSyntax: {
+                auto node = trivia.syntax();
+                if (node->kind == SyntaxKind::IncludeDirective) {
+                    // Remember how the include was spelled so that it can be
+                    // resolved again by the source manager when loading.
+                    auto& include = node->as<IncludeDirectiveSyntax>();
+                    auto path = include.fileName.valueText();
+                    if (path.length() >= 3) {
+                        includes.emplace(include.directive.location(),
+                                         std::pair{path.substr(1, path.length() - 2),
+                                                   path[0] == '<'});
+                    }
+                }
+                writeNode(node);
+                break;
+            }
+            case TriviaKind::SkippedTokens: {
+                auto tokens = trivia.getSkippedTokens();
+                stream.writeVarint(tokens.size());
+                for (auto token : tokens)
+                    writeToken(token);
+                break;
+            }
+            default:
+                if (loc)
+                    writeLocation(*loc);
+                writeText(trivia.getRawText(), loc.value_or(SourceLocation()));
+                break;
+        }
+    }
+
+    void writeText(std::string_view text, SourceLocation loc) {
+        if (!text.empty()) {
+            if (lastText && text.data() == lastText->end &&
+                text.data() + text.size() <= lastText->bufferEnd) {
+                stream.writeByte(uint8_t(TextKind::Adjacent));
+                stream.writeVarint(text.size());
+                lastText->end += text.size();
+                return;
+            }
+
+            // Text sitting at its own location in a source file.
+            if (auto it = bufferMap.find(loc.buffer().getId()); it != bufferMap.end()) {
+                auto bufferText = buffers[it->second].text;
+                if (loc.offset() + text.size() <= bufferText.size() &&
+                    bufferText.data() + loc.offset() == text.data()) {
+                    stream.writeByte(uint8_t(TextKind::AtLocation));
+                    stream.writeVarint(text.size());
+                    setLastText(text, bufferText);
+                    return;
+                }
+            }
+
+            // Otherwise see if the text points into any of the buffers we know about.
+            for (size_t i = 0; i < textBuffers.size(); i++) {
+                size_t index = textBuffers[(lastTextBuffer + i) % textBuffers.size()];
+                auto bufferText = buffers[index].text;
+                if (text.data() >= bufferText.data() &&
+                    text.data() + text.size() <= bufferText.data() + bufferText.size()) {
+                    lastTextBuffer = (lastTextBuffer + i) % textBuffers.size();
+                    stream.writeByte(uint8_t(TextKind::InBuffer));
+                    stream.writeVarint(index);
+                    stream.writeVarint(size_t(text.data() - bufferText.data()));
+                    stream.writeVarint(text.size());
+                    setLastText(text, bufferText);
+                    return;
+                }
+            }
+        }
+
+        stream.writeByte(uint8_t(TextKind::Inline));
+        stream.writeString(text);
+        lastText.reset();
+    }
+
+    void setLastText(std::string_view text, std::string_view bufferText) {
+        lastText = {text.data() + text.size(), bufferText.data() + bufferText.size()};
+    }
+
+    void writeLocation(SourceLocation loc) {
+        auto buffer = loc.buffer();
+        if (isRawBuffer(buffer)) {
+            stream.writeVarint(RawLocation);
+            stream.writeVarint(buffer.getId());
+            stream.writeVarint(loc.offset());
+            return;
+        }
+
+        auto index = getBufferIndex(buffer);
+        if (index == lastLocation.first) {
+            stream.writeVarint(RelativeLocation);
+            stream.writeVarint(zigzagEncode(int64_t(loc.offset()) - int64_t(lastLocation.second)));
+        }
+        else {
+            stream.writeVarint(index + FirstBufferLocation);
+            stream.writeVarint(loc.offset());
+        }
+        lastLocation = {index, loc.offset()};
+    }
+
+    void writeTableLocation(ByteWriter& writer, SourceLocation loc) {
+        auto buffer = loc.buffer();
+        if (isRawBuffer(buffer)) {
+            writer.writeVarint(RawLocation);
+            writer.writeVarint(buffer.getId());
+        }
+        else {
+            writer.writeVarint(getBufferIndex(buffer) + FirstBufferLocation);
+        }
+        writer.writeVarint(loc.offset());
+    }
+
+    void registerLocation(SourceLocation loc) {
+        if (!isRawBuffer(loc.buffer()))
+            getBufferIndex(loc.buffer());
+    }
+
+    size_t getBufferIndex(BufferID buffer) {
+        if (auto it = bufferMap.find(buffer.getId()); it != bufferMap.end())
+            return it->second;
+
+        // Any buffers that this one depends on are registered first, which ensures
+        // that they get created first when reading the table back in.
+        BufferEntry entry;
+        entry.id = buffer;
+
+        SourceLocation loc(buffer, 0);
+        if (sourceManager.isMacroLoc(loc)) {
+            entry.kind = BufferKind::Expansion;
+            entry.originalLoc = sourceManager.getOriginalLoc(loc);
+            entry.expansionRange = sourceManager.getExpansionRange(loc);
+            entry.isMacroArg = sourceManager.isMacroArgLoc(loc);
+            if (!entry.isMacroArg)
+                entry.macroName = sourceManager.getMacroName(loc);
+
+            registerLocation(entry.originalLoc);
+            registerLocation(entry.expansionRange.start());
+            registerLocation(entry.expansionRange.end());
+        }
+        else {
+            entry.text = sourceManager.getSourceText(buffer);
+            if (buffer == rootBuffer) {
+                entry.kind = BufferKind::Root;
+            }
+            else if (auto includedFrom = sourceManager.getIncludedFrom(buffer);
+                     includedFrom.valid()) {
+                if (sourceManager.getLibraryFor(buffer) != rootLibrary)
+                    failed = true;
+
+                entry.kind = BufferKind::Include;
+                registerLocation(includedFrom);
+            }
+            else if (!sourceManager.getFullPath(buffer).is_absolute()) {
+                // Buffers assigned from memory, such as those holding
+                // predefined macros, get their text stored directly.
+                entry.kind = BufferKind::Text;
+            }
+            else {
+                // Some other file that wasn't included from this one;
+                // we don't support serializing multi-file trees.
+                failed = true;
+            }
+        }
+
+        size_t index = buffers.size();
+        if (!entry.text.empty())
+            textBuffers.push_back(index);
+
+        buffers.push_back(entry);
+        bufferMap.emplace(buffer.getId(), index);
+        return index;
+    }
+
+    void writeBufferTable(ByteWriter& writer) {
+        flat_hash_map<uint32_t, std::vector<SourceManager::DiagnosticDirectiveInfo>> diagDirectives;
+        sourceManager.visitDiagnosticDirectives([&](BufferID buffer, auto& directives) {
+            if (bufferMap.contains(buffer.getId()))
+                diagDirectives[buffer.getId()].assign(directives.begin(), directives.end());
+        });
+
+        auto writeDiagDirectives = [&](BufferID buffer) {
+            auto it = diagDirectives.find(buffer.getId());
+            if (it == diagDirectives.end()) {
+                writer.writeVarint(0);
+                return;
+            }
+
+            writer.writeVarint(it->second.size());
+            for (auto& info : it->second) {
+                writer.writeString(info.name);
+                writer.writeVarint(info.offset);
+                writer.writeByte(uint8_t(info.severity));
+            }
+        };
+
+        writer.writeVarint(buffers.size());
+        for (size_t i = 0; i < buffers.size(); i++) {
+            auto& entry = buffers[i];
+            writer.writeByte(uint8_t(entry.kind));
+            switch (entry.kind) {
+                case BufferKind::Root:
+                    writer.writeU64(hashText(entry.text));
+                    writer.writeVarint(entry.text.size());
+                    writeDiagDirectives(entry.id);
+                    break;
+                case BufferKind::Include: {
+                    auto includedFrom = sourceManager.getIncludedFrom(entry.id);
+                    auto it = includes.find(includedFrom);
+                    if (it == includes.end()) {
+                        failed = true;
+                        return;
+                    }
+
+                    writer.writeString(it->second.first);
+                    writer.writeByte(it->second.second);
+                    writeTableLocation(writer, includedFrom);
+                    writer.writeString(getU8Str(sourceManager.getFullPath(entry.id)));
+                    writer.writeU64(hashText(entry.text));
+                    writer.writeVarint(entry.text.size());
+                    writeDiagDirectives(entry.id);
+                    break;
+                }
+                case BufferKind::Text: {
+                    // Buffers created by the preprocessor are given a name via a
+                    // line directive that we need to recreate.
+                    SourceLocation start(entry.id, 0);
+                    auto name = sourceManager.getFileName(start);
+                    if (name == sourceManager.getRawFileName(entry.id))
+                        name = {};
+
+                    writer.writeString(entry.text);
+                    writer.writeString(name);
+                    break;
+                }
+                case BufferKind::Expansion:
+                    writeTableLocation(writer, entry.originalLoc);
+                    writeTableLocation(writer, entry.expansionRange.start());
+                    writeTableLocation(writer, entry.expansionRange.end());
+                    writer.writeByte(entry.isMacroArg);
+                    writer.writeString(entry.macroName);
+                    break;
+            }
+        }
+    }
+
+    const SourceManager& sourceManager;
+    BufferID rootBuffer;
+    const SourceLibrary* rootLibrary = nullptr;
+    ByteWriter stream;
+
+    std::vector<BufferEntry> buffers;
+    flat_hash_map<uint32_t, size_t> bufferMap;
+    std::vector<size_t> textBuffers;
+    size_t lastTextBuffer = 0;
+
+    struct LastText {
+        const char* end;
+        const char* bufferEnd;
+    };
+    std::optional<LastText> lastText;
+    std::pair<size_t, size_t> lastLocation{SIZE_MAX, 0};
+
+    flat_hash_map<SourceLocation, std::pair<std::string_view, bool>> includes;
+    flat_hash_map<const SyntaxNode*, uint32_t> refIds;
+    uint32_t nextRefId = 0;
+};
+
+class SyntaxReader {
+public:
+    SyntaxReader(std::span<const char> data, SourceManager& sourceManager, BumpAllocator& alloc,
+                 const SourceBuffer& rootBuffer) :
+        ptr(data.data()),
+        end(data.data() + data.size()), sourceManager(sourceManager), alloc(alloc),
+        rootBuffer(rootBuffer) {}
+
+    bool readHeader() {
+        if (size_t(end - ptr) < Magic.size() || std::string_view(ptr, Magic.size()) != Magic)
+            return false;
+
+        ptr += Magic.size();
+        if (readVarint() != FormatVersion || readString() != VersionInfo::getHash())
+            return false;
+
+        auto hash = readU64();
+        return !failed && hash == hashText(std::string_view(ptr, size_t(end - ptr)));
+    }
+
+    bool readBufferTable() {
+        // The whole table is read and checked before anything is added to the
+        // source manager, so that a stale or corrupt entry doesn't leave extra
+        // buffers, line directives or expansions behind when the caller falls
+        // back to parsing the file.
+        auto count = readVarint();
+        if (failed || count > size_t(end - ptr))
+            return false;
+
+        std::vector<TableEntry> entries(count);
+        for (size_t i = 0; i < entries.size(); i++) {
+            if (!readTableEntry(std::span(entries).first(i), entries[i]))
+                return false;
+        }
+
+        // Resolving includes is the only step that can still fail, and the only
+        // side effect of a failure is that the header stays loaded in the source
+        // manager's file cache, where the preprocessor will find it again.
+        buffers.resize(entries.size());
+        for (size_t i = 0; i < entries.size(); i++) {
+            auto& entry = entries[i];
+            if (entry.kind == BufferKind::Root) {
+                buffers[i].id = rootBuffer.id;
+                buffers[i].text = rootBuffer.data;
+            }
+            else if (entry.kind == BufferKind::Include) {
+                // Resolve the include again, since search paths or the file
+                // itself may have changed since the tree was serialized.
+                auto buffer = sourceManager.readHeader(entry.path, resolve(entry.locs[0]),
+                                                       rootBuffer.library, entry.flag);
+                if (!buffer || getU8Str(sourceManager.getFullPath(buffer->id)) != entry.fullPath ||
+                    !matches(buffer->data, entry.hash, entry.size)) {
+                    return false;
+                }
+
+                buffers[i].id = buffer->id;
+                buffers[i].text = buffer->data;
+            }
+        }
+
+        for (size_t i = 0; i < entries.size(); i++) {
+            auto& entry = entries[i];
+            if (entry.kind == BufferKind::Text) {
+                auto buffer = sourceManager.assignText(entry.text);
+                if (!entry.name.empty()) {
+                    sourceManager.addLineDirective(SourceLocation(buffer.id, 0), 2, entry.name,
+                                                   0);
+                }
+
+                buffers[i].id = buffer.id;
+                buffers[i].text = buffer.data;
+            }
+            else if (entry.kind == BufferKind::Expansion) {
+                SourceRange range(resolve(entry.locs[1]), resolve(entry.locs[2]));
+                SourceLocation loc;
+                if (entry.flag)
+                    loc = sourceManager.createExpansionLoc(resolve(entry.locs[0]), range, true);
+                else
+                    loc = sourceManager.createExpansionLoc(resolve(entry.locs[0]), range,
+                                                           entry.name);
+
+                buffers[i].id = loc.buffer();
+            }
+
+            bufferMap.emplace(buffers[i].id.getId(), i);
+        }
+
+        lastLocation = {SIZE_MAX, 0};
+        return true;
+    }
+
+    void applyDiagnosticDirectives() {
+        for (auto& directive : pendingDirectives) {
+            sourceManager.addDiagnosticDirective(
+                SourceLocation(buffers[directive.bufferIndex].id, directive.offset),
+                directive.name, directive.severity);
+        }
+    }
+
+    Token readToken() {
+        auto flags = readByte();
+        if (!flags)
+            return Token();
+
+        auto kind = TokenKind(readVarint());
+        auto loc = readLocation();
+
+        std::span<Trivia const> trivia;
+        if (auto count = readVarint()) {
+            SmallVector<Trivia, 8> buffer(count, UninitializedTag());
+            for (uint64_t i = 0; i < count; i++)
+                buffer.push_back(readTrivia());
+            trivia = buffer.copy(alloc);
+        }
+
+        auto rawText = readText(kind, loc);
+
+        Token result;
+        switch (kind) {
+            case TokenKind::StringLiteral:
+                result = Token(alloc, kind, trivia, rawText, loc,
+                               readText(TokenKind::Unknown, SourceLocation()));
+                break;
+            case TokenKind::Directive:
+            case TokenKind::MacroUsage:
+                result = Token(alloc, kind, trivia, rawText, loc, SyntaxKind(readVarint()));
+                break;
+            case TokenKind::UnbasedUnsizedLiteral:
+                result = Token(alloc, kind, trivia, rawText, loc, logic_t(readByte()));
+                break;
+            case TokenKind::IntegerLiteral: {
+                auto bits = bitwidth_t(readVarint());
+                auto valueFlags = readByte();
+                SVIntStorage storage(bits, (valueFlags & 1) != 0, (valueFlags & 2) != 0);
+
+                uint32_t numWords = (bits + 63) / 64;
+                if (storage.unknownFlag)
+                    numWords *= 2;
+                SmallVector<uint64_t> words(numWords, UninitializedTag());
+                for (uint32_t i = 0; i < numWords; i++)
+                    words.push_back(readU64());
+
+                if (numWords == 1)
+                    storage.val = words[0];
+                else
+                    storage.pVal = words.data();
+
+                result = Token(alloc, kind, trivia, rawText, loc, SVInt(storage));
+                break;
+            }
+            case TokenKind::RealLiteral:
+            case TokenKind::TimeLiteral: {
+                double value;
+                readRaw(&value, sizeof(value));
+
+                NumericTokenFlags numFlags{readByte()};
+                std::optional<TimeUnit> unit;
+                if (kind == TokenKind::TimeLiteral)
+                    unit = numFlags.unit();
+
+                result = Token(alloc, kind, trivia, rawText, loc, value, numFlags.outOfRange(),
+                               unit);
+                break;
+            }
+            case TokenKind::IntegerBase: {
+                NumericTokenFlags numFlags{readByte()};
+                result = Token(alloc, kind, trivia, rawText, loc, numFlags.base(),
+                               numFlags.isSigned());
+                break;
+            }
+            default:
+                result = Token(alloc, kind, trivia, rawText, loc);
+                break;
+        }
+
+        if (flags == 2)
+            result = Token::createMissing(alloc, kind, loc).withTrivia(alloc, trivia);
+        return result;
+    }
+
+    TokenList readTokenList() {
+        readVarint();
+        auto count = readVarint();
+        SmallVector<Token> buffer(count, UninitializedTag());
+        for (uint64_t i = 0; i < count; i++)
+            buffer.push_back(readToken());
+        return buffer.copy(alloc);
+    }
+
+    template<typename T>
+    T* readNode() {
+        auto node = readAnyNode();
+        if (!node)
+            return nullptr;
+
+        if (!T::isKind(node->kind)) {
+            failed = true;
+            return nullptr;
+        }
+        return &node->as<T>();
+    }
+
+    template<typename T>
+    SyntaxList<T> readList() {
+        readVarint();
+        return readListElements<T>();
+    }
+
+    template<typename T>
+    SeparatedSyntaxList<T> readSeparatedList() {
+        readVarint();
+        return readSeparatedListElements<T>();
+    }
+
+    SyntaxNode* readNodeRef() {
+        auto id = readVarint();
+        if (id >= refs.size()) {
+            failed = true;
+            return nullptr;
+        }
+        return refs[id];
+    }
+
+    Diagnostics readDiagnostics() {
+        Diagnostics diagnostics;
+        auto count = readVarint();
+        for (uint64_t i = 0; i < count && !failed; i++)
+            diagnostics.emplace_back(readDiagnostic());
+        return diagnostics;
+    }
+
+    std::vector<const DefineDirectiveSyntax*> readMacros() {
+        std::vector<const DefineDirectiveSyntax*> macros;
+        auto count = readVarint();
+        for (uint64_t i = 0; i < count && !failed; i++) {
+            if (auto macro = readNode<DefineDirectiveSyntax>())
+                macros.push_back(macro);
+        }
+        return macros;
+    }
+
+    ParserMetadata readMetadata() {
+        ParserMetadata meta;
+        auto count = readVarint();
+        meta.nodeMap.reserve(count);
+        for (uint64_t i = 0; i < count && !failed; i++) {
+            auto node = readNodeRef();
+            auto& info = meta.nodeMap[node];
+            info.library = readByte() ? rootBuffer.library : nullptr;
+            info.defaultNetType = TokenKind(readVarint());
+            info.unconnectedDrive = TokenKind(readVarint());
+            if (readByte()) {
+                TimeScale ts;
+                ts.base.unit = TimeUnit(readByte());
+                ts.base.magnitude = TimeScaleMagnitude(readByte());
+                ts.precision.unit = TimeUnit(readByte());
+                ts.precision.magnitude = TimeScaleMagnitude(readByte());
+                info.timeScale = ts;
+            }
+        }
+
+        count = readVarint();
+        for (uint64_t i = 0; i < count; i++)
+            meta.globalInstances.emplace(readText(TokenKind::Unknown, SourceLocation()));
+
+        auto readRefs = [&](auto& list) {
+            using T = std::remove_pointer_t<typename std::decay_t<decltype(list)>::value_type>;
+            auto refCount = readVarint();
+            list.reserve(refCount);
+            for (uint64_t i = 0; i < refCount; i++) {
+                if (auto node = readNodeRef())
+                    list.push_back(&node->as<std::remove_const_t<T>>());
+            }
+        };
+        readRefs(meta.classPackageNames);
+        readRefs(meta.packageImports);
+        readRefs(meta.classDecls);
+        readRefs(meta.interfacePorts);
+
+        meta.eofToken = readToken();
+        meta.hasDefparams = readByte();
+        meta.hasBindDirectives = readByte();
+        return meta;
+    }
+
+    uint64_t readVarint() {
+        uint64_t result = 0;
+        for (int shift = 0; ptr != end && shift < 64; shift += 7) {
+            auto b = uint8_t(*ptr++);
+            result |= uint64_t(b & 0x7f) << shift;
+            if ((b & 0x80) == 0)
+                return result;
+        }
+
+        failed = true;
+        return 0;
+    }
+
+    bool atEnd() const { return ptr == end; }
+
+    bool failed = false;
+
+private:
+    struct BufferEntry {
+        BufferID id;
+        std::string_view text;
+    };
+
+    // A location in the buffer table, which refers to an earlier entry by
+    // index, or to a raw buffer ID when index is SIZE_MAX.
+    struct TableLocation {
+        size_t index = SIZE_MAX;
+        uint32_t rawId = 0;
+        size_t offset = 0;
+    };
+
+    // A buffer table entry as read from the data, before anything for it
+    // has been created in the source manager.
+    struct TableEntry {
+        BufferKind kind;
+        std::string_view path;
+        std::string_view fullPath;
+        std::string_view text;
+        std::string_view name;
+        uint64_t hash = 0;
+        uint64_t size = 0;
+        bool flag = false;
+        TableLocation locs[3];
+    };
+
+    // Diagnostic directives are only applied once we know the whole tree was
+    // read successfully, since otherwise the caller will fall back to parsing
+    // the file and the preprocessor will add them again.
+    struct PendingDirective {
+        size_t bufferIndex;
+        size_t offset;
+        std::string_view name;
+        DiagnosticSeverity severity;
+    };
+
+    static bool matches(std::string_view text, uint64_t hash, uint64_t size) {
+        return text.size() == size && hashText(text) == hash;
+    }
+
+    bool readTableEntry(std::span<const TableEntry> prevEntries, TableEntry& entry) {
+        auto index = prevEntries.size();
+        auto readDiagDirectives = [&] {
+            auto count = readVarint();
+            for (uint64_t i = 0; i < count && !failed; i++) {
+                auto name = copyText(readString());
+                auto offset = readVarint();
+                auto severity = DiagnosticSeverity(readByte());
+                pendingDirectives.push_back({index, offset, name, severity});
+            }
+        };
+
+        // Entries only refer to the ones before them, which is the
+        // order in which they get created.
+        auto readTableLocation = [&](TableLocation& loc, bool allowRaw) {
+            auto tag = readVarint();
+            if (tag == RawLocation && allowRaw)
+                loc.rawId = uint32_t(readVarint());
+            else if (tag >= FirstBufferLocation && tag - FirstBufferLocation < index)
+                loc.index = size_t(tag - FirstBufferLocation);
+            else
+                failed = true;
+            loc.offset = readVarint();
+        };
+
+        entry.kind = BufferKind(readByte());
+        switch (entry.kind) {
+            case BufferKind::Root:
+                entry.hash = readU64();
+                entry.size = readVarint();
+                if (failed || !matches(rootBuffer.data, entry.hash, entry.size))
+                    return false;
+
+                readDiagDirectives();
+                break;
+            case BufferKind::Include:
+                entry.path = readString();
+                entry.flag = readByte();
+                readTableLocation(entry.locs[0], false);
+                entry.fullPath = readString();
+                entry.hash = readU64();
+                entry.size = readVarint();
+                readDiagDirectives();
+
+                // Includes are resolved before any text or expansion buffers
+                // get created, so they can only be included from files.
+                if (!failed) {
+                    auto fromKind = prevEntries[entry.locs[0].index].kind;
+                    if (fromKind != BufferKind::Root && fromKind != BufferKind::Include)
+                        return false;
+                }
+                break;
+            case BufferKind::Text:
+                entry.text = readString();
+                entry.name = readString();
+                break;
+            case BufferKind::Expansion:
+                readTableLocation(entry.locs[0], true);
+                readTableLocation(entry.locs[1], true);
+                readTableLocation(entry.locs[2], true);
+                entry.flag = readByte();
+                entry.name = copyText(readString());
+                break;
+            default:
+                return false;
+        }
+        return !failed;
+    }
+
+    SourceLocation resolve(const TableLocation& loc) const {
+        if (loc.index == SIZE_MAX)
+            return SourceLocation(BufferID(loc.rawId, ""sv), loc.offset);
+        return SourceLocation(buffers[loc.index].id, loc.offset);
+    }
+
+    SyntaxNode* readAnyNode() {
+        auto header = readVarint();
+        if (header == NullNodeHeader)
+            return nullptr;
+
+        if (header == NodeRefHeader)
+            return readNodeRef();
+
+        if (failed)
+            return nullptr;
+
+        header -= FirstKindHeader;
+        auto kind = SyntaxKind(header >> 1);
+
+        SyntaxNode* node;
+        switch (kind) {
+            case SyntaxKind::SyntaxList:
+                node = alloc.emplace<SyntaxList<SyntaxNode>>(readListElements<SyntaxNode>());
+                break;
+            case SyntaxKind::SeparatedList:
+                node = alloc.emplace<SeparatedSyntaxList<SyntaxNode>>(
+                    readSeparatedListElements<SyntaxNode>());
+                break;
+            case SyntaxKind::TokenList: {
+                auto count = readVarint();
+                SmallVector<Token> buffer(count, UninitializedTag());
+                for (uint64_t i = 0; i < count; i++)
+                    buffer.push_back(readToken());
+                node = alloc.emplace<TokenList>(buffer.copy(alloc));
+                break;
+            }
+            default:
+                node = detail::deserializeSyntax(kind, *this, alloc);
+                if (!node) {
+                    failed = true;
+                    return nullptr;
+                }
+                break;
+        }
+
+        if (header & 1)
+            refs.push_back(node);
+
+        return node;
+    }
+
+    template<typename T>
+    std::span<T*> readListElements() {
+        auto count = readVarint();
+        SmallVector<T*> buffer(count, UninitializedTag());
+        for (uint64_t i = 0; i < count; i++)
+            buffer.push_back(readNode<T>());
+        return buffer.copy(alloc);
+    }
+
+    template<typename T>
+    std::span<TokenOrSyntax> readSeparatedListElements() {
+        auto count = readVarint();
+        SmallVector<TokenOrSyntax> buffer(count, UninitializedTag());
+        for (uint64_t i = 0; i < count; i++) {
+            if (i % 2 == 0)
+                buffer.push_back(readNode<T>());
+            else
+                buffer.push_back(readToken());
+        }
+        return buffer.copy(alloc);
+    }
+
+    Diagnostic readDiagnostic() {
+        auto subsystem = DiagSubsystem(readVarint());
+        auto code = uint16_t(readVarint());
+        Diagnostic diag(DiagCode(subsystem, code), readLocation());
+
+        auto count = readVarint();
+        for (uint64_t i = 0; i < count && !failed; i++) {
+            switch (readByte()) {
+                case 0:
+                    diag.args.emplace_back(std::string(readString()));
+                    break;
+                case 1:
+                    diag.args.emplace_back(int64_t(readU64()));
+                    break;
+                case 2:
+                    diag.args.emplace_back(readU64());
+                    break;
+                case 3:
+                    diag.args.emplace_back(char(readByte()));
+                    break;
+                default:
+                    failed = true;
+                    break;
+            }
+        }
+
+        count = readVarint();
+        for (uint64_t i = 0; i < count && !failed; i++) {
+            auto start = readLocation();
+            auto end = readLocation();
+            diag.ranges.emplace_back(start, end);
+        }
+
+        count = readVarint();
+        for (uint64_t i = 0; i < count && !failed; i++)
+            diag.notes.emplace_back(readDiagnostic());
+
+        if (readByte())
+            diag.coalesceCount = size_t(readVarint());
+
+        return diag;
+    }
+
+    Trivia readTrivia() {
+        auto header = readByte();
+        auto kind = TriviaKind(header & ~HasLocationBit);
+        switch (kind) {
+            case TriviaKind::Directive:
+            case TriviaKind::SkippedSyntax: {
+                auto node = readNode<SyntaxNode>();
+                if (!node) {
+                    failed = true;
+                    return Trivia();
+                }
+
+                if (node->kind == SyntaxKind::LineDirective)
+                    applyLineDirective(node->as<LineDirectiveSyntax>());
+                return Trivia(kind, node);
+            }
+            case TriviaKind::SkippedTokens: {
+                auto count = readVarint();
+                SmallVector<Token> buffer(count, UninitializedTag());
+                for (uint64_t i = 0; i < count; i++)
+                    buffer.push_back(readToken());
+                return Trivia(kind, buffer.copy(alloc));
+            }
+            default: {
+                bool hasLocation = (header & HasLocationBit) != 0;
+                SourceLocation loc;
+                if (hasLocation)
+                    loc = readLocation();
+
+                Trivia result(kind, readText(TokenKind::Unknown, loc));
+                if (hasLocation)
+                    result = result.withLocation(alloc, loc);
+                return result;
+            }
+        }
+    }
+
+    // Mirrors the handling of `line directives in the preprocessor, which
+    // informs the source manager about well formed directives.
+    void applyLineDirective(const LineDirectiveSyntax& directive) {
+        if (directive.lineNumber.isMissing() || directive.fileName.isMissing() ||
+            directive.level.isMissing()) {
+            return;
+        }
+
+        auto levNum = directive.level.intValue().as<uint8_t>();
+        auto lineNum = directive.lineNumber.intValue().as<size_t>();
+        if (levNum && *levNum <= 2 && lineNum && *lineNum) {
+            sourceManager.addLineDirective(directive.directive.location(), *lineNum,
+                                           directive.fileName.valueText(), *levNum);
+        }
+    }
+
+    SourceLocation readLocation() {
+        auto tag = readVarint();
+        if (tag == RawLocation) {
+            auto id = uint32_t(readVarint());
+            return SourceLocation(BufferID(id, ""sv), readVarint());
+        }
+
+        size_t offset;
+        if (tag == RelativeLocation) {
+            if (lastLocation.first >= buffers.size()) {
+                failed = true;
+                return SourceLocation();
+            }
+            offset = size_t(int64_t(lastLocation.second) + zigzagDecode(readVarint()));
+        }
+        else {
+            lastLocation.first = size_t(tag - FirstBufferLocation);
+            offset = readVarint();
+            if (lastLocation.first >= buffers.size()) {
+                failed = true;
+                return SourceLocation();
+            }
+        }
+
+        lastLocation.second = offset;
+        return SourceLocation(buffers[lastLocation.first].id, offset);
+    }
+
+    std::string_view readText(TokenKind kind, SourceLocation loc) {
+        std::string_view result;
+        switch (TextKind(readByte())) {
+            case TextKind::KindText: {
+                // Mirrors the writer's tracking of the token's position in the source.
+                result = LexerFacts::getTokenKindText(kind);
+                lastText = {SIZE_MAX, 0};
+                if (auto it = bufferMap.find(loc.buffer().getId()); it != bufferMap.end()) {
+                    auto text = buffers[it->second].text;
+                    if (text.substr(std::min(size_t(loc.offset()), text.size()))
+                            .starts_with(result)) {
+                        lastText = {it->second, loc.offset() + result.size()};
+                    }
+                }
+                break;
+            }
+            case TextKind::Adjacent:
+                result = bufferText(lastText.first, lastText.second, readVarint());
+                break;
+            case TextKind::AtLocation: {
+                auto it = bufferMap.find(loc.buffer().getId());
+                result = bufferText(it == bufferMap.end() ? SIZE_MAX : it->second, loc.offset(),
+                                    readVarint());
+                break;
+            }
+            case TextKind::InBuffer: {
+                auto index = readVarint();
+                auto offset = readVarint();
+                result = bufferText(index, offset, readVarint());
+                break;
+            }
+            default:
+                return copyText(readString());
+        }
+        return result;
+    }
+
+    std::string_view bufferText(uint64_t index, uint64_t offset, uint64_t size) {
+        if (index >= buffers.size() || offset > buffers[index].text.size() ||
+            size > buffers[index].text.size() - offset) {
+            failed = true;
+            return {};
+        }
+
+        lastText = {size_t(index), size_t(offset + size)};
+        return buffers[index].text.substr(offset, size);
+    }
+
+    std::string_view readString() {
+        auto size = readVarint();
+        if (size_t(end - ptr) < size) {
+            failed = true;
+            return {};
+        }
+
+        std::string_view result(ptr, size);
+        ptr += size;
+        return result;
+    }
+
+    std::string_view copyText(std::string_view text) {
+        if (text.empty())
+            return {};
+
+        auto mem = (char*)alloc.allocate(text.size(), 1);
+        memcpy(mem, text.data(), text.size());
+        return std::string_view(mem, text.size());
+    }
+
+    uint8_t readByte() {
+        if (ptr == end) {
+            failed = true;
+            return 0;
+        }
+        return uint8_t(*ptr++);
+    }
+
+    uint64_t readU64() {
+        uint64_t result = 0;
+        readRaw(&result, sizeof(result));
+        return result;
+    }
+
+    void readRaw(void* dest, size_t size) {
+        if (size_t(end - ptr) < size) {
+            failed = true;
+            return;
+        }
+
+        memcpy(dest, ptr, size);
+        ptr += size;
+    }
+
+    const char* ptr;
+    const char* end;
+    SourceManager& sourceManager;
+    BumpAllocator& alloc;
+    const SourceBuffer& rootBuffer;
+    std::vector<BufferEntry> buffers;
+    std::vector<SyntaxNode*> refs;
+    SmallVector<PendingDirective> pendingDirectives;
+    flat_hash_map<uint32_t, size_t> bufferMap;
+    std::pair<size_t, size_t> lastLocation{SIZE_MAX, 0};
+    std::pair<size_t, size_t> lastText{SIZE_MAX, 0};
+};
+
+} // namespace
+
+std::optional<std::vector<char>> SyntaxTree::serialize() const {
+    // Only self-contained trees parsed from a single buffer without errors
+    // can be reconstructed later. Errors can depend on things not captured
+    // in the serialized data, such as include files that couldn't be found.
+    if (parentTree || std::ranges::any_of(diagnosticsBuffer,
+                                          [](auto& diag) { return diag.isError(); })) {
+        return std::nullopt;
+    }
+
+    auto& meta = getMetadata();
+    auto rootBuffer = meta.eofToken.location().buffer();
+    if (!meta.eofToken || isRawBuffer(rootBuffer) ||
+        !sourceMan.isFileLoc(SourceLocation(rootBuffer, 0))) {
+        return std::nullopt;
+    }
+
+    SyntaxWriter writer(sourceMan, rootBuffer);
+    for (auto& [node, _] : meta.nodeMap)
+        writer.addReferencedNode(node);
+    for (auto node : meta.classPackageNames)
+        writer.addReferencedNode(node);
+    for (auto node : meta.packageImports)
+        writer.addReferencedNode(node);
+    for (auto node : meta.classDecls)
+        writer.addReferencedNode(node);
+    for (auto node : meta.interfacePorts)
+        writer.addReferencedNode(node);
+    for (auto node : macros)
+        writer.addReferencedNode(node);
+
+    writer.writeNode(rootNode);
+    writer.writeMetadata(meta);
+    writer.writeMacros(macros);
+    writer.writeDiagnostics(diagnosticsBuffer);
+
+    auto result = writer.finish();
+    if (writer.failed)
+        return std::nullopt;
+
+    return result;
+}
+
+std::shared_ptr<SyntaxTree> SyntaxTree::fromSerialized(std::span<const char> data,
+                                                      const SourceBuffer& buffer,
+                                                      SourceManager& sourceManager,
+                                                      const Bag& options) {
+    BumpAllocator alloc;
+    SyntaxReader reader(data, sourceManager, alloc, buffer);
+    if (!reader.readHeader() || !reader.readBufferTable())
+        return nullptr;
+
+    auto root = reader.readNode<SyntaxNode>();
+    auto metadata = reader.readMetadata();
+    auto macros = reader.readMacros();
+    auto diagnostics = reader.readDiagnostics();
+    if (reader.failed || !root || !reader.atEnd())
+        return nullptr;
+
+    reader.applyDiagnosticDirectives();
+    return std::shared_ptr<SyntaxTree>(new SyntaxTree(root, sourceManager, std::move(alloc),
+                                                      std::move(diagnostics), std::move(metadata),
+                                                      std::move(macros), options));
+}
+
+} // namespace slang::syntax
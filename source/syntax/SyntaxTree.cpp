@@ -10,7 +10,9 @@
 #include "slang/parsing/Parser.h"
 #include "slang/parsing/ParserMetadata.h"
 #include "slang/parsing/Preprocessor.h"
+#include "slang/syntax/AllSyntax.h"
 #include "slang/text/SourceManager.h"
+#include "slang/util/ThreadPool.h"
 #include "slang/util/TimeTrace.h"
 
 namespace slang::syntax {
@@ -104,6 +106,142 @@ std::shared_ptr<SyntaxTree> SyntaxTree::fromBuffers(std::span<const SourceBuffer
     return create(sourceManager, buffers, options, inheritedMacros, false);
 }
 
+namespace {
+
+// Gets the part of a token recording that came from the source at the given index,
+// ending with an end-of-file token. Trivia at the end of each source was already
+// moved to the first token that follows it, so the added end-of-file tokens for
+// all but the last source have none.
+Preprocessor::TokenRecording sliceRecording(const Preprocessor::TokenRecording& recording,
+                                            size_t index, const SourceBuffer& buffer,
+                                            BumpAllocator& alloc) {
+    const bool isLast = index == recording.sourceStarts.size() - 1;
+    const size_t start = recording.sourceStarts[index];
+    const size_t end = isLast ? recording.tokens.size() : recording.sourceStarts[index + 1];
+
+    Preprocessor::TokenRecording result;
+    result.tokens.assign(recording.tokens.begin() + ptrdiff_t(start),
+                         recording.tokens.begin() + ptrdiff_t(end));
+    if (!isLast) {
+        result.tokens.push_back(Token(alloc, TokenKind::EndOfFile, {}, ""sv,
+                                      SourceLocation(buffer.id, buffer.data.size())));
+    }
+
+    // Start from whatever state was in effect at the first token.
+    for (auto state : recording.states) {
+        if (state.tokenIndex >= end && !result.states.empty())
+            break;
+
+        if (state.tokenIndex <= start)
+            result.states.clear();
+
+        state.tokenIndex = state.tokenIndex <= start ? 0 : state.tokenIndex - start;
+        result.states.push_back(state);
+    }
+
+    result.sourceStarts.push_back(0);
+    return result;
+}
+
+} // namespace
+
+std::shared_ptr<SyntaxTree> SyntaxTree::fromBuffers(std::span<const SourceBuffer> buffers,
+                                                    SourceManager& sourceManager,
+                                                    ThreadPool& threadPool, const Bag& options,
+                                                    MacroList inheritedMacros) {
+    if (buffers.size() < 2)
+        return create(sourceManager, buffers, options, inheritedMacros, false);
+
+    TimeTraceScope timeScope("parseFilesParallel"sv, ""sv);
+
+    // First preprocess all of the buffers on this thread, exactly as a serial parse
+    // would, and record the resulting tokens along with where each buffer starts.
+    // This is the only pass over the source text, so includes, macro expansions,
+    // and line directives are only registered with the source manager once.
+    BumpAllocator alloc;
+    Diagnostics diagnostics;
+    Preprocessor preprocessor(sourceManager, alloc, diagnostics, options, inheritedMacros);
+    for (auto it = buffers.rbegin(); it != buffers.rend(); it++)
+        preprocessor.pushSource(*it);
+
+    auto recording = preprocessor.recordTokens();
+    auto parseRecording = [&] {
+        Preprocessor replay(sourceManager, alloc, diagnostics, recording);
+        Parser parser(replay, options);
+        auto& root = parser.parseCompilationUnit();
+        return std::shared_ptr<SyntaxTree>(new SyntaxTree(&root, sourceManager, std::move(alloc),
+                                                          std::move(diagnostics),
+                                                          parser.getMetadata(),
+                                                          preprocessor.getDefinedMacros(), options));
+    };
+
+    const size_t numBuffers = buffers.size();
+    if (recording.sourceStarts.size() != numBuffers)
+        return parseRecording();
+
+    // Now parse the tokens of each buffer in parallel.
+    struct BufferResult {
+        BumpAllocator alloc;
+        Diagnostics diagnostics;
+        CompilationUnitSyntax* root = nullptr;
+        ParserMetadata metadata;
+    };
+
+    std::vector<BufferResult> results(numBuffers);
+    threadPool.pushLoop(size_t(0), numBuffers, [&](size_t start, size_t end) {
+        for (size_t i = start; i < end; i++) {
+            auto& result = results[i];
+            auto slice = sliceRecording(recording, i, buffers[i], result.alloc);
+            Preprocessor replay(sourceManager, result.alloc, result.diagnostics, slice);
+            Parser parser(replay, options);
+            result.root = &parser.parseCompilationUnit();
+            result.metadata = parser.getMetadata();
+        }
+    });
+    threadPool.waitForAll();
+
+    // If any buffer can't be parsed on its own, such as when a module or a
+    // conditional directive spans more than one buffer, parse all of the
+    // recorded tokens together instead.
+    for (auto& result : results) {
+        if (std::ranges::any_of(result.diagnostics, [](auto& d) { return d.isError(); }))
+            return parseRecording();
+    }
+
+    // Stitch the results together into a single compilation unit.
+    ParserMetadata metadata;
+    SmallVector<MemberSyntax*> members;
+    for (auto& result : results) {
+        members.append_range(result.root->members);
+
+        auto& meta = result.metadata;
+        metadata.nodeMap.insert(meta.nodeMap.begin(), meta.nodeMap.end());
+        metadata.globalInstances.insert(meta.globalInstances.begin(), meta.globalInstances.end());
+        metadata.classPackageNames.insert(metadata.classPackageNames.end(),
+                                          meta.classPackageNames.begin(),
+                                          meta.classPackageNames.end());
+        metadata.packageImports.insert(metadata.packageImports.end(), meta.packageImports.begin(),
+                                       meta.packageImports.end());
+        metadata.classDecls.insert(metadata.classDecls.end(), meta.classDecls.begin(),
+                                   meta.classDecls.end());
+        metadata.interfacePorts.insert(metadata.interfacePorts.end(), meta.interfacePorts.begin(),
+                                       meta.interfacePorts.end());
+        metadata.hasDefparams |= meta.hasDefparams;
+        metadata.hasBindDirectives |= meta.hasBindDirectives;
+
+        diagnostics.append_range(result.diagnostics);
+        alloc.steal(std::move(result.alloc));
+    }
+
+    auto eof = results.back().root->endOfFile;
+    metadata.eofToken = eof;
+
+    auto root = alloc.emplace<CompilationUnitSyntax>(members.copy(alloc), eof);
+    return std::shared_ptr<SyntaxTree>(new SyntaxTree(root, sourceManager, std::move(alloc),
+                                                      std::move(diagnostics), std::move(metadata),
+                                                      preprocessor.getDefinedMacros(), options));
+}
+
 SourceManager& SyntaxTree::getDefaultSourceManager() {
     static SourceManager instance;
     return instance;
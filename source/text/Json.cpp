@@ -8,6 +8,7 @@
 #include "slang/text/Json.h"
 
 #include <climits>
+#include <ostream>
 
 #include "slang/text/FormatBuffer.h"
 #include "slang/util/SmallVector.h"
@@ -20,6 +21,25 @@ JsonWriter::JsonWriter() : buffer(std::make_unique<FormatBuffer>()) {
 
 JsonWriter::~JsonWriter() = default;
 
+void JsonWriter::setOutput(std::ostream& os, size_t threshold) {
+    output = &os;
+    flushThreshold = threshold;
+}
+
+void JsonWriter::flush() {
+    if (!output)
+        return;
+
+    // Hold back the trailing comma (and whitespace), since closing
+    // the enclosing object or array will need to remove it.
+    size_t size = findLastComma();
+    output->write(buffer->data(), std::streamsize(size));
+
+    std::string tail(buffer->data() + size, buffer->size() - size);
+    buffer->clear();
+    buffer->append(tail);
+}
+
 std::string_view JsonWriter::view() const {
     return std::string_view(buffer->data(), findLastComma());
 }
@@ -42,6 +62,7 @@ void JsonWriter::endObject() {
     else {
         buffer->append("},");
     }
+    flushIfNeeded();
 }
 
 void JsonWriter::startArray() {
@@ -62,6 +83,7 @@ void JsonWriter::endArray() {
     else {
         buffer->append("],");
     }
+    flushIfNeeded();
 }
 
 void JsonWriter::writeProperty(std::string_view name) {
@@ -158,6 +180,12 @@ void JsonWriter::endValue() {
     buffer->append(",");
     if (pretty)
         buffer->format("\n{:{}}", "", currentIndent);
+    flushIfNeeded();
+}
+
+void JsonWriter::flushIfNeeded() {
+    if (output && buffer->size() > flushThreshold)
+        flush();
 }
 
 size_t JsonWriter::findLastComma() const {
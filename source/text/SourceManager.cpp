@@ -269,7 +269,7 @@ SourceBuffer SourceManager::assignBuffer(std::string_view bufferPath, SmallVecto
     }
 
     return cacheBuffer(std::move(path), std::move(pathStr), includedFrom, library,
-                       std::move(buffer));
+                       std::move(buffer), {});
 }
 
 SourceManager::BufferOrError SourceManager::readSource(const fs::path& path,
@@ -461,6 +461,16 @@ SourceManager::BufferOrError SourceManager::openCached(const fs::path& fullPath,
         }
     }
 
+    // Large files get mapped into memory instead of being copied onto the heap.
+    // If that doesn't work for whatever reason we fall back to a normal read,
+    // which will also report any errors with opening the file.
+    if (memoryMapThreshold) {
+        if (auto mapped = OS::mapFile(absPath, memoryMapThreshold); !mapped.empty()) {
+            return cacheBuffer(std::move(absPath), std::move(pathStr), includedFrom, library, {},
+                               mapped);
+        }
+    }
+
     // do the read
     SmallVector<char> buffer;
     if (std::error_code ec = OS::readFile(absPath, buffer)) {
@@ -470,12 +480,13 @@ SourceManager::BufferOrError SourceManager::openCached(const fs::path& fullPath,
     }
 
     return cacheBuffer(std::move(absPath), std::move(pathStr), includedFrom, library,
-                       std::move(buffer));
+                       std::move(buffer), {});
 }
 
 SourceBuffer SourceManager::cacheBuffer(fs::path&& path, std::string&& pathStr,
                                         SourceLocation includedFrom, const SourceLibrary* library,
-                                        SmallVector<char>&& buffer) {
+                                        SmallVector<char>&& buffer,
+                                        std::span<const char> mappedData) {
     std::string name;
     if (!disableProximatePaths) {
         std::error_code ec;
@@ -491,7 +502,7 @@ SourceBuffer SourceManager::cacheBuffer(fs::path&& path, std::string&& pathStr,
 
     auto directory = &*directories.insert(path.parent_path()).first;
     auto fd = std::make_unique<FileData>(directory, std::move(name), std::move(buffer),
-                                         std::move(path));
+                                         mappedData, std::move(path));
 
     // Note: it's possible that insertion here fails due to another thread
     // racing against us to open and insert the same file. We do a lookup
@@ -607,7 +618,7 @@ SourceLocation SourceManager::getOriginalLocImpl(SourceLocation location, TLock&
     return std::get<ExpansionInfo>(bufferEntries[buffer.getId()]).originalLoc + location.offset();
 }
 
-void SourceManager::computeLineOffsets(const SmallVector<char>& buffer,
+void SourceManager::computeLineOffsets(std::span<const char> buffer,
                                        std::vector<size_t>& offsets) noexcept {
     // first line always starts at offset 0
     offsets.push_back(0);
@@ -628,6 +639,11 @@ void SourceManager::computeLineOffsets(const SmallVector<char>& buffer,
     }
 }
 
+SourceManager::FileData::~FileData() {
+    if (isMapped)
+        OS::unmapFile(mem);
+}
+
 const SourceManager::LineDirectiveInfo* SourceManager::FileInfo::getPreviousLineDirective(
     size_t rawLineNumber) const {
 
@@ -12,8 +12,9 @@
 namespace slang {
 
 BumpAllocator::BumpAllocator() {
-    head = allocSegment(nullptr, INITIAL_SIZE);
+    head = tail = allocSegment(nullptr, INITIAL_SIZE);
     endPtr = (byte*)head + INITIAL_SIZE;
+    nextSegmentSize = SEGMENT_SIZE;
 }
 
 BumpAllocator::~BumpAllocator() {
@@ -26,7 +27,9 @@ BumpAllocator::~BumpAllocator() {
 }
 
 BumpAllocator::BumpAllocator(BumpAllocator&& other) noexcept :
-    head(std::exchange(other.head, nullptr)), endPtr(other.endPtr) {
+    head(std::exchange(other.head, nullptr)), tail(std::exchange(other.tail, nullptr)),
+    endPtr(other.endPtr), nextSegmentSize(other.nextSegmentSize),
+    retiredBytes(other.retiredBytes) {
 }
 
 BumpAllocator& BumpAllocator::operator=(BumpAllocator&& other) noexcept {
@@ -38,28 +41,33 @@ BumpAllocator& BumpAllocator::operator=(BumpAllocator&& other) noexcept {
 }
 
 void BumpAllocator::steal(BumpAllocator&& other) {
-    Segment* seg = other.head;
-    if (!seg)
+    if (!other.head)
         return;
 
-    while (seg->prev)
-        seg = seg->prev;
+    retiredBytes += other.getBytesAllocated();
 
-    seg->prev = head->prev;
-    head->prev = std::exchange(other.head, nullptr);
+    // Splice the other allocator's segments in behind our oldest one;
+    // none of them will be used for further allocations.
+    tail->prev = std::exchange(other.head, nullptr);
+    tail = std::exchange(other.tail, nullptr);
 }
 
 byte* BumpAllocator::allocateSlow(size_t size, size_t alignment) {
     // for really large allocations, give them their own segment
-    if (size > (SEGMENT_SIZE >> 1)) {
+    if (size > (nextSegmentSize >> 1)) {
         size = (size + alignment - 1) & ~(alignment - 1);
+        retiredBytes += size;
         head->prev = allocSegment(head->prev, size + sizeof(Segment));
+        if (tail == head)
+            tail = head->prev;
         return alignPtr(head->prev->current, alignment);
     }
 
-    // otherwise, start a new block
-    head = allocSegment(head, SEGMENT_SIZE);
-    endPtr = (byte*)head + SEGMENT_SIZE;
+    // otherwise, start a new block, growing the block size for next time
+    retiredBytes += size_t(head->current - (byte*)(head + 1));
+    head = allocSegment(head, nextSegmentSize);
+    endPtr = (byte*)head + nextSegmentSize;
+    nextSegmentSize = std::min(nextSegmentSize * 2, size_t(MAX_SEGMENT_SIZE));
     return allocate(size, alignment);
 }
 
@@ -21,6 +21,7 @@
 #    include <io.h>
 #else
 #    include <fcntl.h>
+#    include <sys/mman.h>
 #    include <sys/stat.h>
 #    include <unistd.h>
 #endif
@@ -162,6 +163,49 @@ std::error_code OS::readFile(const fs::path& path, SmallVector<char>& buffer) {
     return ec;
 }
 
+std::span<const char> OS::mapFile(const fs::path& path, size_t minSize) {
+    auto& pathStr = path.native();
+    if (pathStr == L"-")
+        return {};
+
+    HANDLE handle = ::CreateFileW(pathStr.c_str(), GENERIC_READ,
+                                  FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (handle == INVALID_HANDLE_VALUE)
+        return {};
+
+    std::span<const char> result;
+    LARGE_INTEGER size;
+    if (::GetFileType(handle) == FILE_TYPE_DISK && ::GetFileSizeEx(handle, &size)) {
+        // The rest of the final page past the end of the file is filled with zeros,
+        // which gives us the null terminator for free unless the file happens to
+        // end exactly on a page boundary.
+        SYSTEM_INFO sysInfo;
+        ::GetSystemInfo(&sysInfo);
+
+        auto fileSize = size_t(size.QuadPart);
+        if (fileSize && fileSize >= minSize && fileSize % sysInfo.dwPageSize != 0) {
+            HANDLE mapping = ::CreateFileMappingW(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+            if (mapping) {
+                if (auto ptr = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0))
+                    result = {static_cast<const char*>(ptr), fileSize + 1};
+                ::CloseHandle(mapping);
+            }
+        }
+    }
+
+    ::CloseHandle(handle);
+    return result;
+}
+
+void OS::unmapFile(std::span<const char> data) {
+    ::UnmapViewOfFile(data.data());
+}
+
+uint64_t OS::getProcessId() {
+    return ::GetCurrentProcessId();
+}
+
 #else
 
 bool OS::tryEnableColors() {
@@ -265,6 +309,49 @@ std::error_code OS::readFile(const fs::path& path, SmallVector<char>& buffer) {
     return ec;
 }
 
+std::span<const char> OS::mapFile(const fs::path& path, size_t minSize) {
+    auto& pathStr = path.native();
+    if (pathStr == "-")
+        return {};
+
+    int fd;
+    while (true) {
+        fd = ::open(pathStr.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd >= 0)
+            break;
+
+        if (errno != EINTR)
+            return {};
+    }
+
+    std::span<const char> result;
+    struct stat status;
+    if (::fstat(fd, &status) == 0 && S_ISREG(status.st_mode)) {
+        // The kernel fills the rest of the final page past the end of the file with
+        // zeros, which gives us the null terminator for free unless the file happens
+        // to end exactly on a page boundary.
+        static const size_t pageSize = size_t(::sysconf(_SC_PAGESIZE));
+
+        auto fileSize = (size_t)status.st_size;
+        if (fileSize && fileSize >= minSize && fileSize % pageSize != 0) {
+            void* ptr = ::mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (ptr != MAP_FAILED)
+                result = {static_cast<const char*>(ptr), fileSize + 1};
+        }
+    }
+
+    ::close(fd);
+    return result;
+}
+
+void OS::unmapFile(std::span<const char> data) {
+    ::munmap(const_cast<char*>(data.data()), data.size());
+}
+
+uint64_t OS::getProcessId() {
+    return uint64_t(::getpid());
+}
+
 #endif
 
 void OS::print(std::string_view text) {
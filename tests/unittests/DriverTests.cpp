@@ -5,7 +5,9 @@
 #include <fmt/core.h>
 #include <regex>
 
+#include "slang/ast/Definition.h"
 #include "slang/driver/Driver.h"
+#include "slang/util/String.h"
 
 using namespace slang::driver;
 
@@ -603,3 +605,67 @@ TEST_CASE("Driver checking for infinite library map includes") {
     CHECK(stderrContains("error: library map "));
     CHECK(stderrContains("includes itself recursively"));
 }
+
+TEST_CASE("Driver parse cache") {
+    std::error_code ec;
+    auto cacheDir = fs::temp_directory_path(ec) / "slang_parse_cache_test";
+    fs::remove_all(cacheDir, ec);
+
+    auto run = [&] {
+        auto guard = OS::captureOutput();
+
+        Driver driver;
+        driver.addStandardArgs();
+
+        auto args = fmt::format("testfoo \"{}test.sv\" --parse-cache \"{}\"", findTestDir(),
+                                getU8Str(cacheDir));
+        CHECK(driver.parseCommandLine(args));
+        CHECK(driver.processOptions());
+        CHECK(driver.parseAllSources());
+
+        auto compilation = driver.createCompilation();
+        CHECK(driver.reportCompilation(*compilation, false));
+        CHECK(stdoutContains("Build succeeded"));
+
+        driver.reportMacros();
+        return OS::capturedStdout;
+    };
+
+    auto first = run();
+
+    size_t numEntries = 0;
+    for (auto& entry : fs::directory_iterator(cacheDir, ec)) {
+        CHECK(entry.path().extension() == ".slcache");
+        numEntries++;
+    }
+    CHECK(numEntries == 1);
+
+    // The second run loads the tree from the cache and should behave the same.
+    CHECK(run() == first);
+    fs::remove_all(cacheDir, ec);
+}
+
+TEST_CASE("Driver profiling report") {
+    auto guard = OS::captureOutput();
+
+    Driver driver;
+    driver.addStandardArgs();
+
+    auto args = fmt::format("testfoo \"{}test.sv\" --profile --profile-json -", findTestDir());
+    CHECK(driver.parseCommandLine(args));
+    CHECK(driver.processOptions());
+    CHECK(driver.parseAllSources());
+
+    auto compilation = driver.createCompilation();
+    CHECK(compilation->isProfilingEnabled());
+    CHECK(driver.reportCompilation(*compilation, false));
+    CHECK(stdoutContains("Profile by phase"));
+    CHECK(stdoutContains("Profile by definition (1 of 1"));
+    CHECK(stdoutContains("\"definitions\""));
+
+    auto profiles = compilation->getDefinitionProfiles();
+    REQUIRE(profiles.size() == 1);
+    CHECK(profiles[0].definition->name == "m");
+    CHECK(profiles[0].instances == 1);
+    CHECK(profiles[0].allocatedBytes > 0);
+}
@@ -23,6 +23,27 @@ TEST_CASE("Read source") {
     CHECK(file->data.length() > 0);
 }
 
+TEST_CASE("Read source (memory mapped)") {
+    std::string testPath = getTestInclude();
+
+    SourceManager readManager;
+    readManager.setMemoryMapThreshold(0);
+    auto readFile = readManager.readSource(testPath, /* library */ nullptr);
+    REQUIRE(readFile);
+
+    SourceManager mapManager;
+    mapManager.setMemoryMapThreshold(1);
+    auto mappedFile = mapManager.readSource(testPath, /* library */ nullptr);
+    REQUIRE(mappedFile);
+
+    CHECK(mappedFile->data == readFile->data);
+    CHECK(mappedFile->data.back() == '\0');
+    CHECK(mapManager.getSourceText(mappedFile->id) == readFile->data);
+
+    // Files that fail to map fall back to being read normally.
+    CHECK(!mapManager.readSource("X:\\nonsense.txt", /* library */ nullptr));
+}
+
 TEST_CASE("Read header (absolute)") {
     SourceManager manager;
     std::string testPath = getTestInclude();
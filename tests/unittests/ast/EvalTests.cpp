@@ -7,6 +7,18 @@
 using Catch::Approx;
 
 #include "slang/ast/ScriptSession.h"
+#include "slang/ast/symbols/CompilationUnitSymbols.h"
+#include "slang/ast/symbols/InstanceSymbols.h"
+#include "slang/ast/symbols/ParameterSymbols.h"
+#include "slang/ast/symbols/SubroutineSymbols.h"
+
+// Constant functions can be evaluated either by walking their bodies or by
+// running lowered bytecode, so the tests that declare functions check both.
+static Bag evalOptions(bool enableBytecodeEval) {
+    CompilationOptions options;
+    options.enableBytecodeEval = enableBytecodeEval;
+    return Bag(options);
+}
 
 TEST_CASE("Simple eval") {
     ScriptSession session;
@@ -21,7 +33,8 @@ TEST_CASE("Simple eval") {
 }
 
 TEST_CASE("Eval function calls") {
-    ScriptSession session;
+    const bool enableBytecodeEval = GENERATE(false, true);
+    ScriptSession session(evalOptions(enableBytecodeEval));
     session.eval(R"(
 function logic [15:0] foo(int a, int b);
     return 16'(a + b);
@@ -31,6 +44,9 @@ endfunction
     auto value = session.eval("foo(3, 4)");
     CHECK(value.integer() == 7);
 
+    auto& foo = session.scope.find("foo")->as<SubroutineSymbol>();
+    CHECK((session.compilation.getSubroutineBytecode(foo) != nullptr) == enableBytecodeEval);
+
     session.eval(R"(
 function int bar();
     return 2;
@@ -44,7 +60,7 @@ endfunction
 }
 
 TEST_CASE("Nested functions") {
-    ScriptSession session;
+    ScriptSession session(evalOptions(GENERATE(false, true)));
     session.eval(R"(
 function automatic int symbols_in_data(int dataBitsPerSymbol, int data_width);
     return data_width / dataBitsPerSymbol;
@@ -120,7 +136,7 @@ endinterface
 }
 
 TEST_CASE("Eval if statement") {
-    ScriptSession session;
+    ScriptSession session(evalOptions(GENERATE(false, true)));
     session.eval(R"(
 function logic [15:0] foo(int a);
     if (a == 3)
@@ -138,7 +154,7 @@ endfunction
     NO_SESSION_ERRORS;
 
     SECTION("None if match") {
-        ScriptSession session;
+        ScriptSession session(evalOptions(GENERATE(false, true)));
         session.eval(R"(
 function logic [15:0] foo(int a);
     unique if (a == 3)
@@ -154,7 +170,7 @@ endfunction
     }
 
     SECTION("Not unique if match") {
-        ScriptSession session;
+        ScriptSession session(evalOptions(GENERATE(false, true)));
         session.eval(R"(
 function logic [15:0] foo(int a);
     unique if (a == 3)
@@ -171,7 +187,7 @@ endfunction
 }
 
 TEST_CASE("Eval for loop") {
-    ScriptSession session;
+    ScriptSession session(evalOptions(GENERATE(false, true)));
     session.eval(R"(
 function automatic logic [15:0] foo(int a);
     logic [15:0] result = 1;
@@ -196,7 +212,7 @@ endfunction
 }
 
 TEST_CASE("Eval nested for loop") {
-    ScriptSession session;
+    ScriptSession session(evalOptions(GENERATE(false, true)));
     session.eval(R"(
 function automatic logic [15:0] foo(int a);
     logic [15:0] result = 1;
@@ -422,7 +438,7 @@ TEST_CASE("Unary inc-dec operators") {
 }
 
 TEST_CASE("Constant eval errors") {
-    ScriptSession session;
+    ScriptSession session(evalOptions(GENERATE(false, true)));
     session.eval("logic f = 1;");
     session.eval("function int foo(int a); return f + a; endfunction");
     session.eval("function int bar(int b); return foo(b + 1); endfunction");
@@ -606,7 +622,7 @@ TEST_CASE("Dynamic arrays -- out of bounds") {
 }
 
 TEST_CASE("Associative array eval") {
-    ScriptSession session;
+    ScriptSession session(evalOptions(GENERATE(false, true)));
     session.eval("integer arr[string] = '{\"Hello\":4, \"World\":8, default:-1};");
 
     auto cv = session.eval("arr");
@@ -673,7 +689,7 @@ endfunction
 }
 
 TEST_CASE("Queue eval") {
-    ScriptSession session;
+    ScriptSession session(evalOptions(GENERATE(false, true)));
     session.eval("int arr[$] = '{1, 2, 3, 4};");
     session.eval("arr[0] = 42;");
     CHECK(session.eval("arr[0]").integer() == 42);
@@ -959,7 +975,7 @@ TEST_CASE("Ambiguous numeric literals") {
 }
 
 TEST_CASE("Eval case statements") {
-    ScriptSession session;
+    ScriptSession session(evalOptions(GENERATE(false, true)));
     session.eval(R"(
 function logic func1(string foo);
     unique case (foo)
@@ -1114,7 +1130,7 @@ endfunction
 }
 
 TEST_CASE("Eval sformatf") {
-    ScriptSession session;
+    ScriptSession session(evalOptions(GENERATE(false, true)));
     session.eval("logic [125:0] foo = '0;");
     session.eval("logic signed [125:0] bar = '1;");
     session.eval("logic signed [125:0] baz = 1;");
@@ -1214,7 +1230,7 @@ TEST_CASE("Concat assignments") {
 }
 
 TEST_CASE("Eval repeat loop") {
-    ScriptSession session;
+    ScriptSession session(evalOptions(GENERATE(false, true)));
     session.eval(R"(
 function automatic int foo(integer a);
     int result = 0;
@@ -1237,7 +1253,7 @@ endfunction
 }
 
 TEST_CASE("Eval while loop") {
-    ScriptSession session;
+    ScriptSession session(evalOptions(GENERATE(false, true)));
     session.eval(R"(
 function automatic int foo(integer a);
     int result = 0;
@@ -1260,7 +1276,7 @@ endfunction
 }
 
 TEST_CASE("Eval do-while loop") {
-    ScriptSession session;
+    ScriptSession session(evalOptions(GENERATE(false, true)));
     session.eval(R"(
 function automatic int foo(integer a);
     int result = 0;
@@ -1284,7 +1300,7 @@ endfunction
 }
 
 TEST_CASE("Eval forever loop") {
-    ScriptSession session;
+    ScriptSession session(evalOptions(GENERATE(false, true)));
     session.eval(R"(
 function automatic int foo(integer a);
     int result = 0;
@@ -1307,7 +1323,7 @@ endfunction
 }
 
 TEST_CASE("Eval foreach loop") {
-    ScriptSession session;
+    ScriptSession session(evalOptions(GENERATE(false, true)));
     session.eval(R"(
 function automatic int foo();
     bit [1:0][2:1] asdf [3:-1][2];
@@ -1340,7 +1356,7 @@ endfunction
 }
 
 TEST_CASE("Eval foreach loop dynamic") {
-    ScriptSession session;
+    ScriptSession session(evalOptions(GENERATE(false, true)));
     session.eval(R"(
 function automatic int foo();
     int result = 0;
@@ -1379,7 +1395,7 @@ endfunction
 }
 
 TEST_CASE("Eval disable statement") {
-    ScriptSession session;
+    ScriptSession session(evalOptions(GENERATE(false, true)));
     session.eval(R"(
 function int foo;
     automatic int result = 0;
@@ -1690,7 +1706,7 @@ TEST_CASE("Array query functions") {
 }
 
 TEST_CASE("Static variables aren't initialized in consteval") {
-    ScriptSession session;
+    ScriptSession session(evalOptions(GENERATE(false, true)));
 
     session.eval(R"(
 function int foo;
@@ -1909,7 +1925,7 @@ TEST_CASE("Mixed unknowns or signedness") {
 }
 
 TEST_CASE("Streaming operator const evaluation") {
-    ScriptSession session;
+    ScriptSession session(evalOptions(GENERATE(false, true)));
     session.eval(R"(
 localparam int j = { "A", "B", "C", "D" };
 localparam int s0 = { >> {j}};
@@ -1995,7 +2011,7 @@ localparam logic[7:0] value6 = {<<4{ {<<2{value5}} }};
 }
 
 TEST_CASE("streaming operator target evaluation") {
-    ScriptSession session;
+    ScriptSession session(evalOptions(GENERATE(false, true)));
     session.eval(R"(
 typedef bit ft[];
 function bit [0:95] foo(ft bar);
@@ -2051,7 +2067,7 @@ endfunction
 }
 
 TEST_CASE("Recursive function call") {
-    ScriptSession session;
+    ScriptSession session(evalOptions(GENERATE(false, true)));
     session.eval(R"(
 function automatic integer factorial (input [31:0] operand);
     if (operand >= 2)
@@ -2067,7 +2083,7 @@ endfunction: factorial
 }
 
 TEST_CASE("Stream with const evaluation") {
-    ScriptSession session;
+    ScriptSession session(evalOptions(GENERATE(false, true)));
     session.eval(R"(
     localparam byte a[] = {"A", "B", "C", "D"};
     localparam int b = {>>{a with [3]}};
@@ -2363,7 +2379,7 @@ struct {
 }
 
 TEST_CASE("foreach loop extended name eval") {
-    ScriptSession session;
+    ScriptSession session(evalOptions(GENERATE(false, true)));
     session.eval("typedef int rt[2][2];");
     session.eval(R"(
 function rt f;
@@ -2382,7 +2398,7 @@ endfunction
 }
 
 TEST_CASE("for loop with no stop expression eval") {
-    ScriptSession session;
+    ScriptSession session(evalOptions(GENERATE(false, true)));
     session.eval("typedef int rt[2][2];");
     session.eval(R"(
 function automatic int f;
@@ -2402,7 +2418,7 @@ endfunction
 }
 
 TEST_CASE("Pattern matching eval") {
-    ScriptSession session;
+    ScriptSession session(evalOptions(GENERATE(false, true)));
     session.eval(R"(
 typedef union tagged {
     struct {
@@ -2499,7 +2515,7 @@ endfunction
 }
 
 TEST_CASE("case statement eval regression") {
-    ScriptSession session;
+    ScriptSession session(evalOptions(GENERATE(false, true)));
     session.eval(R"(
 function automatic int calc(int p);
     case (p)
@@ -2518,3 +2534,271 @@ endfunction
     CHECK(session.eval("calc(400);").integer() == 0);
     NO_SESSION_ERRORS;
 }
+
+TEST_CASE("Eval functions with many locals") {
+    ScriptSession session(evalOptions(GENERATE(false, true)));
+    session.eval(R"(
+function automatic int many(int n);
+    int a0 = n, a1 = a0 + 1, a2 = a1 + 1, a3 = a2 + 1, a4 = a3 + 1, a5 = a4 + 1;
+    int a6 = a5 + 1, a7 = a6 + 1, a8 = a7 + 1, a9 = a8 + 1, a10 = a9 + 1, a11 = a10 + 1;
+    int a12 = a11 + 1, a13 = a12 + 1, a14 = a13 + 1, a15 = a14 + 1, a16 = a15 + 1;
+    int a17 = a16 + 1, a18 = a17 + 1, a19 = a18 + 1;
+    for (int i = 0; i < 3; i++) begin
+        int t = i * 2;
+        a0 += t;
+    end
+    if (n > 0)
+        return a19 + a0 + many(n - 1);
+    return a19 + a0;
+endfunction
+)");
+
+    // many(n) = (n + 19) + (n + 6) + many(n - 1), many(0) = 25
+    auto value = session.eval("many(10)");
+    CHECK(value.integer() == 25 + 10 * 25 + 2 * 55);
+
+    value = session.eval("many(3) + many(2)");
+    CHECK(value.integer() == (25 + 3 * 25 + 2 * 6) + (25 + 2 * 25 + 2 * 3));
+    NO_SESSION_ERRORS;
+}
+
+TEST_CASE("Constant function call caching") {
+    auto tree = SyntaxTree::fromText(R"(
+package p;
+    localparam int Base = 3;
+
+    function automatic int width(int n);
+        int result = 0;
+        for (int i = n - 1; i > 0; i >>= 1)
+            result++;
+        return result + Base;
+    endfunction
+
+    function automatic int fib(int n);
+        return n < 2 ? n : fib(n - 1) + fib(n - 2);
+    endfunction
+
+    function automatic int noisy(int n);
+        $display("noisy");
+        return n;
+    endfunction
+endpackage
+
+module m;
+    import p::*;
+
+    for (genvar i = 0; i < 20; i++) begin : g
+        localparam int W = width(256);
+        localparam int F = fib(20);
+        localparam int N = noisy(1);
+    end
+endmodule
+)");
+
+    auto check = [&](bool disableCaching) {
+        CompilationOptions options;
+        options.disableFunctionCaching = disableCaching;
+
+        Bag bag;
+        bag.set(options);
+        Compilation compilation(bag);
+        compilation.addSyntaxTree(tree);
+
+        auto& diags = compilation.getAllDiagnostics();
+        REQUIRE(!diags.empty());
+        for (auto& diag : diags)
+            CHECK(diag.code == diag::ConstSysTaskIgnored);
+
+        auto& root = compilation.getRoot();
+        CHECK(root.lookupName<ParameterSymbol>("m.g[19].W").getValue().integer() == 11);
+        CHECK(root.lookupName<ParameterSymbol>("m.g[19].F").getValue().integer() == 6765);
+
+        return compilation.getFunctionCacheStats();
+    };
+
+    // Each distinct call to fib is evaluated once, and every other
+    // call site hits in the cache. The calls that print are never cached.
+    auto stats = check(false);
+    CHECK(stats.misses == 22);
+    CHECK(stats.hits == 18 + 19 * 2);
+
+    stats = check(true);
+    CHECK(stats.misses == 0);
+    CHECK(stats.hits == 0);
+}
+
+TEST_CASE("Constant function call caching edge cases") {
+    auto tree = SyntaxTree::fromText(R"(
+module m;
+    int x;
+
+    function automatic int ping(int n);
+        return n <= 0 ? x : pong(n - 1);
+    endfunction
+
+    function automatic int pong(int n);
+        return n <= 0 ? 0 : ping(n - 1);
+    endfunction
+
+    function automatic int countdown(int n);
+        return n <= 0 ? 0 : countdown(n - 1);
+    endfunction
+
+    typedef struct { int i; real r; } S;
+    typedef real RA[2];
+
+    function automatic logic [63:0] structBits(S s);
+        return $realtobits(s.r);
+    endfunction
+
+    function automatic logic [63:0] arrayBits(RA r);
+        return $realtobits(r[1]);
+    endfunction
+
+    localparam S sPos = '{0, 0.0};
+    localparam S sNeg = '{0, -0.0};
+    localparam RA aPos = '{1.0, 0.0};
+    localparam RA aNeg = '{1.0, -0.0};
+
+    localparam logic [63:0] A = structBits(sPos);
+    localparam logic [63:0] B = structBits(sNeg);
+    localparam logic [63:0] C = arrayBits(aPos);
+    localparam logic [63:0] D = arrayBits(aNeg);
+endmodule
+)");
+
+    Compilation compilation;
+    compilation.addSyntaxTree(tree);
+    NO_COMPILATION_ERRORS;
+
+    // pong only calls ping, but ping depends on x, so neither can be cached
+    // no matter which of them is looked at first.
+    auto& m = compilation.getRoot().lookupName<InstanceSymbol>("m").body;
+    CHECK(!compilation.canCacheCallResults(m.find<SubroutineSymbol>("ping")));
+    CHECK(!compilation.canCacheCallResults(m.find<SubroutineSymbol>("pong")));
+    CHECK(compilation.canCacheCallResults(m.find<SubroutineSymbol>("countdown")));
+
+    // -0.0 and 0.0 compare equal, including when nested inside of aggregates,
+    // so calls with them as arguments can't share a cached result.
+    CHECK(m.find<ParameterSymbol>("A").getValue().integer() == 0);
+    CHECK(m.find<ParameterSymbol>("B").getValue().integer() == 0x8000000000000000ull);
+    CHECK(m.find<ParameterSymbol>("C").getValue().integer() == 0);
+    CHECK(m.find<ParameterSymbol>("D").getValue().integer() == 0x8000000000000000ull);
+}
+
+TEST_CASE("Constant function bytecode") {
+    auto tree = SyntaxTree::fromText(R"(
+package p;
+    localparam int Base = 3;
+
+    function automatic int loops(int n);
+        int result = 0;
+        for (int i = 0; i < n; i++) begin
+            if (i == 3)
+                continue;
+            else if (i > 20)
+                break;
+            result += i * Base;
+        end
+
+        while (result > 100)
+            result -= 7;
+
+        do begin
+            result <<= 1;
+        end while (result < 1000);
+        return result;
+    endfunction
+
+    function automatic logic [31:0] bits(int n);
+        logic [31:0] v = '0;
+        logic [7:0] b;
+        for (int i = 0; i < 32; i += 2)
+            v[i] = n[i / 2];
+        v[15:8] ^= 8'hA5;
+        v[30 -: 4] = v[3:0] + 1'b1;
+        b = v[7:0];
+        b[0] = 1'bx;
+        return {v[31:8], b[7] ? b[6:0] : 7'h7f, b[0]};
+    endfunction
+
+    function automatic int fact(int n);
+        return n <= 1 ? 1 : n * fact(n - 1);
+    endfunction
+
+    function automatic int mixed(int a, int b);
+        real r = a;
+        int q[$] = {a, b};
+        q.push_back(a + b);
+        if (a == 0 || b / a > 2 && fact(3) == 6)
+            return q.size() + int'(r * 1.5);
+        return fact(a) + q[2];
+    endfunction
+
+    function automatic int spin(int n);
+        int i = 0;
+        while (n > 0)
+            i++;
+        return i;
+    endfunction
+
+    function automatic int oob(int n);
+        logic [3:0] v = 4'b1010;
+        v[n] = 1'b1;
+        return v[n + 1];
+    endfunction
+endpackage
+
+module m;
+    import p::*;
+
+    localparam int L = loops(30);
+    localparam logic [31:0] B = bits(32'h5a3c);
+    localparam int F = fact(10);
+    localparam int M1 = mixed(0, 5);
+    localparam int M2 = mixed(2, 9);
+    localparam int M3 = mixed(4, 1);
+    localparam int S = spin(1);
+    localparam int O = oob(7);
+endmodule
+)");
+
+    auto check = [&](bool enableBytecode) {
+        CompilationOptions options;
+        options.enableBytecodeEval = enableBytecode;
+        options.disableFunctionCaching = true;
+        options.maxConstexprSteps = 10000;
+
+        Bag bag;
+        bag.set(options);
+        Compilation compilation(bag);
+        compilation.addSyntaxTree(tree);
+
+        auto diags = report(compilation.getAllDiagnostics());
+
+        std::vector<std::string> values;
+        auto& root = compilation.getRoot();
+        for (auto name : {"L", "B", "F", "M1", "M2", "M3", "S", "O"}) {
+            auto& param = root.lookupName<ParameterSymbol>(std::string("m.") + name);
+            values.push_back(param.getValue().toString());
+        }
+
+        auto pkg = compilation.getPackage("p");
+        REQUIRE(pkg);
+        auto bytecode = compilation.getSubroutineBytecode(
+            pkg->find("loops")->as<SubroutineSymbol>());
+        CHECK((bytecode != nullptr) == enableBytecode);
+
+        return std::make_pair(values, diags);
+    };
+
+    auto [treeValues, treeDiags] = check(false);
+    auto [bcValues, bcDiags] = check(true);
+    CHECK(treeValues == bcValues);
+    CHECK(treeDiags == bcDiags);
+
+    // Sanity check that the functions actually did something.
+    CHECK(treeValues[0] == "1536");
+    CHECK(treeValues[2] == "3628800");
+    CHECK(treeDiags.find("maximum step limit") != std::string::npos);
+}
@@ -2,12 +2,21 @@
 // SPDX-License-Identifier: MIT
 
 #include "Test.h"
+#include <fmt/core.h>
 
+#include "slang/ast/Definition.h"
+#include "slang/ast/expressions/MiscExpressions.h"
 #include "slang/ast/symbols/BlockSymbols.h"
 #include "slang/ast/symbols/CompilationUnitSymbols.h"
 #include "slang/ast/symbols/InstanceSymbols.h"
 #include "slang/ast/symbols/ParameterSymbols.h"
+#include "slang/ast/symbols/VariableSymbols.h"
+#include "slang/ast/types/NetType.h"
+#include "slang/ast/types/Type.h"
+#include "slang/syntax/AllSyntax.h"
+#include "slang/syntax/SyntaxPrinter.h"
 #include "slang/text/SourceManager.h"
+#include "slang/util/ThreadPool.h"
 
 TEST_CASE("Finding top level") {
     auto file1 = SyntaxTree::fromText(
@@ -620,6 +629,88 @@ source:16:16: error: use of undeclared identifier 'asdf'
 )");
 }
 
+TEST_CASE("Module/instance paths in errors with shared instance bodies") {
+    auto tree = SyntaxTree::fromText(R"(
+module foo;
+    bar b1();
+    bar b2();
+endmodule
+
+module bar;
+    baz #(1) z1();
+    baz #(1) z1b();
+    baz #(2) z2();
+endmodule
+
+module baz #(parameter int i)();
+    if (i == 1) begin
+        always asdf = 1;
+    end
+endmodule
+)");
+
+    auto expected = R"(
+  in 4 instances, e.g. foo.b1.z1
+source:15:16: error: use of undeclared identifier 'asdf'
+        always asdf = 1;
+               ^~~~
+)";
+
+    Compilation compilation;
+    compilation.addSyntaxTree(tree);
+
+    auto& diagnostics = compilation.getAllDiagnostics();
+    std::string result = "\n" + report(diagnostics);
+    CHECK(result == expected);
+
+    CompilationOptions options;
+    options.disableInstanceCaching = true;
+
+    Compilation compilation2(options);
+    compilation2.addSyntaxTree(tree);
+
+    auto& diagnostics2 = compilation2.getAllDiagnostics();
+    REQUIRE(diagnostics2.size() == 1);
+    CHECK(diagnostics2[0].coalesceCount == 4);
+}
+
+TEST_CASE("Instance bodies with hierarchical references are not shared") {
+    auto tree = SyntaxTree::fromText(R"(
+module top;
+    a a1();
+    b b1();
+endmodule
+
+module a;
+    c p();
+    leaf l();
+endmodule
+
+module b;
+    d p();
+    leaf l();
+endmodule
+
+module c;
+    int q;
+endmodule
+
+module d;
+endmodule
+
+module leaf;
+    initial $display(p.q);
+endmodule
+)");
+
+    Compilation compilation;
+    compilation.addSyntaxTree(tree);
+
+    auto& diags = compilation.getAllDiagnostics();
+    REQUIRE(diags.size() == 1);
+    CHECK(diags[0].code == diag::CouldNotResolveHierarchicalPath);
+}
+
 TEST_CASE("Parameter with type imported from package") {
     auto tree1 = SyntaxTree::fromText(R"(
 module m #(parameter p::foo f = "SDF") ();
@@ -743,6 +834,107 @@ endmodule
     REQUIRE(root.topInstances.size() == 2);
 }
 
+TEST_CASE("Single-unit multi-file parsed in parallel") {
+    SourceManager& sourceManager = SyntaxTree::getDefaultSourceManager();
+    std::array<SourceBuffer, 3> buffers;
+    buffers[0] = sourceManager.assignText("", R"(
+`timescale 1ns/1ps
+`define WIDTH 8
+localparam int foo = `WIDTH;
+
+module m;
+endmodule
+// trailing comment
+)");
+
+    buffers[1] = sourceManager.assignText("", R"(
+`default_nettype none
+`undef WIDTH
+`define WIDTH 16
+)");
+
+    buffers[2] = sourceManager.assignText("", R"(
+module n;
+    logic [`WIDTH-1:0] i = foo;
+endmodule
+)");
+
+    ThreadPool threadPool(2);
+    auto serial = SyntaxTree::fromBuffers(buffers, sourceManager);
+    auto parallel = SyntaxTree::fromBuffers(buffers, sourceManager, threadPool);
+    CHECK(SyntaxPrinter::printFile(*parallel) == SyntaxPrinter::printFile(*serial));
+    CHECK(parallel->getDefinedMacros().size() == serial->getDefinedMacros().size());
+    CHECK(parallel->diagnostics().empty());
+
+    Compilation compilation;
+    compilation.addSyntaxTree(parallel);
+    NO_COMPILATION_ERRORS;
+
+    auto& n = compilation.getRoot().lookupName<InstanceSymbol>("n");
+    CHECK(n.getDefinition().timeScale == TimeScale::fromString("1ns/1ps"));
+    CHECK(n.getDefinition().defaultNetType.netKind == NetType::Unknown);
+    CHECK(n.body.find<VariableSymbol>("i").getType().getBitWidth() == 16);
+
+    // A module that spans buffers can't be split, so this falls back to a serial parse.
+    buffers[0] = sourceManager.assignText("", "module k;\n");
+    buffers[1] = sourceManager.assignText("", "int j;\n");
+    buffers[2] = sourceManager.assignText("", "endmodule\n");
+
+    parallel = SyntaxTree::fromBuffers(buffers, sourceManager, threadPool);
+    CHECK(parallel->diagnostics().empty());
+    REQUIRE(parallel->root().as<CompilationUnitSyntax>().members.size() == 1);
+}
+
+TEST_CASE("Single-unit parallel parsing preprocesses once") {
+    SourceManager sourceManager;
+    std::array<SourceBuffer, 3> buffers;
+    buffers[0] = sourceManager.assignText("", R"(
+`define WIDTH 8
+`define ADD(a, b) a + b
+`ifdef WIDTH
+module m;
+    `default_nettype none
+    logic [`ADD(`WIDTH, -1):0] i;
+endmodule
+)");
+
+    buffers[1] = sourceManager.assignText("", R"(
+`endif
+module n;
+    int j = `ADD(1, 2);
+endmodule
+)");
+
+    buffers[2] = sourceManager.assignText("", "// only a comment\n");
+
+    // Every macro expansion gets its own entry in the source manager, so this
+    // checks that the parallel parse only preprocessed the text once, even though
+    // the conditional block that spans the first two buffers can't be split.
+    auto numBuffers = sourceManager.getAllBuffers().size();
+    auto serial = SyntaxTree::fromBuffers(buffers, sourceManager);
+    auto serialBuffers = sourceManager.getAllBuffers().size() - numBuffers;
+
+    ThreadPool threadPool(2);
+    numBuffers = sourceManager.getAllBuffers().size();
+    auto parallel = SyntaxTree::fromBuffers(buffers, sourceManager, threadPool);
+    CHECK(sourceManager.getAllBuffers().size() - numBuffers == serialBuffers);
+
+    CHECK(SyntaxPrinter::printFile(*parallel) == SyntaxPrinter::printFile(*serial));
+    REQUIRE(parallel->diagnostics().size() == 1);
+    CHECK(parallel->diagnostics()[0].code == diag::DirectiveInsideDesignElement);
+
+    // Directives inside design elements are still diagnosed when each buffer is
+    // parsed separately.
+    buffers[0] = sourceManager.assignText("", "module k;\n`resetall\nendmodule\n");
+    buffers[1] = sourceManager.assignText("", "module l;\nendmodule\n");
+    buffers[2] = sourceManager.assignText("", "`resetall\n");
+
+    parallel = SyntaxTree::fromBuffers(buffers, sourceManager, threadPool);
+    CHECK(parallel->root().as<CompilationUnitSyntax>().members.size() == 2);
+    REQUIRE(parallel->diagnostics().size() == 1);
+    CHECK(parallel->diagnostics()[0].code == diag::DirectiveInsideDesignElement);
+}
+
 TEST_CASE("Generate block external names") {
     auto tree = SyntaxTree::fromText(R"(
 module top;
@@ -2226,3 +2418,151 @@ endprimitive
     CHECK(diags[2].code == diag::MissingExternWildcardPorts);
     CHECK(diags[3].code == diag::MissingExternWildcardPorts);
 }
+
+TEST_CASE("Dependent syntax trees in compilation") {
+    auto pkg = SyntaxTree::fromText(R"(
+package p;
+    localparam int W = 4;
+endpackage
+)");
+    auto leaf = SyntaxTree::fromText(R"(
+module leaf import p::*; (output logic [W-1:0] o);
+    assign o = '0;
+endmodule
+)");
+    auto top = SyntaxTree::fromText(R"(
+module top;
+    logic [3:0] o;
+    leaf l(.o);
+endmodule
+)");
+    auto probe = SyntaxTree::fromText(R"(
+module probe;
+    wire [3:0] w = top.o;
+endmodule
+)");
+    auto other = SyntaxTree::fromText(R"(
+module other;
+endmodule
+)");
+
+    Compilation compilation;
+    compilation.addSyntaxTree(pkg);
+    compilation.addSyntaxTree(leaf);
+    compilation.addSyntaxTree(top);
+    compilation.addSyntaxTree(probe);
+    compilation.addSyntaxTree(other);
+    NO_COMPILATION_ERRORS;
+
+    // Changes flow upward to users of the package, to the trees they instantiate,
+    // and across hierarchical references.
+    auto deps = compilation.getDependentSyntaxTrees(*pkg);
+    CHECK(deps == std::vector{pkg, leaf, top, probe});
+
+    deps = compilation.getDependentSyntaxTrees(*top);
+    CHECK(deps == std::vector{top, probe, leaf});
+
+    deps = compilation.getDependentSyntaxTrees(*probe);
+    CHECK(deps == std::vector{probe, top, leaf});
+
+    deps = compilation.getDependentSyntaxTrees(*other);
+    CHECK(deps == std::vector{other});
+}
+
+TEST_CASE("Reference index") {
+    auto tree = SyntaxTree::fromText(R"(
+interface I;
+    logic valid;
+endinterface
+
+module regs;
+    logic [31:0] csr;
+    initial csr = 0;
+endmodule
+
+module reader(I bus);
+    logic [31:0] r;
+    assign r = bus.valid ? top.u_regs.csr : '0;
+endmodule
+
+module top;
+    I bus();
+    regs u_regs();
+    reader r1(bus);
+    reader r2(.bus);
+    logic [31:0] local_copy;
+    assign local_copy = u_regs.csr + 1;
+endmodule
+)");
+
+    CompilationOptions options;
+    options.buildReferenceIndex = true;
+
+    Bag bag;
+    bag.set(options);
+
+    Compilation compilation(bag);
+    compilation.addSyntaxTree(tree);
+    NO_COMPILATION_ERRORS;
+
+    auto& csr = compilation.getRoot().lookupName<VariableSymbol>("top.u_regs.csr");
+    auto refs = compilation.getReferences(csr);
+    REQUIRE(refs.size() == 4);
+
+    size_t lvalues = 0;
+    flat_hash_set<const Scope*> scopes;
+    for (auto& ref : refs) {
+        CHECK(&ref.expr->as<ValueExpressionBase>().symbol == &csr);
+        if (ref.isLValue)
+            lvalues++;
+        scopes.emplace(ref.scope);
+    }
+    CHECK(lvalues == 1);
+    CHECK(scopes.size() == 4);
+
+    auto& top = compilation.getRoot().topInstances[0]->body;
+    auto reader = compilation.getDefinition("reader", top);
+    REQUIRE(reader);
+    auto instances = compilation.getInstances(*reader);
+    REQUIRE(instances.size() == 2);
+    CHECK(instances[0]->name == "r1");
+    CHECK(instances[1]->name == "r2");
+
+    auto& bus = compilation.getRoot().lookupName<InstanceSymbol>("top.bus");
+    CHECK(compilation.getReferences(bus).size() == 2);
+
+    // Without the option nothing is recorded.
+    Compilation compilation2;
+    compilation2.addSyntaxTree(tree);
+    compilation2.getAllDiagnostics();
+    auto& csr2 = compilation2.getRoot().lookupName<VariableSymbol>("top.u_regs.csr");
+    CHECK(compilation2.getReferences(csr2).empty());
+}
+
+TEST_CASE("Large flat module name lookup") {
+    std::string text = "module inv(input a, output y); assign y = ~a; endmodule\n"
+                       "module top;\n";
+    for (int i = 0; i < 500; i++)
+        text += fmt::format("    wire n{};\n", i);
+    for (int i = 0; i < 499; i++)
+        text += fmt::format("    inv c{}(.a(n{}), .y(n{}));\n", i, i, i + 1);
+    text += "    logic n42;\n"
+            "endmodule\n";
+
+    auto tree = SyntaxTree::fromText(text);
+    Compilation compilation;
+    compilation.addSyntaxTree(tree);
+
+    auto& diags = compilation.getAllDiagnostics();
+    REQUIRE(diags.size() == 1);
+    CHECK(diags[0].code == diag::Redefinition);
+
+    auto& top = compilation.getRoot().lookupName<InstanceSymbol>("top");
+    CHECK(top.body.find("n499") != nullptr);
+    CHECK(top.body.find("c498") != nullptr);
+    CHECK(top.body.find("c499") == nullptr);
+
+    auto& c0 = compilation.getRoot().lookupName<InstanceSymbol>("top.c0");
+    CHECK(c0.body.find("a") != nullptr);
+    CHECK(c0.body.find("n0") == nullptr);
+}
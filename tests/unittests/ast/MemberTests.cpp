@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: MIT
 
 #include "Test.h"
+#include <sstream>
 
 #include "slang/ast/ASTSerializer.h"
 #include "slang/ast/Definition.h"
@@ -2449,3 +2450,55 @@ endmodule
     compilation.addSyntaxTree(tree);
     NO_COMPILATION_ERRORS;
 }
+
+TEST_CASE("JSON dump -- streaming output") {
+    auto tree = SyntaxTree::fromText(R"(
+module m #(parameter int P = 4)(input logic [P-1:0] a, output logic b);
+    typedef struct packed { logic x; logic [2:0] y; } S;
+    S s;
+    int arr[3] = '{1, 2, 3};
+    assign b = ^a;
+    always_comb begin
+        s = '{x: a[0], y: a[3:1]};
+        for (int i = 0; i < 3; i++) begin end
+    end
+endmodule
+
+module top;
+    logic [7:0] a;
+    logic [2:0] b;
+    for (genvar i = 0; i < 3; i++) begin : g
+        m #(.P(8)) inst(.a, .b(b[i]));
+    end
+endmodule
+)");
+
+    Compilation compilation;
+    compilation.addSyntaxTree(tree);
+    NO_COMPILATION_ERRORS;
+
+    auto dump = [&](bool pretty, std::ostream* os) {
+        JsonWriter writer;
+        writer.setPrettyPrint(pretty);
+        if (os)
+            writer.setOutput(*os, 16);
+
+        ASTSerializer serializer(compilation, writer);
+        serializer.setIncludeAddresses(false);
+        serializer.serialize(compilation.getRoot());
+
+        writer.flush();
+        return std::string(writer.view());
+    };
+
+    for (bool pretty : {false, true}) {
+        auto expected = dump(pretty, nullptr);
+
+        // Streamed output ends up entirely in the stream, aside from the
+        // trailing separator, which never becomes part of the view.
+        std::ostringstream stream;
+        auto remaining = dump(pretty, &stream);
+        CHECK(remaining.empty());
+        CHECK(stream.str() == expected);
+    }
+}
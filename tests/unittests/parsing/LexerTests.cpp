@@ -212,6 +212,38 @@ TEST_CASE("Whitespace") {
     CHECK_DIAGNOSTICS_EMPTY;
 }
 
+TEST_CASE("Long runs of trivia and identifier characters") {
+    auto& text = " \t \v\f   \t \t  \f\v  \t// a long line comment \xe7\x9a\x84 with utf8\n"
+                 "/* a long block comment with * and / and /* inside it */"
+                 "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_0123456789$";
+    Token token = lexToken(text);
+
+    CHECK(token.kind == TokenKind::Identifier);
+    CHECK(token.toString() == text);
+    CHECK(token.valueText() ==
+          "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_0123456789$");
+    REQUIRE(token.trivia().size() == 4);
+    CHECK(token.trivia()[0].kind == TriviaKind::Whitespace);
+    CHECK(token.trivia()[1].kind == TriviaKind::LineComment);
+    CHECK(token.trivia()[2].kind == TriviaKind::EndOfLine);
+    CHECK(token.trivia()[3].kind == TriviaKind::BlockComment);
+    REQUIRE(diagnostics.size() == 1);
+    CHECK(diagnostics.back().code == diag::NestedBlockComment);
+
+    // Every character that can't be part of an identifier should end it,
+    // no matter where it falls relative to the start of the identifier.
+    for (int c = 1; c < 256; c++) {
+        if (isAlphaNumeric(char(c)) || c == '_' || c == '$')
+            continue;
+
+        std::string str = "abcdefghijklmnopqrstu";
+        str.push_back(char(c));
+        token = lexToken(str);
+        CHECK(token.kind == TokenKind::Identifier);
+        CHECK(token.valueText() == "abcdefghijklmnopqrstu");
+    }
+}
+
 TEST_CASE("Newlines (CR)") {
     auto& text = "\r";
     Token token = lexToken(text);
@@ -3,6 +3,7 @@
 
 #include "Test.h"
 
+#include "slang/parsing/IncludeTokenCache.h"
 #include "slang/parsing/Preprocessor.h"
 #include "slang/syntax/AllSyntax.h"
 #include "slang/syntax/SyntaxPrinter.h"
@@ -97,6 +98,49 @@ TEST_CASE("Double include, with pragma once") {
     CHECK_DIAGNOSTICS_EMPTY;
 }
 
+TEST_CASE("Include token cache") {
+    auto& text = R"(
+`include "local.svh"
+`include "local.svh"
+`include "local.svh"
+)";
+
+    PreprocessorOptions ppOptions;
+    ppOptions.includeTokenCache = std::make_shared<IncludeTokenCache>();
+
+    Bag options;
+    options.set(ppOptions);
+
+    std::string expected = preprocess(text);
+    std::string result = preprocess(text, options);
+    CHECK(result == expected);
+    CHECK_DIAGNOSTICS_EMPTY;
+
+    // A second preprocessor reuses the tokens lexed by the first, but each
+    // inclusion still gets its own buffer and locations.
+    result = preprocess(text, options);
+    CHECK(result == expected);
+    CHECK(ppOptions.includeTokenCache->size() == 1);
+
+    Preprocessor preprocessor(getSourceManager(), alloc, diagnostics, options);
+    preprocessor.pushSource(text);
+
+    SmallVector<SourceLocation> locations;
+    while (true) {
+        Token token = preprocessor.next();
+        if (token.kind == TokenKind::EndOfFile)
+            break;
+        locations.push_back(token.location());
+    }
+
+    REQUIRE(locations.size() == 3);
+    CHECK(locations[0].buffer() != locations[1].buffer());
+    CHECK(locations[1].buffer() != locations[2].buffer());
+    CHECK(locations[0].offset() == locations[1].offset());
+    CHECK(getSourceManager().getRawFileName(locations[2].buffer()).ends_with("local.svh"));
+    CHECK_DIAGNOSTICS_EMPTY;
+}
+
 TEST_CASE("Include directive errors") {
     auto& text = R"(
 `include
@@ -3,12 +3,15 @@
 
 #include "Test.h"
 #include <fmt/core.h>
+#include <fstream>
 
 #include "slang/ast/ASTVisitor.h"
 #include "slang/ast/SemanticModel.h"
 #include "slang/parsing/ParserMetadata.h"
 #include "slang/syntax/SyntaxPrinter.h"
 #include "slang/syntax/SyntaxVisitor.h"
+#include "slang/text/SourceManager.h"
+#include "slang/util/String.h"
 
 class TestRewriter : public SyntaxRewriter<TestRewriter> {
 public:
@@ -575,3 +578,180 @@ TEST_CASE("Visit all file") {
 
     CHECK(count == 981);
 }
+
+TEST_CASE("Serialize and reload syntax trees") {
+    std::string text = R"(
+`include "file_defn.svh"
+`define ADD(a, b) a + b
+`define STR(x) `"x`"
+`timescale 1ns/1ps
+`default_nettype none
+// comment
+module m #(parameter int P = `ADD(3, 4)) (input logic [3:0] a);
+    localparam real r = 1.5e3;
+    localparam time t = 10ns;
+    localparam logic [127:0] big = 128'hx123456789abcdef0123456789abcdef;
+    localparam string s = "hi\n";
+    wire logic b = 'z;
+    initial $display(`STR(foo), `__LINE__, `FOO);
+    /* block */
+endmodule
+`line 10 "foo.sv" 0
+class C; endclass
+package p; endpackage
+)";
+
+    auto& sm = getSourceManager();
+    auto buffer = sm.assignText(text);
+    auto tree = SyntaxTree::fromBuffer(buffer, sm);
+    CHECK(tree->diagnostics().empty());
+
+    auto data = tree->serialize();
+    REQUIRE(data);
+
+    auto loaded = SyntaxTree::fromSerialized(*data, buffer, sm);
+    REQUIRE(loaded);
+    CHECK(SyntaxPrinter::printFile(*loaded) == SyntaxPrinter::printFile(*tree));
+    CHECK(loaded->root().isEquivalentTo(tree->root()));
+
+    auto& meta = loaded->getMetadata();
+    CHECK(meta.nodeMap.size() == tree->getMetadata().nodeMap.size());
+    CHECK(meta.classDecls.size() == 1);
+    CHECK(meta.eofToken.location() == tree->getMetadata().eofToken.location());
+    CHECK(loaded->getDefinedMacros().size() == tree->getDefinedMacros().size());
+
+    auto& unit = loaded->root().as<CompilationUnitSyntax>();
+    auto& modInfo = meta.nodeMap.at(unit.members[0]);
+    CHECK(modInfo.defaultNetType == TokenKind::Unknown);
+    CHECK(modInfo.timeScale.has_value());
+
+    auto getDiags = [](const std::shared_ptr<SyntaxTree>& t) {
+        Compilation compilation;
+        compilation.addSyntaxTree(t);
+        return report(compilation.getAllDiagnostics());
+    };
+    CHECK(getDiags(loaded) == getDiags(tree));
+
+    // Any change to the source text or the serialized data is rejected.
+    auto other = sm.assignText(text + "\n");
+    CHECK(!SyntaxTree::fromSerialized(*data, other, sm));
+    CHECK(!SyntaxTree::fromSerialized(std::span(data->data(), data->size() - 1), buffer, sm));
+
+    // Trees with errors are never serialized.
+    auto errTree = SyntaxTree::fromText("module m; int; endmodule");
+    CHECK(!errTree->serialize());
+}
+
+TEST_CASE("Rejected serialized trees don't modify the source manager") {
+    std::error_code ec;
+    auto dir = fs::temp_directory_path(ec) / "slang_serialize_test";
+    fs::create_directories(dir, ec);
+
+    auto writeHeader = [&](std::string_view text) {
+        std::ofstream file(dir / "hdr.svh");
+        file << text;
+    };
+
+    // The macro expansion is written to the buffer table before the include.
+    std::string text = R"(
+`define A 1
+localparam int x = `A;
+`include "hdr.svh"
+)";
+
+    writeHeader("localparam int y = 2;\n");
+    std::optional<std::vector<char>> data;
+    {
+        SourceManager sm;
+        sm.addUserDirectories(getU8Str(dir));
+        auto tree = SyntaxTree::fromBuffer(sm.assignText(text), sm);
+        CHECK(tree->diagnostics().empty());
+        data = tree->serialize();
+        REQUIRE(data);
+    }
+
+    writeHeader("localparam int y = 3;\n");
+    SourceManager sm;
+    sm.addUserDirectories(getU8Str(dir));
+    auto buffer = sm.assignText(text);
+    auto numBuffers = sm.getAllBuffers().size();
+    CHECK(!SyntaxTree::fromSerialized(*data, buffer, sm));
+
+    // Only the header that was checked against the entry got loaded.
+    CHECK(sm.getAllBuffers().size() == numBuffers + 1);
+    fs::remove_all(dir, ec);
+}
+
+TEST_CASE("SemanticModel location queries") {
+    auto text = R"(
+module leaf #(parameter int W = 4) (input logic [W-1:0] d, output logic [W-1:0] q);
+    function automatic logic [W-1:0] invert(logic [W-1:0] v);
+        return ~v;
+    endfunction
+
+    assign q = invert(d);
+endmodule
+
+module top;
+    logic [7:0] a, b;
+    leaf #(.W(8)) l1(.d(a), .q(b));
+    leaf #(.W(8)) l2(.d(b), .q());
+endmodule
+)"sv;
+
+    auto tree = SyntaxTree::fromText(text);
+    Compilation compilation;
+    compilation.addSyntaxTree(tree);
+    NO_COMPILATION_ERRORS;
+
+    SemanticModel model(compilation);
+    auto buffer = tree->root().sourceRange().start().buffer();
+    auto locOf = [&](std::string_view str, size_t nth = 0) {
+        size_t offset = text.find(str);
+        while (nth--)
+            offset = text.find(str, offset + 1);
+        REQUIRE(offset != std::string_view::npos);
+        return SourceLocation(buffer, offset);
+    };
+
+    auto sym = model.getSymbolAt(locOf("a, b"));
+    REQUIRE(sym);
+    CHECK(sym->kind == SymbolKind::Variable);
+    CHECK(sym->name == "a");
+
+    sym = model.getSymbolAt(locOf("return"));
+    REQUIRE(sym);
+    CHECK(sym->kind == SymbolKind::Subroutine);
+    CHECK(sym->name == "invert");
+
+    auto expr = model.getExpressionAt(locOf("~v") + 1);
+    REQUIRE(expr);
+    CHECK(expr->kind == ExpressionKind::NamedValue);
+
+    expr = model.getExpressionAt(locOf("~v"));
+    REQUIRE(expr);
+    CHECK(expr->kind == ExpressionKind::UnaryOp);
+
+    auto ref = model.getReferencedSymbolAt(locOf("invert(d)"));
+    REQUIRE(ref);
+    CHECK(ref->kind == SymbolKind::Subroutine);
+    CHECK(ref->name == "invert");
+
+    ref = model.getReferencedSymbolAt(locOf("d);"));
+    REQUIRE(ref);
+    CHECK(ref->kind == SymbolKind::Variable);
+    CHECK(ref->name == "d");
+
+    ref = model.getReferencedSymbolAt(locOf("b), .q()"));
+    REQUIRE(ref);
+    CHECK(ref->kind == SymbolKind::Variable);
+    CHECK(ref->name == "b");
+    CHECK(ref->getParentScope()->asSymbol().name == "top");
+
+    ref = model.getReferencedSymbolAt(locOf("l2"));
+    REQUIRE(ref);
+    CHECK(ref->kind == SymbolKind::Instance);
+
+    CHECK(model.getReferencedSymbolAt(locOf("endmodule")) == nullptr);
+    CHECK(model.getExpressionAt(locOf("module top")) == nullptr);
+}
@@ -822,3 +822,28 @@ value = value >> 1
     compilation.addSyntaxTree(tree);
     compilation.getAllDiagnostics();
 }
+
+TEST_CASE("SVInt wide value storage reuse") {
+    // Setting unknown bits into a wide known value must preserve all existing words.
+    SVInt v1 = "200'hffffffffffffffffffffffffffffffffffffffffffffffffff"_si;
+    v1.set(3, 0, "4'bx01z"_si);
+    CHECK_THAT(v1, exactlyEquals(SVInt::fromString("200'b" + std::string(196, '1') + "x01z")));
+
+    // Churn through lots of temporaries of various widths so that buffers get
+    // recycled between values with and without unknown bits.
+    SVInt sum(256, 0, false);
+    for (uint32_t i = 0; i < 1000; i++) {
+        SVInt a(64 * (i % 8 + 1), i, false);
+        SVInt b = a.resize(256) * SVInt(256, i + 1, false);
+        sum += b;
+
+        SVInt c = b;
+        c.setAllX();
+        CHECK(c.hasUnknown());
+        c.setAllOnes();
+        CHECK(!c.hasUnknown());
+        c = b;
+        CHECK(c == b);
+    }
+    CHECK(sum == SVInt(256, 333333000, false));
+}
@@ -263,6 +263,63 @@ TEST_CASE("ThreadPool -- pushLoop") {
     CHECK(std::ranges::all_of(flags10, [](auto&& f) -> bool { return f; }));
 }
 
+TEST_CASE("ThreadPool -- pushLoop chunking") {
+    ThreadPool pool(4);
+
+    // Every index is visited exactly once, both when chunks are
+    // claimed dynamically and when the blocks are fixed up front.
+    for (size_t numBlocks : {size_t(0), size_t(3), size_t(1000)}) {
+        std::array<std::atomic<int>, 997> counts;
+        std::ranges::fill(counts, 0);
+
+        pool.pushLoop(
+            size_t(0), counts.size(),
+            [&](size_t start, size_t end) {
+                for (size_t i = start; i < end; i++)
+                    counts[i]++;
+            },
+            numBlocks);
+        pool.waitForAll();
+        CHECK(std::ranges::all_of(counts, [](auto&& c) -> bool { return c == 1; }));
+    }
+
+    // A single expensive iteration doesn't hold up the rest of the loop,
+    // since other threads keep claiming work while it runs.
+    std::atomic<bool> release = false;
+    std::atomic<int> done = 0;
+    pool.pushLoop(0, 100, [&](int start, int end) {
+        for (int i = start; i < end; i++) {
+            if (i == 99) {
+                while (!release)
+                    std::this_thread::yield();
+            }
+            done++;
+        }
+    });
+
+    while (done < 99)
+        std::this_thread::yield();
+
+    release = true;
+    pool.waitForAll();
+    CHECK(done == 100);
+}
+
+TEST_CASE("ThreadPool -- tasks pushed from workers") {
+    ThreadPool pool(3);
+
+    std::atomic<int> count = 0;
+    for (int i = 0; i < 10; i++) {
+        pool.pushTask([&] {
+            for (int j = 0; j < 10; j++)
+                pool.pushTask([&] { count++; });
+        });
+    }
+
+    pool.waitForAll();
+    CHECK(count == 100);
+}
+
 #ifdef CI_BUILD
 
 TEST_CASE("ThreadPool -- no destruction deadlocks") {
@@ -64,3 +64,44 @@ TEST_CASE("TimeTrace tests") {
     std::ostringstream sstr;
     TimeTrace::write(sstr);
 }
+
+TEST_CASE("BumpAllocator growth and steal") {
+    // Allocate enough from several allocators to span many segments,
+    // then merge them all into one and make sure the data is intact.
+    BumpAllocator main;
+    std::vector<std::pair<int*, int>> items;
+
+    for (int i = 0; i < 4; i++) {
+        BumpAllocator local;
+        for (int j = 0; j < 100000; j++) {
+            int* p = local.emplace<int>(i * 100000 + j);
+            if (j % 997 == 0)
+                items.emplace_back(p, i * 100000 + j);
+        }
+
+        // Large allocations get their own segment.
+        auto big = local.allocate(1 << 22, alignof(int));
+        std::memset(big, 0xab, 1 << 22);
+
+        main.steal(std::move(local));
+        main.steal(BumpAllocator());
+    }
+
+    main.emplace<int>(42);
+    for (auto [ptr, val] : items)
+        CHECK(*ptr == val);
+
+    int count = 0;
+    struct Counted {
+        int& count;
+        explicit Counted(int& count) : count(count) {}
+        ~Counted() { count++; }
+    };
+
+    {
+        TypedBumpAllocator<Counted> typed;
+        for (int i = 0; i < 50000; i++)
+            typed.emplace(count);
+    }
+    CHECK(count == 50000);
+}
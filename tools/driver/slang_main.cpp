@@ -26,11 +26,40 @@ using namespace slang::driver;
 
 void writeToFile(std::string_view fileName, std::string_view contents);
 
+template<typename Stream, typename String>
+void writeToFile(Stream& os, std::string_view fileName, String contents);
+
 void printJson(Compilation& compilation, const std::string& fileName,
                const std::vector<std::string>& scopes) {
     JsonWriter writer;
     writer.setPrettyPrint(true);
 
+    // Stream the JSON out as it's generated instead of building up the whole
+    // document in memory, which can be huge for large designs. Writing to
+    // the console on Windows requires wide text, so that case is buffered.
+    std::ofstream file;
+    std::ostream* os = nullptr;
+    if (fileName != "-") {
+#if defined(_WIN32)
+        file.open(widen(fileName));
+#else
+        file.open(fileName);
+#endif
+        if (!file.is_open()) {
+            SLANG_THROW(
+                std::runtime_error(fmt::format("Unable to open '{}' for writing", fileName)));
+        }
+        os = &file;
+    }
+#if !defined(_WIN32)
+    else {
+        os = &std::cout;
+    }
+#endif
+
+    if (os)
+        writer.setOutput(*os);
+
     ASTSerializer serializer(compilation, writer);
     if (scopes.empty()) {
         serializer.serialize(compilation.getRoot());
@@ -43,7 +72,16 @@ void printJson(Compilation& compilation, const std::string& fileName,
         }
     }
 
-    writeToFile(fileName, writer.view());
+    if (os) {
+        writer.flush();
+        if (!os->flush()) {
+            SLANG_THROW(std::runtime_error(fmt::format("Unable to write AST to '{}'",
+                                                       fileName == "-" ? "stdout" : fileName)));
+        }
+    }
+    else {
+        writeToFile(fileName, writer.view());
+    }
 }
 
 template<typename TArgs>
@@ -0,0 +1,203 @@
+//------------------------------------------------------------------------------
+//! @file ConeQuery.h
+//! @brief Find the fan-in and fan-out cones of points in the netlist.
+//
+// SPDX-FileCopyrightText: Michael Popoloski
+// SPDX-License-Identifier: MIT
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "DirectedGraph.h"
+#include "Netlist.h"
+#include <algorithm>
+#include <bit>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "slang/util/Hash.h"
+#include "slang/util/Util.h"
+
+namespace netlist {
+
+/// The direction in which to search for a cone.
+enum class ConeDirection { FanIn, FanOut };
+
+/// Find the fan-in or fan-out cones of a batch of points in a netlist.
+///
+/// The fan-out cone of a point contains every node that can be reached from it
+/// by following enabled edges, and the fan-in cone every node that can reach it.
+/// Cones stop at sequential elements: variable references that are assigned in
+/// sequential blocks are included in a cone, but the edges from them to the
+/// variable they assign are only followed when the variable is the point itself.
+/// So the fan-out cone of an input ends at the registers it drives, and the
+/// fan-in cone of a register is the logic that drives its next value.
+///
+/// Rather than searching the netlist once per point, the cones of up to 64
+/// points are found together in a single breadth-first traversal, in which each
+/// node holds a bit mask of the points whose cones it is in, and a node is only
+/// visited again when its mask gains new points.
+class ConeQuery {
+public:
+    /// Searches are done over a compressed snapshot of the netlist that is taken
+    /// here, so the structure of the netlist must not change while the query is
+    /// in use (enabling or disabling edges is fine).
+    ConeQuery(Netlist& netlist) : graph(netlist) {
+        // Once variables have been split, the edges to and from a variable
+        // declaration are attached to its aliases instead, so the aliases are
+        // treated as being part of the same point.
+        for (auto& node : netlist) {
+            if (node->kind == NodeKind::VariableAlias) {
+                aliases[&node->symbol].push_back(node.get());
+            }
+        }
+    }
+
+    /// Find the cones of the given points in the given direction. Return one
+    /// list of nodes for each point, in the order the nodes appear in the netlist,
+    /// which doesn't include the point itself or its aliases.
+    std::vector<std::vector<NetlistNode*>> find(std::span<NetlistNode* const> points,
+                                                ConeDirection direction) const {
+        std::vector<std::vector<NetlistNode*>> cones(points.size());
+        std::vector<PointMask> seeds(graph.numNodes());
+        std::vector<PointMask> reached(graph.numNodes());
+        std::vector<PointMask> pending(graph.numNodes());
+        std::vector<node_descriptor> queue;
+
+        for (size_t batchStart = 0; batchStart < points.size(); batchStart += BatchSize) {
+            auto batch = points.subspan(batchStart,
+                                        std::min(BatchSize, points.size() - batchStart));
+            std::ranges::fill(seeds, 0);
+            std::ranges::fill(reached, 0);
+
+            auto reach = [&](node_descriptor node, PointMask mask) {
+                auto newPoints = mask & ~reached[node];
+                if (!newPoints) {
+                    return;
+                }
+                reached[node] |= newPoints;
+                if (!pending[node]) {
+                    queue.push_back(node);
+                }
+                pending[node] |= newPoints;
+            };
+
+            for (size_t i = 0; i < batch.size(); i++) {
+                auto mask = PointMask(1) << i;
+                addSeed(*batch[i], mask, seeds);
+                if (auto it = aliases.find(&batch[i]->symbol); it != aliases.end()) {
+                    for (auto* alias : it->second) {
+                        addSeed(*alias, mask, seeds);
+                    }
+                }
+            }
+            for (node_descriptor node = 0; node < graph.numNodes(); node++) {
+                reach(node, seeds[node]);
+            }
+
+            for (size_t next = 0; next < queue.size(); next++) {
+                auto node = queue[next];
+                auto mask = std::exchange(pending[node], 0);
+                if (direction == ConeDirection::FanOut) {
+                    if (isSequential(node)) {
+                        mask &= seeds[node];
+                    }
+                    auto edges = graph.getOutEdges(node);
+                    auto successors = graph.getSuccessors(node);
+                    for (size_t i = 0; i < edges.size(); i++) {
+                        if (!edges[i]->disabled) {
+                            reach(successors[i], mask);
+                        }
+                    }
+                }
+                else {
+                    auto edges = graph.getInEdges(node);
+                    auto predecessors = graph.getPredecessors(node);
+                    for (size_t i = 0; i < edges.size(); i++) {
+                        if (!edges[i]->disabled) {
+                            reach(predecessors[i],
+                                  isSequential(predecessors[i]) ? mask & seeds[node] : mask);
+                        }
+                    }
+                }
+            }
+            queue.clear();
+
+            for (node_descriptor node = 0; node < graph.numNodes(); node++) {
+                auto mask = reached[node] & ~seeds[node];
+                while (mask) {
+                    cones[batchStart + size_t(std::countr_zero(mask))].push_back(
+                        &graph.getNode(node));
+                    mask &= mask - 1;
+                }
+            }
+        }
+        return cones;
+    }
+
+    /// Return the hierarchical path of the signal that a node in a cone
+    /// represents, or an empty string if it doesn't represent a signal by itself.
+    /// Variable references are only represented by their declarations, except for
+    /// those at the sequential boundary of a cone.
+    static std::string_view getSignal(const Netlist& netlist, const NetlistNode& node) {
+        switch (node.kind) {
+            case NodeKind::PortDeclaration:
+                return node.as<NetlistPortDeclaration>().hierarchicalPath;
+            case NodeKind::VariableDeclaration:
+                return node.as<NetlistVariableDeclaration>().hierarchicalPath;
+            case NodeKind::VariableAlias:
+                return node.as<NetlistVariableAlias>().hierarchicalPath;
+            case NodeKind::VariableReference:
+                if (node.as<NetlistVariableReference>().isSequential()) {
+                    if (auto* varDecl = netlist.lookupVariable(node.symbol)) {
+                        return varDecl->as<NetlistVariableDeclaration>().hierarchicalPath;
+                    }
+                }
+                return {};
+            default:
+                return {};
+        }
+    }
+
+    /// Return the hierarchical paths of the signals in the cone of a point,
+    /// sorted and without duplicates, and not including the point itself.
+    static std::vector<std::string> getSignals(const Netlist& netlist, const NetlistNode& point,
+                                               std::span<NetlistNode* const> cone) {
+        auto pointSignal = getSignal(netlist, point);
+        std::vector<std::string> signals;
+        for (auto* node : cone) {
+            auto signal = getSignal(netlist, *node);
+            if (!signal.empty() && signal != pointSignal) {
+                signals.emplace_back(signal);
+            }
+        }
+        std::ranges::sort(signals);
+        signals.erase(std::ranges::unique(signals).begin(), signals.end());
+        return signals;
+    }
+
+private:
+    using node_descriptor = CompressedGraph<NetlistNode, NetlistEdge>::node_descriptor;
+    using PointMask = uint64_t;
+    static constexpr size_t BatchSize = 64;
+
+    void addSeed(NetlistNode& node, PointMask mask, std::vector<PointMask>& seeds) const {
+        auto descriptor = graph.findNode(node);
+        if (descriptor != CompressedGraph<NetlistNode, NetlistEdge>::null_node) {
+            seeds[descriptor] |= mask;
+        }
+    }
+
+    bool isSequential(node_descriptor node) const {
+        auto& netlistNode = graph.getNode(node);
+        return netlistNode.kind == NodeKind::VariableReference &&
+               netlistNode.as<NetlistVariableReference>().isSequential();
+    }
+
+    CompressedGraph<NetlistNode, NetlistEdge> graph;
+    flat_hash_map<const ast::Symbol*, std::vector<NetlistNode*>> aliases;
+};
+
+} // namespace netlist
@@ -37,6 +37,20 @@ public:
         run();
     }
 
+    /// Search a compressed snapshot of the graph, which visits nodes and edges in
+    /// the same order as searching the graph itself but without any per-node
+    /// allocations or lookups.
+    DepthFirstSearch(Visitor& visitor, const CompressedGraph<NodeType, EdgeType>& graph,
+                     NodeType& startNode) : visitor(visitor) {
+        run(graph, startNode);
+    }
+
+    DepthFirstSearch(Visitor& visitor, EdgePredicate edgePredicate,
+                     const CompressedGraph<NodeType, EdgeType>& graph, NodeType& startNode) :
+        visitor(visitor), edgePredicate(edgePredicate) {
+        run(graph, startNode);
+    }
+
 private:
     using EdgeIteratorType = typename NodeType::iterator;
     using VisitStackElement = std::pair<NodeType&, EdgeIteratorType>;
@@ -72,6 +86,46 @@ private:
         }
     }
 
+    /// Perform a depth-first traversal of a compressed graph.
+    void run(const CompressedGraph<NodeType, EdgeType>& graph, NodeType& startNode) {
+        using node_descriptor = typename CompressedGraph<NodeType, EdgeType>::node_descriptor;
+        auto start = graph.findNode(startNode);
+        SLANG_ASSERT(start != graph.null_node && "Start node is not in the graph");
+        if (start == graph.null_node)
+            return;
+
+        // Each stack entry is a node and the position of the next edge to follow.
+        std::vector<bool> visited(graph.numNodes());
+        std::vector<std::pair<node_descriptor, size_t>> stack;
+        visited[start] = true;
+        stack.emplace_back(start, 0);
+        visitor.visitNode(startNode);
+
+        while (!stack.empty()) {
+            auto node = stack.back().first;
+            auto edges = graph.getOutEdges(node);
+            auto successors = graph.getSuccessors(node);
+            bool descended = false;
+            while (stack.back().second < edges.size()) {
+                auto i = stack.back().second++;
+                auto target = successors[i];
+                if (edgePredicate(*edges[i]) && !visited[target]) {
+                    // Push a new 'current' node onto the stack and mark it as visited.
+                    visited[target] = true;
+                    stack.emplace_back(target, 0);
+                    visitor.visitEdge(*edges[i]);
+                    visitor.visitNode(graph.getNode(target));
+                    descended = true;
+                    break;
+                }
+            }
+
+            // All children of this node have been visited or skipped, so remove from the stack.
+            if (!descended)
+                stack.pop_back();
+        }
+    }
+
 private:
     Visitor& visitor;
     EdgePredicate edgePredicate;
@@ -11,8 +11,10 @@
 #include <cassert>
 #include <limits>
 #include <memory>
+#include <span>
 #include <vector>
 
+#include "slang/util/Hash.h"
 #include "slang/util/Util.h"
 
 namespace netlist {
@@ -294,4 +296,121 @@ protected:
     NodeListType nodes;
 };
 
+/// A read-only snapshot of the structure of a directed graph, stored in
+/// compressed sparse row form.
+/// Nodes are numbered densely in the order they appear in the source graph,
+/// and the outgoing and incoming edges of every node are stored contiguously
+/// in flat arrays, in the same order as the source graph's edge lists. This
+/// makes traversals cache friendly and lets incoming edges be found without
+/// scanning the whole graph. The nodes and edges themselves are still owned
+/// by the source graph, which must outlive the snapshot; any change to the
+/// structure of the source graph requires building a new snapshot, although
+/// changes to the contents of nodes and edges are visible through it.
+template<class NodeType, class EdgeType>
+class CompressedGraph {
+public:
+    using node_descriptor = uint32_t;
+    static constexpr node_descriptor null_node = std::numeric_limits<uint32_t>::max();
+
+    /// Build a snapshot of the given graph.
+    explicit CompressedGraph(const DirectedGraph<NodeType, EdgeType>& graph) {
+        nodes.reserve(graph.numNodes());
+        nodeIndices.reserve(graph.numNodes());
+        for (auto& node : graph) {
+            nodeIndices.emplace(node.get(), node_descriptor(nodes.size()));
+            nodes.push_back(node.get());
+        }
+
+        // Forward adjacency, in the order of each node's edge list.
+        outOffsets.reserve(nodes.size() + 1);
+        outOffsets.push_back(0);
+        std::vector<uint32_t> inCounts(nodes.size() + 1);
+        for (auto* node : nodes) {
+            for (auto& edge : node->getEdges()) {
+                auto target = findNode(edge->getTargetNode());
+                SLANG_ASSERT(target != null_node && "Edge target is not in the graph");
+                outEdges.push_back(edge.get());
+                outTargets.push_back(target);
+                inCounts[target + 1]++;
+            }
+            outOffsets.push_back(uint32_t(outEdges.size()));
+        }
+
+        // Reverse adjacency, with the incoming edges of each node ordered by source.
+        inOffsets.resize(nodes.size() + 1);
+        for (size_t i = 0; i < nodes.size(); i++)
+            inOffsets[i + 1] = inOffsets[i] + inCounts[i + 1];
+
+        std::vector<uint32_t> inNext(inOffsets.begin(), inOffsets.end() - 1);
+        inEdges.resize(outEdges.size());
+        inSources.resize(outEdges.size());
+        for (node_descriptor source = 0; source < nodes.size(); source++) {
+            for (auto i = outOffsets[source]; i < outOffsets[source + 1]; i++) {
+                auto slot = inNext[outTargets[i]]++;
+                inEdges[slot] = outEdges[i];
+                inSources[slot] = source;
+            }
+        }
+    }
+
+    /// Return the descriptor of the specified node, or null_node if the node
+    /// was not part of the graph when the snapshot was built.
+    node_descriptor findNode(const NodeType& node) const {
+        auto it = nodeIndices.find(&node);
+        return it != nodeIndices.end() ? it->second : null_node;
+    }
+
+    /// Given a node descriptor, return the node by reference.
+    NodeType& getNode(node_descriptor node) const {
+        SLANG_ASSERT(node < nodes.size() && "Node does not exist");
+        return *nodes[node];
+    }
+
+    /// Return the edges outgoing from the specified node.
+    std::span<EdgeType* const> getOutEdges(node_descriptor node) const {
+        return std::span(outEdges).subspan(outOffsets[node], outDegree(node));
+    }
+
+    /// Return the target nodes of the edges outgoing from the specified node,
+    /// in the same order as @a getOutEdges.
+    std::span<const node_descriptor> getSuccessors(node_descriptor node) const {
+        return std::span(outTargets).subspan(outOffsets[node], outDegree(node));
+    }
+
+    /// Return the edges incident to the specified node.
+    std::span<EdgeType* const> getInEdges(node_descriptor node) const {
+        return std::span(inEdges).subspan(inOffsets[node], inDegree(node));
+    }
+
+    /// Return the source nodes of the edges incident to the specified node,
+    /// in the same order as @a getInEdges.
+    std::span<const node_descriptor> getPredecessors(node_descriptor node) const {
+        return std::span(inSources).subspan(inOffsets[node], inDegree(node));
+    }
+
+    /// Return the number of edges eminating from the specified node.
+    size_t outDegree(node_descriptor node) const {
+        return outOffsets[node + 1] - outOffsets[node];
+    }
+
+    /// Return the number of edges incident to the specified node.
+    size_t inDegree(node_descriptor node) const { return inOffsets[node + 1] - inOffsets[node]; }
+
+    /// Return the number of nodes in the graph.
+    size_t numNodes() const { return nodes.size(); }
+
+    /// Return the number of edges in the graph.
+    size_t numEdges() const { return outEdges.size(); }
+
+private:
+    std::vector<NodeType*> nodes;
+    slang::flat_hash_map<const NodeType*, node_descriptor> nodeIndices;
+    std::vector<uint32_t> outOffsets;
+    std::vector<EdgeType*> outEdges;
+    std::vector<node_descriptor> outTargets;
+    std::vector<uint32_t> inOffsets;
+    std::vector<EdgeType*> inEdges;
+    std::vector<node_descriptor> inSources;
+};
+
 } // namespace netlist
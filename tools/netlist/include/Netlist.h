@@ -12,13 +12,16 @@
 #include "DirectedGraph.h"
 #include "fmt/color.h"
 #include "fmt/format.h"
+#include <atomic>
 #include <iostream>
+#include <limits>
 
 #include "slang/ast/ASTVisitor.h"
 #include "slang/ast/symbols/CompilationUnitSymbols.h"
 #include "slang/diagnostics/TextDiagnosticClient.h"
 #include "slang/syntax/SyntaxTree.h"
 #include "slang/syntax/SyntaxVisitor.h"
+#include "slang/util/Hash.h"
 #include "slang/util/Util.h"
 
 using namespace slang;
@@ -55,7 +58,7 @@ struct VariableSelectorBase {
     template<typename T>
     const T& as() const {
         SLANG_ASSERT(T::isKind(kind));
-        return const_cast<T&>(this->as<T>());
+        return *(static_cast<const T*>(this));
     }
 };
 
@@ -151,7 +154,7 @@ public:
     template<typename T>
     const T& as() const {
         SLANG_ASSERT(T::isKind(kind));
-        return const_cast<T&>(this->as<T>());
+        return *(static_cast<const T*>(this));
     }
 
     /// Return the out degree of this node, including only enabled edges.
@@ -173,10 +176,12 @@ public:
     const ast::Symbol& symbol;
 
 private:
-    static size_t nextID;
+    friend class Netlist;
+
+    static std::atomic<size_t> nextID;
 };
 
-size_t NetlistNode::nextID = 0;
+std::atomic<size_t> NetlistNode::nextID = 0;
 
 /// A class representing a port declaration.
 class NetlistPortDeclaration : public NetlistNode {
@@ -238,6 +243,11 @@ public:
 
     bool isLeftOperand() const { return leftOperand; }
 
+    /// Whether the variable reference is the target of an assignment in a
+    /// sequential procedural block, which makes it the boundary of the
+    /// combinational logic that drives it.
+    bool isSequential() const { return sequential; }
+
     /// Return a string representation of the selectors applied to this
     /// variable reference.
     std::string selectorString() const {
@@ -257,8 +267,13 @@ public:
     /// Whether the variable reference is assignd to (ie appearing on the
     /// left-hand side of an assignent), or otherwise read from.
     bool leftOperand;
+    /// Whether the variable reference is assigned to in a sequential block.
+    bool sequential{};
     /// Selectors applied to the variable reference.
     SelectorsListType selectors;
+    /// The range of the variable's selectable bits that the reference selects,
+    /// as [lower, upper] offsets. The default range covers every bit.
+    std::pair<uint32_t, uint32_t> selectedBits{0, std::numeric_limits<uint32_t>::max()};
 };
 
 /// A class representing the design netlist.
@@ -266,13 +281,20 @@ class Netlist : public DirectedGraph<NetlistNode, NetlistEdge> {
 public:
     Netlist() : DirectedGraph() {}
 
+    /// Create a fragment of the given netlist. A fragment holds the variable
+    /// references and edges for part of the design, so that separate parts can
+    /// be built concurrently, and looks up declarations in its parent, which
+    /// must not be modified until the fragment has been merged back into it.
+    explicit Netlist(const Netlist* parent) : DirectedGraph(), parent(parent) {}
+
     /// Add a port declaration node to the netlist.
     NetlistPortDeclaration& addPortDeclaration(const ast::Symbol& symbol) {
+        SLANG_ASSERT(!parent && "Declarations can't be added to a netlist fragment");
         auto nodePtr = std::make_unique<NetlistPortDeclaration>(symbol);
         auto& node = nodePtr->as<NetlistPortDeclaration>();
         symbol.getHierarchicalPath(node.hierarchicalPath);
-        SLANG_ASSERT(lookupPort(nodePtr->hierarchicalPath) == nullptr &&
-                     "Port declaration already exists");
+        [[maybe_unused]] auto inserted = portsByPath.emplace(node.hierarchicalPath, &node).second;
+        SLANG_ASSERT(inserted && "Port declaration already exists");
         nodes.push_back(std::move(nodePtr));
         DEBUG_PRINT("Add port decl " << node.hierarchicalPath << "\n");
         return node;
@@ -280,11 +302,14 @@ public:
 
     /// Add a variable declaration node to the netlist.
     NetlistVariableDeclaration& addVariableDeclaration(const ast::Symbol& symbol) {
+        SLANG_ASSERT(!parent && "Declarations can't be added to a netlist fragment");
         auto nodePtr = std::make_unique<NetlistVariableDeclaration>(symbol);
         auto& node = nodePtr->as<NetlistVariableDeclaration>();
         symbol.getHierarchicalPath(node.hierarchicalPath);
-        SLANG_ASSERT(lookupVariable(nodePtr->hierarchicalPath) == nullptr &&
-                     "Variable declaration already exists");
+        [[maybe_unused]] auto inserted =
+            variablesByPath.emplace(node.hierarchicalPath, &node).second;
+        SLANG_ASSERT(inserted && "Variable declaration already exists");
+        variablesBySymbol.emplace(&symbol, &node);
         nodes.push_back(std::move(nodePtr));
         DEBUG_PRINT("Add var decl " << node.hierarchicalPath << "\n");
         return node;
@@ -310,27 +335,101 @@ public:
         return node;
     }
 
+    /// Add an edge between two nodes in the netlist. The edges of a fragment
+    /// can start at nodes owned by its parent, so they are only created once
+    /// the fragment is merged.
+    void addEdge(NetlistNode& sourceNode, NetlistNode& targetNode) {
+        if (parent)
+            pendingEdges.emplace_back(&sourceNode, &targetNode);
+        else
+            DirectedGraph::addEdge(sourceNode, targetNode);
+    }
+
+    /// Create the given number of fragments of this netlist, which must not be
+    /// modified until they have been merged back into it by @a mergeFragments.
+    std::vector<Netlist> createFragments(size_t count) {
+        SLANG_ASSERT(!parent && "Fragments can't be created from a fragment");
+        fragmentsFirstID = NetlistNode::nextID;
+
+        std::vector<Netlist> fragments;
+        fragments.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            fragments.emplace_back(this);
+        }
+        return fragments;
+    }
+
+    /// Merge fragments created by @a createFragments into this netlist in order,
+    /// taking ownership of their nodes and adding their edges in the order they
+    /// were added to each fragment. The nodes of the fragments took IDs in
+    /// whatever order the fragments happened to be built, so they are numbered
+    /// again from the first ID that was free when the fragments were created,
+    /// which gives them the same IDs as if they had been added here directly.
+    void mergeFragments(std::vector<Netlist>& fragments) {
+        NetlistNode::nextID = fragmentsFirstID;
+        for (auto& fragment : fragments) {
+            SLANG_ASSERT(fragment.parent == this && "Not a fragment of this netlist");
+            for (auto& node : fragment.nodes) {
+                node->ID = ++NetlistNode::nextID;
+                nodes.push_back(std::move(node));
+            }
+            for (auto [sourceNode, targetNode] : fragment.pendingEdges) {
+                DirectedGraph::addEdge(*sourceNode, *targetNode);
+            }
+            fragment.nodes.clear();
+            fragment.pendingEdges.clear();
+        }
+    }
+
     /// Find a variable declaration node in the netlist by hierarchical path.
-    /// TODO? Optimise this lookup by maintaining a list of declaration nodes.
-    NetlistNode* lookupVariable(const std::string& hierarchicalPath) {
-        auto compareNode = [&hierarchicalPath](const std::unique_ptr<NetlistNode>& node) {
-            return node->kind == NodeKind::VariableDeclaration &&
-                   node->as<NetlistVariableDeclaration>().hierarchicalPath == hierarchicalPath;
-        };
-        auto it = std::ranges::find_if(*this, compareNode);
-        return it != end() ? it->get() : nullptr;
+    NetlistNode* lookupVariable(std::string_view hierarchicalPath) const {
+        if (parent)
+            return parent->lookupVariable(hierarchicalPath);
+
+        auto it = variablesByPath.find(hierarchicalPath);
+        return it != variablesByPath.end() ? it->second : nullptr;
+    }
+
+    /// Find the variable declaration node in the netlist for the given symbol.
+    /// This avoids building the symbol's hierarchical path when the symbol is
+    /// the one the declaration was created from, and otherwise falls back to
+    /// looking up the declaration by path.
+    NetlistNode* lookupVariable(const ast::Symbol& symbol) const {
+        if (parent)
+            return parent->lookupVariable(symbol);
+
+        if (auto it = variablesBySymbol.find(&symbol); it != variablesBySymbol.end())
+            return it->second;
+
+        std::string hierarchicalPath;
+        symbol.getHierarchicalPath(hierarchicalPath);
+        return lookupVariable(hierarchicalPath);
     }
 
     /// Find a port declaration node in the netlist by hierarchical path.
-    /// TODO? Optimise this lookup by maintaining a list of port nodes.
-    NetlistNode* lookupPort(const std::string& hierarchicalPath) {
-        auto compareNode = [&hierarchicalPath](const std::unique_ptr<NetlistNode>& node) {
-            return node->kind == NodeKind::PortDeclaration &&
-                   node->as<NetlistPortDeclaration>().hierarchicalPath == hierarchicalPath;
-        };
-        auto it = std::ranges::find_if(*this, compareNode);
-        return it != end() ? it->get() : nullptr;
+    NetlistNode* lookupPort(std::string_view hierarchicalPath) const {
+        if (parent)
+            return parent->lookupPort(hierarchicalPath);
+
+        auto it = portsByPath.find(hierarchicalPath);
+        return it != portsByPath.end() ? it->second : nullptr;
     }
+
+private:
+    // Indices of declaration nodes. Nodes are never removed from the netlist
+    // and their paths don't change once added, so the keys can refer to the
+    // path strings owned by the nodes themselves.
+    flat_hash_map<std::string_view, NetlistNode*> variablesByPath;
+    flat_hash_map<const ast::Symbol*, NetlistNode*> variablesBySymbol;
+    flat_hash_map<std::string_view, NetlistNode*> portsByPath;
+
+    // The netlist this is a fragment of, if any, and the edges added to the
+    // fragment that are waiting for it to be merged.
+    const Netlist* parent = nullptr;
+    std::vector<std::pair<NetlistNode*, NetlistNode*>> pendingEdges;
+
+    // The next free node ID from when fragments of this netlist were created.
+    size_t fragmentsFirstID = 0;
 };
 
 } // namespace netlist
@@ -21,34 +21,30 @@
 #include "slang/ast/EvalContext.h"
 #include "slang/ast/SemanticFacts.h"
 #include "slang/ast/Symbol.h"
+#include "slang/ast/TimingControl.h"
 #include "slang/ast/symbols/BlockSymbols.h"
 #include "slang/ast/symbols/CompilationUnitSymbols.h"
 #include "slang/diagnostics/TextDiagnosticClient.h"
 #include "slang/syntax/SyntaxTree.h"
 #include "slang/syntax/SyntaxVisitor.h"
+#include "slang/util/ThreadPool.h"
 #include "slang/util/Util.h"
 
 using namespace slang;
 
 namespace netlist {
 
-static std::string getSymbolHierPath(const ast::Symbol& symbol) {
-    std::string buffer;
-    symbol.getHierarchicalPath(buffer);
-    return buffer;
-}
-
 static void connectDeclToVar(Netlist& netlist, NetlistNode& varNode,
-                             const std::string& hierarchicalPath) {
-    auto* variableNode = netlist.lookupVariable(hierarchicalPath);
+                             const ast::Symbol& declSymbol) {
+    auto* variableNode = netlist.lookupVariable(declSymbol);
     netlist.addEdge(*variableNode, varNode);
     DEBUG_PRINT(
         fmt::format("Edge decl {} to ref {}\n", variableNode->getName(), varNode.getName()));
 }
 
 static void connectVarToDecl(Netlist& netlist, NetlistNode& varNode,
-                             const std::string& hierarchicalPath) {
-    auto* portNode = netlist.lookupVariable(hierarchicalPath);
+                             const ast::Symbol& declSymbol) {
+    auto* portNode = netlist.lookupVariable(declSymbol);
     netlist.addEdge(varNode, *portNode);
     DEBUG_PRINT(
         fmt::format("Edge ref {} to port ref {}\n", varNode.getName(), portNode->getName()));
@@ -88,6 +84,7 @@ public:
                 node.addMemberAccess(selector->as<ast::MemberAccessExpression>().member.name);
             }
         }
+        node.selectedBits = getSelectedBits(expr);
         selectors.clear();
     }
 
@@ -109,6 +106,61 @@ public:
     std::vector<NetlistNode*>& getVars() { return varList; }
 
 private:
+    /// Return the value a selector expression is applied to.
+    static const ast::Expression* getSelectorValue(const ast::Expression& selector) {
+        switch (selector.kind) {
+            case ast::ExpressionKind::ElementSelect:
+                return &selector.as<ast::ElementSelectExpression>().value();
+            case ast::ExpressionKind::RangeSelect:
+                return &selector.as<ast::RangeSelectExpression>().value();
+            case ast::ExpressionKind::MemberAccess:
+                return &selector.as<ast::MemberAccessExpression>().value();
+            default:
+                return nullptr;
+        }
+    }
+
+    /// Return the range of bits of a variable that are selected by the current
+    /// selectors, in the same form as the bounds of value drivers. Selectors are
+    /// applied from the innermost one outwards, and if one of them can't be
+    /// evaluated the range selected by the ones inside it is used instead.
+    std::pair<uint32_t, uint32_t> getSelectedBits(const ast::NamedValueExpression& expr) {
+        auto type = &expr.type->getCanonicalType();
+        auto width = type->getSelectableWidth();
+        if (!type->isFixedSize() || !width) {
+            return {0, std::numeric_limits<uint32_t>::max()};
+        }
+
+        std::pair<uint32_t, uint32_t> result{0, width - 1};
+        const ast::Expression* prefix = &expr;
+        for (auto it = selectors.rbegin(); it != selectors.rend(); it++) {
+            auto& selector = **it;
+            if (getSelectorValue(selector) != prefix || !type->isFixedSize()) {
+                break;
+            }
+
+            auto range = selector.evalSelector(evalCtx);
+            if (!range || range->lower() < 0) {
+                break;
+            }
+
+            if (type->kind == ast::SymbolKind::FixedSizeUnpackedArrayType) {
+                // Unpacked arrays select elements instead of bits.
+                auto elemWidth = type->getArrayElementType()->getSelectableWidth();
+                result.first += uint32_t(range->lower()) * elemWidth;
+                result.second = result.first + range->width() * elemWidth - 1;
+            }
+            else {
+                result.first += uint32_t(range->lower());
+                result.second = result.first + range->width() - 1;
+            }
+
+            type = &selector.type->getCanonicalType();
+            prefix = &selector;
+        }
+        return result;
+    }
+
     Netlist& netlist;
     ast::EvalContext& evalCtx;
     /// Whether this traversal is the target of an assignment or not.
@@ -122,30 +174,35 @@ private:
 class AssignmentVisitor : public ast::ASTVisitor<AssignmentVisitor, false, true> {
 public:
     explicit AssignmentVisitor(Netlist& netlist, ast::EvalContext& evalCtx,
-                               SmallVector<NetlistNode*>& condVars) :
+                               SmallVector<NetlistNode*>& condVars, bool sequential = false) :
         netlist(netlist),
-        evalCtx(evalCtx), condVars(condVars) {}
+        evalCtx(evalCtx), condVars(condVars), sequential(sequential) {}
 
     void handle(const ast::AssignmentExpression& expr) {
         // Collect variable references on the left-hand side of the assignment.
         VariableReferenceVisitor visitorLHS(netlist, evalCtx, true);
         expr.left().visit(visitorLHS);
+        if (sequential) {
+            for (auto* leftNode : visitorLHS.getVars()) {
+                leftNode->as<NetlistVariableReference>().sequential = true;
+            }
+        }
         // Collect variable references on the right-hand side of the assignment.
         VariableReferenceVisitor visitorRHS(netlist, evalCtx, false);
         expr.right().visit(visitorRHS);
         for (auto* leftNode : visitorLHS.getVars()) {
             // Add edge from LHS variable refrence to variable declaration.
-            connectVarToDecl(netlist, *leftNode, getSymbolHierPath(leftNode->symbol));
+            connectVarToDecl(netlist, *leftNode, leftNode->symbol);
             for (auto* rightNode : visitorRHS.getVars()) {
                 // Add edge from variable declaration to RHS variable reference.
-                connectDeclToVar(netlist, *rightNode, getSymbolHierPath(rightNode->symbol));
+                connectDeclToVar(netlist, *rightNode, rightNode->symbol);
                 // Add edge form RHS expression term to LHS expression terms.
                 connectVarToVar(netlist, *rightNode, *leftNode);
             }
         }
         for (auto* condNode : condVars) {
             // Add edge from conditional variable declaraiton to the reference.
-            connectDeclToVar(netlist, *condNode, getSymbolHierPath(condNode->symbol));
+            connectDeclToVar(netlist, *condNode, condNode->symbol);
             for (auto* leftNode : visitorLHS.getVars()) {
                 // Add edge from conditional variable to the LHS variable.
                 connectVarToVar(netlist, *condNode, *leftNode);
@@ -157,6 +214,8 @@ private:
     Netlist& netlist;
     ast::EvalContext& evalCtx;
     SmallVector<NetlistNode*>& condVars;
+    /// Whether the assignment is made in a sequential procedural block.
+    bool sequential;
 };
 
 /// An AST visitor for proceural blocks that performs loop unrolling.
@@ -164,12 +223,38 @@ class ProceduralBlockVisitor : public ast::ASTVisitor<ProceduralBlockVisitor, tr
 public:
     bool anyErrors = false;
 
-    explicit ProceduralBlockVisitor(ast::Compilation& compilation, Netlist& netlist) :
+    explicit ProceduralBlockVisitor(ast::Compilation& compilation, Netlist& netlist,
+                                    bool sequential = false) :
         netlist(netlist),
-        evalCtx(ast::ASTContext(compilation.getRoot(), ast::LookupLocation::max)) {
+        evalCtx(ast::ASTContext(compilation.getRoot(), ast::LookupLocation::max)),
+        sequential(sequential) {
         evalCtx.pushEmptyFrame();
     }
 
+    /// Return true if the given procedural block describes sequential logic,
+    /// ie it is an always_ff block, or an always block that is triggered by
+    /// the edge of a signal.
+    static bool isSequential(const ast::ProceduralBlockSymbol& block) {
+        if (block.procedureKind == ast::ProceduralBlockKind::AlwaysFF) {
+            return true;
+        }
+        auto& body = block.getBody();
+        if (block.procedureKind != ast::ProceduralBlockKind::Always ||
+            body.kind != ast::StatementKind::Timed) {
+            return false;
+        }
+        auto isEdge = [](const ast::TimingControl& timing) {
+            return timing.kind == ast::TimingControlKind::SignalEvent &&
+                   timing.as<ast::SignalEventControl>().edge != ast::EdgeKind::None;
+        };
+        auto& timing = body.as<ast::TimedStatement>().timing;
+        if (timing.kind == ast::TimingControlKind::EventList) {
+            return std::ranges::any_of(timing.as<ast::EventListControl>().events,
+                                       [&](auto* event) { return isEdge(*event); });
+        }
+        return isEdge(timing);
+    }
+
     void handle(const ast::ForLoopStatement& loop) {
 
         // Conditions this loop cannot be unrolled.
@@ -304,7 +389,7 @@ public:
 
     void handle(const ast::ExpressionStatement& stmt) {
         step();
-        AssignmentVisitor visitor(netlist, evalCtx, condVarsStack);
+        AssignmentVisitor visitor(netlist, evalCtx, condVarsStack, sequential);
         stmt.visit(visitor);
     }
 
@@ -320,20 +405,43 @@ private:
     Netlist& netlist;
     ast::EvalContext evalCtx;
     SmallVector<NetlistNode*> condVarsStack;
+    bool sequential;
 };
 
 /// A visitor that traverses the AST and builds a netlist representation.
 class NetlistVisitor : public ast::ASTVisitor<NetlistVisitor, true, false> {
 public:
-    explicit NetlistVisitor(ast::Compilation& compilation, Netlist& netlist) :
-        compilation(compilation), netlist(netlist) {}
+    /// If a list of deferred blocks is given, procedural blocks and continuous
+    /// assignments are added to it instead of being visited, so they can be
+    /// visited separately with visitBlock().
+    explicit NetlistVisitor(ast::Compilation& compilation, Netlist& netlist,
+                            std::vector<const ast::Symbol*>* deferredBlocks = nullptr) :
+        compilation(compilation), netlist(netlist), deferredBlocks(deferredBlocks) {}
+
+    /// Add the variable references and edges of a procedural block or
+    /// continuous assignment to the netlist.
+    static void visitBlock(ast::Compilation& compilation, Netlist& netlist,
+                           const ast::Symbol& symbol) {
+        if (symbol.kind == ast::SymbolKind::ProceduralBlock) {
+            auto& block = symbol.as<ast::ProceduralBlockSymbol>();
+            ProceduralBlockVisitor visitor(compilation, netlist,
+                                           ProceduralBlockVisitor::isSequential(block));
+            symbol.visit(visitor);
+        }
+        else {
+            SLANG_ASSERT(symbol.kind == ast::SymbolKind::ContinuousAssign);
+            ast::EvalContext evalCtx(
+                ast::ASTContext(compilation.getRoot(), ast::LookupLocation::max));
+            SmallVector<NetlistNode*> condVars;
+            AssignmentVisitor visitor(netlist, evalCtx, condVars);
+            symbol.visit(visitor);
+        }
+    }
 
     /// Connect ports of a module instance to their corresponding variables.
     void connectInstancePort(NetlistNode& port) {
         if (auto* internalSymbol = port.symbol.as<ast::PortSymbol>().internalSymbol) {
-            std::string pathBuffer;
-            internalSymbol->getHierarchicalPath(pathBuffer);
-            auto* variableNode = netlist.lookupVariable(pathBuffer);
+            auto* variableNode = netlist.lookupVariable(*internalSymbol);
             switch (port.symbol.as<ast::PortSymbol>().direction) {
                 case ast::ArgumentDirection::In:
                     netlist.addEdge(port, *variableNode);
@@ -414,18 +522,18 @@ public:
             for (auto* node : visitor.getVars()) {
                 switch (portDirection) {
                     case ast::ArgumentDirection::In:
-                        connectDeclToVar(netlist, *node, getSymbolHierPath(node->symbol));
-                        connectVarToDecl(netlist, *node, getSymbolHierPath(portConnection->port));
+                        connectDeclToVar(netlist, *node, node->symbol);
+                        connectVarToDecl(netlist, *node, portConnection->port);
                         break;
                     case ast::ArgumentDirection::Out:
-                        connectDeclToVar(netlist, *node, getSymbolHierPath(portConnection->port));
-                        connectVarToDecl(netlist, *node, getSymbolHierPath(node->symbol));
+                        connectDeclToVar(netlist, *node, portConnection->port);
+                        connectVarToDecl(netlist, *node, node->symbol);
                         break;
                     case ast::ArgumentDirection::InOut:
-                        connectDeclToVar(netlist, *node, getSymbolHierPath(node->symbol));
-                        connectDeclToVar(netlist, *node, getSymbolHierPath(portConnection->port));
-                        connectVarToDecl(netlist, *node, getSymbolHierPath(node->symbol));
-                        connectVarToDecl(netlist, *node, getSymbolHierPath(portConnection->port));
+                        connectDeclToVar(netlist, *node, node->symbol);
+                        connectDeclToVar(netlist, *node, portConnection->port);
+                        connectVarToDecl(netlist, *node, node->symbol);
+                        connectVarToDecl(netlist, *node, portConnection->port);
                         break;
                     case ast::ArgumentDirection::Ref:
                         break;
@@ -437,21 +545,67 @@ public:
 
     /// Procedural block.
     void handle(const ast::ProceduralBlockSymbol& symbol) {
-        ProceduralBlockVisitor visitor(compilation, netlist);
-        symbol.visit(visitor);
+        if (deferredBlocks) {
+            // The body is bound lazily, so make sure that happens here rather
+            // than when the block is visited, which may be on another thread.
+            symbol.getBody();
+            deferredBlocks->push_back(&symbol);
+            return;
+        }
+        visitBlock(compilation, netlist, symbol);
     }
 
     /// Continuous assignment statement.
     void handle(const ast::ContinuousAssignSymbol& symbol) {
-        ast::EvalContext evalCtx(ast::ASTContext(compilation.getRoot(), ast::LookupLocation::max));
-        SmallVector<NetlistNode*> condVars;
-        AssignmentVisitor visitor(netlist, evalCtx, condVars);
-        symbol.visit(visitor);
+        if (deferredBlocks) {
+            symbol.getAssignment();
+            deferredBlocks->push_back(&symbol);
+            return;
+        }
+        visitBlock(compilation, netlist, symbol);
     }
 
 private:
     ast::Compilation& compilation;
     Netlist& netlist;
+    std::vector<const ast::Symbol*>* deferredBlocks;
 };
 
+/// Build the netlist of a compilation. Declarations, ports and port connections
+/// are added by a single walk over the design, which also collects its
+/// procedural blocks and continuous assignments. Those are then each built
+/// into their own fragment of the netlist, concurrently on a thread pool with
+/// the given number of threads (zero meaning one per hardware thread), and the
+/// fragments are merged in the order the blocks appear in the design. The
+/// resulting netlist is the same regardless of the number of threads.
+///
+/// Blocks are built by evaluating their expressions from several threads at
+/// once, which requires the compilation to have been fully elaborated (for
+/// example by getting its diagnostics) without instance caching, so that none
+/// of the AST is created lazily while building.
+static void buildNetlist(ast::Compilation& compilation, Netlist& netlist,
+                         unsigned numThreads = 0) {
+    std::vector<const ast::Symbol*> blocks;
+    NetlistVisitor visitor(compilation, netlist, &blocks);
+    compilation.getRoot().visit(visitor);
+
+    if (numThreads == 1 || blocks.size() <= 1) {
+        for (auto* block : blocks) {
+            NetlistVisitor::visitBlock(compilation, netlist, *block);
+        }
+        return;
+    }
+
+    auto fragments = netlist.createFragments(blocks.size());
+    ThreadPool threadPool(numThreads);
+    threadPool.pushLoop(size_t(0), blocks.size(), [&](size_t from, size_t to) {
+        for (size_t i = from; i < to; i++) {
+            NetlistVisitor::visitBlock(compilation, fragments[i], *blocks[i]);
+        }
+    });
+    threadPool.waitForAll();
+
+    netlist.mergeFragments(fragments);
+}
+
 } // namespace netlist
@@ -10,9 +10,9 @@
 #include "DepthFirstSearch.h"
 #include "Netlist.h"
 #include "NetlistPath.h"
-#include <map>
 #include <vector>
 
+#include "slang/util/Hash.h"
 #include "slang/util/Util.h"
 
 namespace netlist {
@@ -24,7 +24,7 @@ private:
     /// can only have one parent node. This map captures these relationships and
     /// is used to determine paths between leaf nodes and the root node of the
     /// tree.
-    using TraversalMap = std::map<NetlistNode*, NetlistNode*>;
+    using TraversalMap = flat_hash_map<NetlistNode*, NetlistNode*>;
 
     /// A visitor for the search that constructs the traversal map.
     class Visitor {
@@ -51,7 +51,10 @@ private:
     };
 
 public:
-    PathFinder(Netlist& netlist) : netlist(netlist) {}
+    /// Searches are done over a compressed snapshot of the netlist that is taken
+    /// here, so the structure of the netlist must not change while the path
+    /// finder is in use (enabling or disabling edges is fine).
+    PathFinder(Netlist& netlist) : netlist(netlist), graph(netlist) {}
 
     NetlistPath buildPath(TraversalMap& traversalMap, NetlistNode& startNode,
                           NetlistNode& endNode) {
@@ -82,12 +85,14 @@ public:
     NetlistPath find(NetlistNode& startNode, NetlistNode& endNode) {
         TraversalMap traversalMap;
         Visitor visitor(netlist, traversalMap);
-        DepthFirstSearch<NetlistNode, NetlistEdge, Visitor, EdgePredicate> dfs(visitor, startNode);
+        DepthFirstSearch<NetlistNode, NetlistEdge, Visitor, EdgePredicate> dfs(
+            visitor, EdgePredicate(), graph, startNode);
         return buildPath(traversalMap, startNode, endNode);
     }
 
 private:
     Netlist& netlist;
+    CompressedGraph<NetlistNode, NetlistEdge> graph;
 };
 
 } // namespace netlist
@@ -14,71 +14,27 @@
 #include <utility>
 
 #include "slang/ast/types/Type.h"
+#include "slang/util/BumpAllocator.h"
+#include "slang/util/IntervalMap.h"
 #include "slang/util/Util.h"
 
 namespace netlist {
 
 /// A class to perform a transformation on the netlist to split variable
 /// declaration nodes of structured types into multiple parts based on the
-/// types of the incoming and outgoing edges.
+/// bits of the variable selected by the references at either end of their
+/// incoming and outgoing edges.
 class SplitVariables {
 public:
     SplitVariables(Netlist& netlist) : netlist(netlist) { split(); }
 
 private:
-    /// Given two ranges [end1:start1] and [end2:start2], return true if there is
-    /// any overlap in values between them.
-    inline bool rangesOverlap(size_t start1, size_t end1, size_t start2, size_t end2) const {
-        return start1 <= end2 && start2 <= end1;
-    }
-
-    /// Return true if the selection made by the target node intersects with the
-    /// selection made by the source node.
-    bool isIntersectingSelection(NetlistVariableReference& sourceNode,
-                                 NetlistVariableReference& targetNode) const {
-        bool match = true;
-        size_t selectorDepth = 0;
-        while (match) {
-            // Terminate the loop if either variable reference has no further
-            // selectors.
-            if (selectorDepth >= sourceNode.selectors.size() ||
-                selectorDepth >= targetNode.selectors.size()) {
-                break;
-            }
-            auto& sourceSelector = sourceNode.selectors[selectorDepth];
-            auto& targetSelector = targetNode.selectors[selectorDepth];
-            SLANG_ASSERT(sourceSelector->kind == targetSelector->kind && "selectors do not match");
-            switch (sourceSelector->kind) {
-                case VariableSelectorKind::ElementSelect:
-                    // Matching selectors if the index is the same.
-                    match = sourceSelector->as<VariableElementSelect>().getIndexInt() ==
-                            targetSelector->as<VariableElementSelect>().getIndexInt();
-                    break;
-                case VariableSelectorKind::RangeSelect: {
-                    // Matching selectors if there is any overlap in the two ranges.
-                    auto sourceRangeSel = sourceSelector->as<VariableRangeSelect>();
-                    auto targetRangeSel = targetSelector->as<VariableRangeSelect>();
-                    auto srcLeft = sourceRangeSel.getLeftIndexInt();
-                    auto srcRight = sourceRangeSel.getRightIndexInt();
-                    auto tgtLeft = targetRangeSel.getLeftIndexInt();
-                    auto tgtRight = targetRangeSel.getRightIndexInt();
-                    match = rangesOverlap(srcRight, srcLeft, tgtRight, tgtLeft);
-                    break;
-                }
-                case VariableSelectorKind::MemberAccess:
-                    // Matching selectors if the member names match.
-                    match = sourceSelector->as<VariableMemberAccess>().name ==
-                            targetSelector->as<VariableMemberAccess>().name;
-                    break;
-            }
-            selectorDepth++;
-        }
-        return match;
-    }
-
     void split() {
         std::vector<std::tuple<NetlistVariableDeclaration*, NetlistEdge*, NetlistEdge*>>
             modifications;
+        // Incoming edges are found via a compressed snapshot of the netlist,
+        // which stays valid since the netlist isn't changed until afterwards.
+        CompressedGraph<NetlistNode, NetlistEdge> graph(netlist);
         // Find each variable declaration nodes in the graph that has multiple
         // outgoing edges.
         for (auto& node : netlist) {
@@ -87,33 +43,48 @@ private:
                 auto& varType = varDeclNode.symbol.getDeclaredType()->getType();
                 DEBUG_PRINT(fmt::format("Variable {} has type {}\n", varDeclNode.hierarchicalPath,
                                         varType.toString()));
-                std::vector<NetlistEdge*> inEdges;
-                netlist.getInEdgesToNode(*node, inEdges);
+                auto inEdges = graph.getInEdges(graph.findNode(*node));
+                // Index the variable references that the declaration has
+                // outgoing edges to by the bits of the variable they select.
+                auto& outEdges = node->getEdges();
+                for (size_t i = 0; i < outEdges.size(); i++) {
+                    auto& targetNode = outEdges[i]->getTargetNode();
+                    if (targetNode.kind == NodeKind::VariableReference) {
+                        auto& targetVarRef = targetNode.as<NetlistVariableReference>();
+                        targetsByBits.insert(targetVarRef.selectedBits, uint32_t(i),
+                                             mapAllocator);
+                    }
+                }
                 // Find pairs of input and output edges that are attached to variable
                 // refertence nodes. Eg.
                 //   var ref -> var decl -> var ref
-                // If the variable references select the same part of a structured
-                // variable, then transform them into:
+                // If the variable references select overlapping bits of a
+                // structured variable, then transform them into:
                 //   var ref -> var alias -> var ref
                 // And mark the original edges as disabled.
                 for (auto* inEdge : inEdges) {
-                    for (auto& outEdge : *node) {
-                        if (inEdge->getSourceNode().kind == NodeKind::VariableReference &&
-                            outEdge->getTargetNode().kind == NodeKind::VariableReference) {
-                            auto& sourceVarRef =
-                                inEdge->getSourceNode().as<NetlistVariableReference>();
-                            auto& targetVarRef =
-                                outEdge->getTargetNode().as<NetlistVariableReference>();
-                            auto match = isIntersectingSelection(sourceVarRef, targetVarRef);
-                            if (match) {
-                                DEBUG_PRINT(
-                                    fmt::format("New dependency through variable {} -> {}\n",
-                                                sourceVarRef.toString(), targetVarRef.toString()));
-                                modifications.emplace_back(&varDeclNode, inEdge, outEdge.get());
-                            }
-                        }
+                    if (inEdge->getSourceNode().kind != NodeKind::VariableReference) {
+                        continue;
+                    }
+                    auto& sourceVarRef = inEdge->getSourceNode().as<NetlistVariableReference>();
+                    // Keep the matches in the order of the outgoing edges so that
+                    // aliases are created in a deterministic order.
+                    matchingEdges.clear();
+                    auto [lower, upper] = sourceVarRef.selectedBits;
+                    for (auto it = targetsByBits.find(lower, upper); it != targetsByBits.end();
+                         ++it) {
+                        matchingEdges.push_back(*it);
+                    }
+                    std::ranges::sort(matchingEdges);
+                    for (auto index : matchingEdges) {
+                        auto* outEdge = outEdges[index].get();
+                        DEBUG_PRINT(fmt::format(
+                            "New dependency through variable {} -> {}\n", sourceVarRef.toString(),
+                            outEdge->getTargetNode().as<NetlistVariableReference>().toString()));
+                        modifications.emplace_back(&varDeclNode, inEdge, outEdge);
                     }
                 }
+                targetsByBits.clear(mapAllocator);
             }
         }
         // Apply the operations to the graph.
@@ -134,6 +105,10 @@ private:
 
 private:
     Netlist& netlist;
+    BumpAllocator alloc;
+    IntervalMap<uint32_t, uint32_t>::allocator_type mapAllocator{alloc};
+    IntervalMap<uint32_t, uint32_t> targetsByBits;
+    std::vector<uint32_t> matchingEdges;
 };
 
 } // namespace netlist
@@ -7,6 +7,7 @@
 //------------------------------------------------------------------------------
 #include "Netlist.h"
 
+#include "ConeQuery.h"
 #include "NetlistVisitor.h"
 #include "PathFinder.h"
 #include "SplitVariables.h"
@@ -108,6 +109,39 @@ void printDOT(const Netlist& netlist, const std::string& fileName) {
     writeToFile(fileName, buffer.data());
 }
 
+void printCones(const Netlist& netlist, const ConeQuery& query,
+                const std::vector<std::string>& fanInNames,
+                const std::vector<NetlistNode*>& fanInPoints,
+                const std::vector<std::string>& fanOutNames,
+                const std::vector<NetlistNode*>& fanOutPoints, const std::string& fileName) {
+    JsonWriter writer;
+    writer.setPrettyPrint(true);
+    auto writeCones = [&](std::string_view property, const std::vector<std::string>& names,
+                          const std::vector<NetlistNode*>& points, ConeDirection direction) {
+        auto cones = query.find(points, direction);
+        writer.writeProperty(property);
+        writer.startArray();
+        for (size_t i = 0; i < cones.size(); i++) {
+            writer.startObject();
+            writer.writeProperty("point");
+            writer.writeValue(names[i]);
+            writer.writeProperty("signals");
+            writer.startArray();
+            for (auto& signal : ConeQuery::getSignals(netlist, *points[i], cones[i])) {
+                writer.writeValue(signal);
+            }
+            writer.endArray();
+            writer.endObject();
+        }
+        writer.endArray();
+    };
+    writer.startObject();
+    writeCones("fanIn", fanInNames, fanInPoints, ConeDirection::FanIn);
+    writeCones("fanOut", fanOutNames, fanOutPoints, ConeDirection::FanOut);
+    writer.endObject();
+    writeToFile(fileName, writer.view());
+}
+
 template<typename Stream, typename String>
 void writeToFile(Stream& os, std::string_view fileName, String contents) {
     os.write(contents.data(), contents.size());
@@ -211,6 +245,24 @@ int main(int argc, char** argv) {
     std::optional<std::string> toPointName;
     driver.cmdLine.add("--to", toPointName, "Specify a finish point to trace a path to", "<name>");
 
+    std::vector<std::string> fanInNames;
+    driver.cmdLine.add("--fan-in", fanInNames,
+                       "Specify a point to find the fan-in cone of, which can be given "
+                       "multiple times to find many cones at once",
+                       "<name>");
+
+    std::vector<std::string> fanOutNames;
+    driver.cmdLine.add("--fan-out", fanOutNames,
+                       "Specify a point to find the fan-out cone of, which can be given "
+                       "multiple times to find many cones at once",
+                       "<name>");
+
+    std::optional<std::string> conesJsonFile;
+    driver.cmdLine.add("--cones-json", conesJsonFile,
+                       "Write the cones found by --fan-in and --fan-out in JSON format to the "
+                       "specified file, or '-' for stdout (the default)",
+                       "<file>", CommandLineFlags::FilePath);
+
     if (!driver.parseCommandLine(argc, argv)) {
         return 1;
     }
@@ -236,6 +288,13 @@ int main(int argc, char** argv) {
         Config::getInstance().debugEnabled = true;
     }
 
+    // The blocks in every instance body are built into the netlist on worker
+    // threads, where nothing can be elaborated lazily. With instance caching,
+    // collecting diagnostics only fully elaborates one body out of each set of
+    // identical instances, so turn it off to have every body elaborated before
+    // the netlist is built.
+    driver.options.disableInstanceCaching = true;
+
     SLANG_TRY {
 
         bool ok = driver.parseAllSources();
@@ -254,8 +313,7 @@ int main(int argc, char** argv) {
 
         // Create the netlist by traversing the AST.
         Netlist netlist;
-        NetlistVisitor visitor(*compilation, netlist);
-        compilation->getRoot().visit(visitor);
+        buildNetlist(*compilation, netlist, driver.options.numThreads.value_or(0));
         SplitVariables splitVariables(netlist);
         DEBUG_PRINT(fmt::format("Netlist has {} nodes and {} edges\n", netlist.numNodes(),
                                 netlist.numEdges()));
@@ -266,6 +324,31 @@ int main(int argc, char** argv) {
             return 0;
         }
 
+        // Find the fan-in and fan-out cones of points in the netlist.
+        if (!fanInNames.empty() || !fanOutNames.empty()) {
+            auto lookupPoints = [&](const std::vector<std::string>& names) {
+                std::vector<NetlistNode*> points;
+                for (auto& name : names) {
+                    auto* point = netlist.lookupVariable(name);
+                    if (point == nullptr) {
+                        point = netlist.lookupPort(name);
+                    }
+                    if (point == nullptr) {
+                        SLANG_THROW(
+                            std::runtime_error(fmt::format("could not find point: {}", name)));
+                    }
+                    points.push_back(point);
+                }
+                return points;
+            };
+            auto fanInPoints = lookupPoints(fanInNames);
+            auto fanOutPoints = lookupPoints(fanOutNames);
+            ConeQuery query(netlist);
+            printCones(netlist, query, fanInNames, fanInPoints, fanOutNames, fanOutPoints,
+                       conesJsonFile.value_or("-"));
+            return 0;
+        }
+
         // Find a point-to-point path in the netlist.
         if (fromPointName.has_value() && toPointName.has_value()) {
             if (!fromPointName.has_value()) {
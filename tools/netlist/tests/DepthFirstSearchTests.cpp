@@ -74,6 +74,13 @@ TEST_CASE("Depth-first search on a tree") {
     graph.addEdge(n2, n6);
     TestVisitor visitor;
     DepthFirstSearch<TestNode, TestEdge, TestVisitor> dfs(visitor, n0);
+    // Searching a compressed snapshot visits everything in the same order.
+    TestVisitor compressedVisitor;
+    CompressedGraph<TestNode, TestEdge> compressed(graph);
+    DepthFirstSearch<TestNode, TestEdge, TestVisitor> compressedDfs(compressedVisitor, compressed,
+                                                                    n0);
+    CHECK(compressedVisitor.nodes == visitor.nodes);
+    CHECK(compressedVisitor.edges == visitor.edges);
     CHECK(visitor.nodes.size() == 7);
     CHECK(visitor.edges.size() == 6);
     CHECK(*visitor.nodes[0] == n0);
@@ -105,6 +112,11 @@ TEST_CASE("Depth-first search with an edge predicate") {
     graph.addEdge(n0, n4);
     TestVisitor visitor;
     DepthFirstSearch<TestNode, TestEdge, TestVisitor, EdgesToOnlyEvenNodes> dfs(visitor, n0);
+    TestVisitor compressedVisitor;
+    CompressedGraph<TestNode, TestEdge> compressed(graph);
+    DepthFirstSearch<TestNode, TestEdge, TestVisitor, EdgesToOnlyEvenNodes> compressedDfs(
+        compressedVisitor, EdgesToOnlyEvenNodes(), compressed, n0);
+    CHECK(compressedVisitor.nodes == visitor.nodes);
     CHECK(visitor.nodes.size() == 3);
     CHECK(visitor.edges.size() == 2);
     CHECK(*visitor.nodes[0] == n0);
@@ -171,3 +171,57 @@ TEST_CASE("Test iterating over nodes and node's edges") {
         CHECK(count == 0);
     }
 }
+
+TEST_CASE("Test compressed graph") {
+    DirectedGraph<TestNode, TestEdge> graph;
+    auto& n0 = graph.addNode();
+    auto& n1 = graph.addNode();
+    auto& n2 = graph.addNode();
+    auto& n3 = graph.addNode();
+    auto& e0 = graph.addEdge(n0, n1);
+    auto& e1 = graph.addEdge(n0, n2);
+    auto& e2 = graph.addEdge(n0, n3);
+    auto& e3 = graph.addEdge(n1, n2);
+    auto& e4 = graph.addEdge(n1, n3);
+    auto& e5 = graph.addEdge(n2, n3);
+    CompressedGraph<TestNode, TestEdge> compressed(graph);
+    CHECK(compressed.numNodes() == 4);
+    CHECK(compressed.numEdges() == 6);
+    auto d0 = compressed.findNode(n0);
+    auto d1 = compressed.findNode(n1);
+    auto d2 = compressed.findNode(n2);
+    auto d3 = compressed.findNode(n3);
+    CHECK(compressed.getNode(d2) == n2);
+    // Degrees match the source graph.
+    for (auto& node : graph) {
+        auto d = compressed.findNode(*node);
+        CHECK(compressed.outDegree(d) == graph.outDegree(*node));
+        CHECK(compressed.inDegree(d) == graph.inDegree(*node));
+    }
+    // Outgoing edges are in the same order as the node's edge list.
+    auto outEdges = compressed.getOutEdges(d0);
+    REQUIRE(outEdges.size() == 3);
+    CHECK(*outEdges[0] == e0);
+    CHECK(*outEdges[1] == e1);
+    CHECK(*outEdges[2] == e2);
+    auto successors = compressed.getSuccessors(d1);
+    REQUIRE(successors.size() == 2);
+    CHECK(successors[0] == d2);
+    CHECK(successors[1] == d3);
+    // Incoming edges are ordered by their source node.
+    auto inEdges = compressed.getInEdges(d3);
+    REQUIRE(inEdges.size() == 3);
+    CHECK(*inEdges[0] == e2);
+    CHECK(*inEdges[1] == e4);
+    CHECK(*inEdges[2] == e5);
+    auto predecessors = compressed.getPredecessors(d2);
+    REQUIRE(predecessors.size() == 2);
+    CHECK(predecessors[0] == d0);
+    CHECK(predecessors[1] == d1);
+    CHECK(compressed.getInEdges(d0).empty());
+    CHECK(*compressed.getInEdges(d1)[0] == e0);
+    CHECK(*compressed.getInEdges(d2)[1] == e3);
+    // Nodes added afterwards aren't part of the snapshot.
+    auto& n4 = graph.addNode();
+    CHECK(compressed.findNode(n4) == compressed.null_node);
+}
@@ -6,6 +6,7 @@
 // SPDX-License-Identifier: MIT
 //------------------------------------------------------------------------------
 
+#include "ConeQuery.h"
 #include "Netlist.h"
 #include "NetlistVisitor.h"
 #include "PathFinder.h"
@@ -22,6 +23,26 @@ Netlist createNetlist(Compilation& compilation) {
     return netlist;
 }
 
+/// Check that two netlists have the same nodes and edges, created in the same
+/// order. Node IDs are unique across all netlists, so they're compared relative
+/// to the ID of the first node.
+void checkSameNetlist(Netlist& expected, Netlist& actual) {
+    REQUIRE(actual.numNodes() == expected.numNodes());
+    CHECK(actual.numEdges() == expected.numEdges());
+    for (size_t i = 0; i < expected.numNodes(); i++) {
+        auto& expectedNode = expected.getNode(i);
+        auto& actualNode = actual.getNode(i);
+        CHECK(actualNode.kind == expectedNode.kind);
+        CHECK(&actualNode.symbol == &expectedNode.symbol);
+        CHECK(actualNode.ID - actual.getNode(0).ID == expectedNode.ID - expected.getNode(0).ID);
+        REQUIRE(actualNode.outDegree() == expectedNode.outDegree());
+        for (size_t j = 0; j < expectedNode.getEdges().size(); j++) {
+            CHECK(actual.findNode(actualNode.getEdges()[j]->getTargetNode()) ==
+                  expected.findNode(expectedNode.getEdges()[j]->getTargetNode()));
+        }
+    }
+}
+
 //===---------------------------------------------------------------------===//
 // Basic tests
 //===---------------------------------------------------------------------===//
@@ -45,6 +66,139 @@ endmodule
     CHECK(outPort != nullptr);
 }
 
+TEST_CASE("Declaration lookup") {
+    auto tree = SyntaxTree::fromText(R"(
+module inner (input logic i_value, output logic o_value);
+  logic tmp;
+  assign tmp = i_value;
+  assign o_value = tmp;
+endmodule
+
+module outer (input logic i_value, output logic o_value);
+  inner u0 (.i_value, .o_value);
+endmodule
+)");
+    Compilation compilation;
+    compilation.addSyntaxTree(tree);
+    NO_COMPILATION_ERRORS;
+    auto netlist = createNetlist(compilation);
+
+    auto* tmp = netlist.lookupVariable("outer.u0.tmp");
+    REQUIRE(tmp != nullptr);
+    CHECK(tmp->kind == NodeKind::VariableDeclaration);
+    CHECK(tmp->as<NetlistVariableDeclaration>().hierarchicalPath == "outer.u0.tmp");
+
+    // Lookups by the declared symbol and by path agree.
+    CHECK(netlist.lookupVariable(tmp->symbol) == tmp);
+
+    // Ports and variables are indexed separately.
+    auto* port = netlist.lookupPort("outer.u0.i_value");
+    REQUIRE(port != nullptr);
+    CHECK(port->kind == NodeKind::PortDeclaration);
+    CHECK(netlist.lookupVariable("outer.u0.i_value") != port);
+    CHECK(netlist.lookupPort("outer.u0.tmp") == nullptr);
+    CHECK(netlist.lookupVariable("outer.u1.tmp") == nullptr);
+}
+
+TEST_CASE("Parallel construction") {
+    // Test that building blocks concurrently gives the same netlist as building
+    // them one at a time.
+    auto tree = SyntaxTree::fromText(R"(
+module chain_array #(parameter N=4) (
+  input logic i_value,
+  output logic o_value);
+
+  logic pipeline [N-1:0];
+
+  assign pipeline[0] = i_value;
+
+  always_comb begin
+    for (int i=1; i<N; i++) begin
+      pipeline[i] = pipeline[i-1];
+    end
+  end
+
+  assign o_value = pipeline[N-1];
+
+endmodule
+
+module top (input logic i_value, input logic i_sel, output logic o_value);
+  logic a, b;
+  chain_array #(.N(3)) u0 (.i_value, .o_value(a));
+  chain_array #(.N(5)) u1 (.i_value, .o_value(b));
+  always_comb begin
+    if (i_sel)
+      o_value = a;
+    else
+      o_value = b;
+  end
+endmodule
+)");
+    CompilationOptions coptions;
+    coptions.disableInstanceCaching = true;
+    Bag options;
+    options.set(coptions);
+    Compilation compilation(options);
+    compilation.addSyntaxTree(tree);
+    NO_COMPILATION_ERRORS;
+
+    Netlist serial;
+    buildNetlist(compilation, serial, 1);
+    Netlist parallel;
+    buildNetlist(compilation, parallel, 4);
+
+    checkSameNetlist(serial, parallel);
+
+    // It matches the netlist built by visiting blocks as they're encountered.
+    auto visited = createNetlist(compilation);
+    SplitVariables splitVariables(parallel);
+    CHECK(parallel.numNodes() == visited.numNodes());
+    CHECK(parallel.numEdges() == visited.numEdges());
+
+    PathFinder pathFinder(parallel);
+    auto path = pathFinder.find(*parallel.lookupPort("top.i_value"),
+                                *parallel.lookupPort("top.o_value"));
+    CHECK(!path.empty());
+}
+
+TEST_CASE("Parallel construction with constant function calls") {
+    // Test that blocks whose loop bounds call a constant function can be built
+    // concurrently, sharing the compilation's cache of call results.
+    auto tree = SyntaxTree::fromText(R"(
+module top (input logic [7:0] i_value, output logic [7:0] o_value);
+  function automatic int width(int n);
+    return n / 2;
+  endfunction
+
+  logic [7:0] a, b, c;
+  always_comb for (int i = 0; i < width(16); i++) a[i] = i_value[i];
+  always_comb for (int i = 0; i < width(16); i++) b[i] = a[i];
+  always_comb for (int i = 0; i < width(16); i++) c[i] = b[i];
+  always_comb for (int i = 0; i < width(16); i++) o_value[i] = c[i];
+endmodule
+)");
+    CompilationOptions coptions;
+    coptions.disableInstanceCaching = true;
+    Bag options;
+    options.set(coptions);
+    Compilation compilation(options);
+    compilation.addSyntaxTree(tree);
+    NO_COMPILATION_ERRORS;
+
+    Netlist serial;
+    buildNetlist(compilation, serial, 1);
+    Netlist parallel;
+    buildNetlist(compilation, parallel, 4);
+    checkSameNetlist(serial, parallel);
+    CHECK(compilation.getFunctionCacheStats().hits > 0);
+
+    SplitVariables splitVariables(parallel);
+    PathFinder pathFinder(parallel);
+    auto path = pathFinder.find(*parallel.lookupPort("top.i_value"),
+                                *parallel.lookupPort("top.o_value"));
+    CHECK(!path.empty());
+}
+
 TEST_CASE("Pass through a module") {
     // Test the simplest path through a module.
     auto tree = SyntaxTree::fromText(R"(
@@ -281,6 +435,57 @@ endmodule
     CHECK(pathFinder.find(*inPortB, *outPortA).empty());
 }
 
+TEST_CASE("Passthrough signals via different kinds of selects of the same bits") {
+    // Test that variables are split by the bits that are selected, whichever
+    // selectors are used to select them.
+    auto tree = SyntaxTree::fromText(R"(
+module passthrough_bits (
+  input  logic [3:0] i_value_a,
+  input  logic [3:0] i_value_b,
+  output logic o_value_a,
+  output logic o_value_b,
+  output logic [1:0] o_value_c,
+  output logic o_value_d
+);
+
+  struct packed { logic [3:0] a; logic [3:0] b; } foo;
+  logic [7:0] bar [2];
+
+  assign foo.a = i_value_a;
+  assign foo.b = i_value_b;
+  assign o_value_a = foo[6];
+  assign o_value_b = foo[1];
+
+  assign bar[0][5:2] = i_value_a;
+  assign bar[1][7:4] = i_value_b;
+  assign o_value_c = bar[1][7:6];
+  assign o_value_d = bar[0][2];
+
+endmodule
+)");
+    Compilation compilation;
+    compilation.addSyntaxTree(tree);
+    NO_COMPILATION_ERRORS;
+    auto netlist = createNetlist(compilation);
+    auto* inPortA = netlist.lookupPort("passthrough_bits.i_value_a");
+    auto* inPortB = netlist.lookupPort("passthrough_bits.i_value_b");
+    auto* outPortA = netlist.lookupPort("passthrough_bits.o_value_a");
+    auto* outPortB = netlist.lookupPort("passthrough_bits.o_value_b");
+    auto* outPortC = netlist.lookupPort("passthrough_bits.o_value_c");
+    auto* outPortD = netlist.lookupPort("passthrough_bits.o_value_d");
+    PathFinder pathFinder(netlist);
+    // Valid paths.
+    CHECK(!pathFinder.find(*inPortA, *outPortA).empty());
+    CHECK(!pathFinder.find(*inPortB, *outPortB).empty());
+    CHECK(!pathFinder.find(*inPortB, *outPortC).empty());
+    CHECK(!pathFinder.find(*inPortA, *outPortD).empty());
+    // Invalid paths.
+    CHECK(pathFinder.find(*inPortA, *outPortB).empty());
+    CHECK(pathFinder.find(*inPortB, *outPortA).empty());
+    CHECK(pathFinder.find(*inPortA, *outPortC).empty());
+    CHECK(pathFinder.find(*inPortB, *outPortD).empty());
+}
+
 //===---------------------------------------------------------------------===//
 // Tests for loop unrolling
 //===---------------------------------------------------------------------===//
@@ -465,6 +670,72 @@ endmodule
     CHECK(!pathFinder.find(*netlist.lookupPort("mux.sel_b"), *netlist.lookupPort("mux.f")).empty());
 }
 
+//===---------------------------------------------------------------------===//
+// Tests for cone queries
+//===---------------------------------------------------------------------===//
+
+TEST_CASE("Fan-in and fan-out cones") {
+    // Test that cones stop at sequential elements and that cones of many points
+    // are found together.
+    auto tree = SyntaxTree::fromText(R"(
+module cones (
+  input logic clk,
+  input logic i_a,
+  input logic i_b,
+  output logic o_y,
+  output logic o_z);
+
+  logic r, s, t;
+
+  always_ff @(posedge clk)
+    r <= i_a & i_b;
+
+  assign t = r | i_b;
+
+  always @(posedge clk)
+    s <= t;
+
+  assign o_y = s;
+  assign o_z = t;
+
+endmodule
+)");
+    Compilation compilation;
+    compilation.addSyntaxTree(tree);
+    NO_COMPILATION_ERRORS;
+    auto netlist = createNetlist(compilation);
+    auto* inA = netlist.lookupPort("cones.i_a");
+    auto* inB = netlist.lookupPort("cones.i_b");
+    auto* outY = netlist.lookupPort("cones.o_y");
+    auto* varS = netlist.lookupVariable("cones.s");
+    ConeQuery query(netlist);
+
+    std::vector<NetlistNode*> fanOutPoints{inA, inB};
+    auto fanOut = query.find(fanOutPoints, ConeDirection::FanOut);
+    REQUIRE(fanOut.size() == 2);
+    CHECK(ConeQuery::getSignals(netlist, *inA, fanOut[0]) ==
+          std::vector<std::string>{"cones.r"});
+    CHECK(ConeQuery::getSignals(netlist, *inB, fanOut[1]) ==
+          std::vector<std::string>{"cones.o_z", "cones.r", "cones.s", "cones.t"});
+
+    std::vector<NetlistNode*> fanInPoints{outY, varS};
+    auto fanIn = query.find(fanInPoints, ConeDirection::FanIn);
+    REQUIRE(fanIn.size() == 2);
+    CHECK(ConeQuery::getSignals(netlist, *outY, fanIn[0]) ==
+          std::vector<std::string>{"cones.s"});
+    CHECK(ConeQuery::getSignals(netlist, *varS, fanIn[1]) ==
+          std::vector<std::string>{"cones.i_b", "cones.r", "cones.t"});
+
+    // More points than fit in a single batch.
+    std::vector<NetlistNode*> manyPoints(100, inB);
+    manyPoints[70] = inA;
+    auto manyCones = query.find(manyPoints, ConeDirection::FanOut);
+    REQUIRE(manyCones.size() == 100);
+    CHECK(manyCones[0] == fanOut[1]);
+    CHECK(manyCones[70] == fanOut[0]);
+    CHECK(manyCones[99] == fanOut[1]);
+}
+
 //===---------------------------------------------------------------------===//
 // Tests for name resolution
 //===---------------------------------------------------------------------===//
@@ -0,0 +1,37 @@
+//------------------------------------------------------------------------------
+//! @file TidyRunner.h
+//! @brief Runs a set of slang-tidy checks over a design
+//
+// SPDX-FileCopyrightText: Michael Popoloski
+// SPDX-License-Identifier: MIT
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "TidyFactory.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+/// The outcome of running a single check.
+struct TidyCheckResult {
+    /// The check that was run, which holds on to any diagnostics it issued.
+    std::unique_ptr<TidyCheck> check;
+
+    /// Whether the check passed.
+    bool passed = false;
+};
+
+/// Creates each of the named checks and runs them against the given design.
+///
+/// Checks only read the AST and each one collects diagnostics into its own buffer,
+/// so they can run concurrently. If @a numThreads is anything other than one the
+/// checks are spread across a thread pool with that many threads (zero means one
+/// per hardware thread). The AST must be fully elaborated beforehand; in particular
+/// instance caching must be disabled when compiling, since otherwise visiting the
+/// bodies of cached instances would elaborate them on the fly.
+///
+/// Results are returned sorted by check name regardless of how the checks were
+/// scheduled, so that output is deterministic.
+std::vector<TidyCheckResult> runTidyChecks(const slang::ast::RootSymbol& root,
+                                           std::vector<std::string> checkNames,
+                                           unsigned numThreads);
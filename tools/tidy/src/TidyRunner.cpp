@@ -0,0 +1,38 @@
+// SPDX-FileCopyrightText: Michael Popoloski
+// SPDX-License-Identifier: MIT
+
+#include "TidyRunner.h"
+
+#include <algorithm>
+
+#include "slang/util/ThreadPool.h"
+
+std::vector<TidyCheckResult> runTidyChecks(const slang::ast::RootSymbol& root,
+                                           std::vector<std::string> checkNames,
+                                           unsigned numThreads) {
+    std::ranges::sort(checkNames);
+
+    // The registry isn't safe to use concurrently, so create all of the checks up front.
+    std::vector<TidyCheckResult> results;
+    results.reserve(checkNames.size());
+    for (const auto& name : checkNames)
+        results.push_back({Registry::create(name)});
+
+    auto runOne = [&](size_t index) {
+        auto& result = results[index];
+        result.passed = result.check->check(root);
+    };
+
+    if (numThreads == 1 || results.size() <= 1) {
+        for (size_t i = 0; i < results.size(); i++)
+            runOne(i);
+        return results;
+    }
+
+    slang::ThreadPool threadPool(numThreads);
+    for (size_t i = 0; i < results.size(); i++)
+        threadPool.pushTask([&runOne, i] { runOne(i); });
+    threadPool.waitForAll();
+
+    return results;
+}
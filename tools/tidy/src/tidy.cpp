@@ -8,6 +8,7 @@
 
 #include "TidyConfigParser.h"
 #include "TidyFactory.h"
+#include "TidyRunner.h"
 #include "fmt/color.h"
 #include "fmt/format.h"
 #include <filesystem>
@@ -108,6 +109,10 @@ int main(int argc, char** argv) {
     if (!driver.processOptions())
         return 1;
 
+    // Checks can run in parallel, which requires every instance body to be
+    // fully elaborated up front instead of sharing the results of cached ones.
+    driver.options.disableInstanceCaching = true;
+
     std::unique_ptr<ast::Compilation> compilation;
     bool compilationOk;
     SLANG_TRY {
@@ -134,16 +139,16 @@ int main(int argc, char** argv) {
 
     int retCode = 0;
 
-    // Check all enabled checks
-    for (const auto& checkName : Registry::getEnabledChecks()) {
-        const auto check = Registry::create(checkName);
+    // Run all enabled checks, then report their results in a fixed order
+    auto results = runTidyChecks(compilation->getRoot(), Registry::getEnabledChecks(),
+                                 driver.options.numThreads.value_or(0));
+    for (const auto& [check, passed] : results) {
         OS::print(fmt::format("[{}]", check->name()));
 
         driver.diagEngine.setMessage(check->diagCode(), check->diagString());
         driver.diagEngine.setSeverity(check->diagCode(), check->diagSeverity());
 
-        auto checkOk = check->check(compilation->getRoot());
-        if (!checkOk) {
+        if (!passed) {
             retCode = 1;
             OS::print(fmt::emphasis::bold | fmt::fg(fmt::color::red), " FAIL\n");
             for (const auto& diag : check->getDiagnostics())
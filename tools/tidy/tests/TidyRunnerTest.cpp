@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: Michael Popoloski
+// SPDX-License-Identifier: MIT
+
+#include "Test.h"
+#include "TidyRunner.h"
+
+TEST_CASE("TidyRunner: parallel and serial runs produce the same results") {
+    auto tree = SyntaxTree::fromText(R"(
+module sub (
+    input logic clk_i,
+    input logic rst_ni,
+    input logic a,
+    output logic b
+);
+    always @(posedge clk_i) begin
+        b = a;
+    end
+    always_latch begin
+        if (a) b <= a;
+    end
+endmodule
+
+module top (
+    input logic clk_i,
+    input logic rst_ni,
+    input logic in,
+    output logic out
+);
+    logic [3:0] x;
+    for (genvar i = 0; i < 4; i++) begin : g
+        sub inst (.clk_i, .rst_ni, .a(in), .b(x[i]));
+    end
+    sub i_ok (.clk_i, .rst_ni, .a(in), .b(out));
+endmodule
+)");
+
+    CompilationOptions options;
+    options.disableInstanceCaching = true;
+
+    Bag bag;
+    bag.set(options);
+    Compilation compilation(bag);
+    compilation.addSyntaxTree(tree);
+    compilation.getAllDiagnostics();
+    auto& root = compilation.getRoot();
+
+    TidyConfig config;
+    Registry::setConfig(config);
+    Registry::setSourceManager(compilation.getSourceManager());
+
+    auto checks = Registry::getEnabledChecks();
+    REQUIRE(checks.size() > 1);
+
+    auto serial = runTidyChecks(root, checks, 1);
+    auto parallel = runTidyChecks(root, checks, 4);
+    REQUIRE(serial.size() == checks.size());
+    REQUIRE(parallel.size() == checks.size());
+
+    bool anyFailed = false;
+    for (size_t i = 0; i < serial.size(); i++) {
+        CHECK(serial[i].check->name() == parallel[i].check->name());
+        CHECK(serial[i].passed == parallel[i].passed);
+        anyFailed |= !serial[i].passed;
+
+        auto& serialDiags = serial[i].check->getDiagnostics();
+        auto& parallelDiags = parallel[i].check->getDiagnostics();
+        REQUIRE(serialDiags.size() == parallelDiags.size());
+        for (size_t j = 0; j < serialDiags.size(); j++) {
+            CHECK(serialDiags[j].code == parallelDiags[j].code);
+            CHECK(serialDiags[j].location == parallelDiags[j].location);
+        }
+    }
+    CHECK(anyFailed);
+}